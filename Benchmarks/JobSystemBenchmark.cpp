@@ -0,0 +1,133 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+// Scaling benchmark of JobSystem::parallelFor(). Work of every item is
+// similar to computation of one object's model matrix. Build together with
+// Src/Puffin/Common/JobSystem.cpp and Src/Puffin/Common/Logger.cpp.
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "Puffin/Common/JobSystem.h"
+
+using namespace puffin;
+
+namespace
+{
+    using Matrix = std::array<GLfloat, 16>;
+
+    constexpr GLint repeats_count = 200;
+
+    void multiply(const Matrix &a, const Matrix &b, Matrix &result)
+    {
+        for (GLint row = 0; row < 4; row++)
+        {
+            for (GLint column = 0; column < 4; column++)
+            {
+                GLfloat sum = 0.0f;
+                for (GLint i = 0; i < 4; i++)
+                    sum += a[row * 4 + i] * b[i * 4 + column];
+
+                result[row * 4 + column] = sum;
+            }
+        }
+    }
+
+    void transform(std::vector<Matrix> &matrices, GLuint begin, GLuint end)
+    {
+        Matrix rotation{};
+        Matrix scale{};
+        for (GLint i = 0; i < 4; i++)
+        {
+            rotation[i * 5] = 0.5f;
+            scale[i * 5] = 2.0f;
+        }
+
+        Matrix temp{};
+        for (GLuint i = begin; i < end; i++)
+        {
+            // Translation, rotation and scale like in model matrix
+            multiply(matrices[i], rotation, temp);
+            multiply(temp, scale, matrices[i]);
+        }
+    }
+
+    // Average time of one call in microseconds
+    GLdouble measure(JobSystem *job_system, GLuint count, GLuint batch_size)
+    {
+        std::vector<Matrix> matrices(count);
+        for (auto &matrix : matrices)
+        {
+            matrix.fill(0.0f);
+            for (GLint i = 0; i < 4; i++)
+                matrix[i * 5] = 1.0f;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (GLint i = 0; i < repeats_count; i++)
+        {
+            if (!job_system)
+            {
+                transform(matrices, 0, count);
+                continue;
+            }
+
+            job_system->parallelFor(count, [&](GLuint begin, GLuint end)
+            {
+                transform(matrices, begin, end);
+            }, batch_size);
+        }
+
+        auto time = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time).
+            count() / 1000.0 / repeats_count;
+    }
+} // namespace
+
+int main()
+{
+    const std::vector<GLuint> counts = {16, 64, 256, 1024, 4096, 16384,
+        65536};
+
+    GLint hardware_threads = std::max(static_cast<GLint>(
+        std::thread::hardware_concurrency()), 1);
+    std::vector<GLint> workers_counts = {1, 3, 7, hardware_threads - 1};
+    workers_counts.erase(std::remove_if(workers_counts.begin(),
+        workers_counts.end(), [](GLint workers_count)
+    {
+        return workers_count < 1;
+    }), workers_counts.end());
+    std::sort(workers_counts.begin(), workers_counts.end());
+    workers_counts.erase(std::unique(workers_counts.begin(),
+        workers_counts.end()), workers_counts.end());
+
+    std::printf("Hardware threads: %d\n", hardware_threads);
+    std::printf("Time of one parallelFor() in microseconds\n\n");
+    std::printf("%8s %10s", "items", "serial");
+    for (auto workers_count : workers_counts)
+        std::printf(" %6d+1 thr", workers_count);
+    std::printf(" %14s\n", "batch of 1");
+
+    std::vector<std::unique_ptr<JobSystem>> job_systems;
+    for (auto workers_count : workers_counts)
+        job_systems.emplace_back(new JobSystem(workers_count));
+
+    for (auto count : counts)
+    {
+        std::printf("%8u %10.2f", count, measure(nullptr, count, 0));
+        for (auto &job_system : job_systems)
+            std::printf(" %11.2f", measure(job_system.get(), count, 0));
+
+        // Cost of scheduling every item as separate job
+        std::printf(" %14.2f\n", measure(job_systems.empty() ? nullptr :
+            job_systems.back().get(), count, 1));
+    }
+
+    return 0;
+}
\ No newline at end of file
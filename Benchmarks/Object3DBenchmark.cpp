@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+// GPU time of drawing lit objects without shadows and postprocessing, so
+// main objects pass makes up the whole frame. Model given as first argument
+// is copied into grid. Only API shared by older builds is used, so the file
+// can be copied to earlier revision to compare shader changes. Build
+// together with engine sources, requires OpenGL 3.3 capable display.
+//------------------------------------------------------------------------------
+#include <cstdio>
+#include <vector>
+
+#include "Puffin/Common/GpuTimer.h"
+#include "Puffin/EngineCore.h"
+
+using namespace puffin;
+
+namespace
+{
+    constexpr GLint grid_size = 10;
+    constexpr GLint warmup_frames = 200;
+    constexpr GLint measured_frames = 1000;
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::printf("Usage: %s <model file>\n", argv[0]);
+        return 1;
+    }
+
+    try
+    {
+        EngineCore engine;
+        engine.initialize();
+        engine.displayConfiguration()->configure(1280, 720, 0, false);
+        engine.createDisplay("Object 3D benchmark");
+
+        auto master_renderer = engine.masterRenderer();
+        auto scene = engine.sceneManager()->createScene("benchmark_scene");
+
+        for (GLint x = 0; x < grid_size; x++)
+        {
+            for (GLint z = 0; z < grid_size; z++)
+            {
+                auto object = engine.meshManager()->loadObject3D(argv[1]);
+                object->setPosition(glm::vec3((x - grid_size / 2) * 4.0f,
+                    0.0f, (z - grid_size / 2) * 4.0f));
+                scene->addObject3D(object);
+            }
+        }
+
+        auto light_manager = master_renderer->masterManager()->lightManager();
+        light_manager->enableLighting(true);
+        light_manager->directionalLight()->enable(true);
+        light_manager->directionalLight()->setDirection(
+            glm::vec3(-1.0f, -1.0f, -1.0f));
+
+        master_renderer->shadowMap()->enableShadows(false);
+
+        auto camera = engine.mainCamera();
+        camera->setProjection(glm::radians(60.0f), 1280.0f / 720.0f, 0.1f,
+            200.0f);
+        camera->setPosition(glm::vec3(0.0f, 20.0f, 30.0f));
+        camera->setRotation(0.0f, glm::radians(-35.0f));
+        master_renderer->useCamera(camera);
+
+        GpuTimer frame_timer("benchmark_frame_timer");
+        GLint frame = 0;
+        GLdouble gpu_time = 0.0;
+        GLdouble frame_time = 0.0;
+
+        master_renderer->assignRenderingFunction([&]()
+        {
+            frame_timer.begin();
+            master_renderer->drawScene(scene);
+            frame_timer.end();
+
+            // Timer average is sampled only after it settled
+            frame++;
+            if (frame <= warmup_frames)
+                return;
+
+            gpu_time += frame_timer.getAverageElapsedTime();
+            frame_time += master_renderer->fpsCounter()->getDelta();
+
+            if (frame == warmup_frames + measured_frames)
+                master_renderer->stop();
+        });
+
+        engine.start();
+
+        std::printf("%d objects, %d measured frames\n\n",
+            grid_size * grid_size, measured_frames);
+        std::printf("%12s %12s\n", "GPU ms", "frame ms");
+        std::printf("%12.3f %12.3f\n", gpu_time / measured_frames,
+            frame_time * 1000.0 / measured_frames);
+    }
+    catch (const Exception &e)
+    {
+        std::printf("Benchmark failed: %s\n", e.getMessage().c_str());
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,180 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+// GPU time of point light shadow pass in every PointShadowRenderMode. Model
+// given as first argument is copied into grid of rotating casters, so
+// shadow maps are redrawn every frame. Build together with engine sources,
+// requires OpenGL 3.3 capable display.
+//------------------------------------------------------------------------------
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Puffin/EngineCore.h"
+
+using namespace puffin;
+
+namespace
+{
+    constexpr GLint grid_size = 5;
+    constexpr GLint point_lights_count = 4;
+    constexpr GLint warmup_frames = 200;
+    constexpr GLint measured_frames = 500;
+
+    struct ModeResult
+    {
+        PointShadowRenderMode mode;
+        PointShadowRenderMode active_mode;
+        GLdouble shadow_time;
+        GLdouble frame_time;
+    };
+
+    std::string getModeName(PointShadowRenderMode mode)
+    {
+        switch (mode)
+        {
+        case PointShadowRenderMode::GEOMETRY_SHADER:
+            return "geometry shader";
+        case PointShadowRenderMode::VERTEX_VIEWPORT:
+            return "vertex viewport";
+        case PointShadowRenderMode::SINGLE_FACE:
+            return "single face";
+        default:
+            return "automatic";
+        }
+    }
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::printf("Usage: %s <model file>\n", argv[0]);
+        return 1;
+    }
+
+    try
+    {
+        EngineCore engine;
+        engine.initialize();
+        engine.displayConfiguration()->configure(1280, 720, 0, false);
+        engine.createDisplay("Point shadow benchmark");
+
+        auto master_renderer = engine.masterRenderer();
+        auto scene = engine.sceneManager()->createScene("benchmark_scene");
+
+        std::vector<Object3DPtr> casters;
+        for (GLint x = 0; x < grid_size; x++)
+        {
+            for (GLint z = 0; z < grid_size; z++)
+            {
+                auto object = engine.meshManager()->loadObject3D(argv[1]);
+                object->setPosition(glm::vec3((x - grid_size / 2) * 4.0f,
+                    0.0f, (z - grid_size / 2) * 4.0f));
+                scene->addObject3D(object);
+                casters.push_back(object);
+            }
+        }
+
+        auto light_manager = master_renderer->masterManager()->lightManager();
+        light_manager->enableLighting(true);
+        for (GLint i = 0; i < point_lights_count; i++)
+        {
+            auto light = light_manager->createPointLight();
+            light->setPosition(glm::vec3((i % 2) * 8.0f - 4.0f, 3.0f,
+                (i / 2) * 8.0f - 4.0f));
+            light->enable(true);
+        }
+
+        master_renderer->shadowMap()->enableShadows(true);
+
+        auto camera = engine.mainCamera();
+        camera->setProjection(glm::radians(60.0f), 1280.0f / 720.0f, 0.1f,
+            100.0f);
+        camera->setPosition(glm::vec3(0.0f, 12.0f, 16.0f));
+        camera->setRotation(0.0f, glm::radians(-35.0f));
+        master_renderer->useCamera(camera);
+
+        // Moving casters invalidate cached shadow maps
+        master_renderer->assignSimulationFunction([&](GLdouble delta)
+        {
+            for (auto &object : casters)
+            {
+                object->rotate(static_cast<GLfloat>(delta),
+                    glm::vec3(0.0f, 1.0f, 0.0f));
+            }
+        });
+
+        const std::vector<PointShadowRenderMode> modes = {
+            PointShadowRenderMode::GEOMETRY_SHADER,
+            PointShadowRenderMode::VERTEX_VIEWPORT,
+            PointShadowRenderMode::SINGLE_FACE,
+            PointShadowRenderMode::AUTOMATIC};
+
+        std::vector<ModeResult> results;
+        GLuint mode_index = 0;
+        GLint frame = 0;
+        GLdouble shadow_time = 0.0;
+        GLdouble frame_time = 0.0;
+
+        master_renderer->shadowMap()->setPointShadowRenderMode(modes[0]);
+        master_renderer->assignRenderingFunction([&]()
+        {
+            master_renderer->drawScene(scene);
+
+            // Timer averages are sampled only after they settled
+            frame++;
+            if (frame > warmup_frames)
+            {
+                shadow_time += master_renderer->shadowMapRenderer()->
+                    getPointLightsRenderTime();
+                frame_time += master_renderer->fpsCounter()->getDelta();
+            }
+
+            if (frame < warmup_frames + measured_frames)
+                return;
+
+            auto mode = modes[mode_index];
+            results.push_back({mode, master_renderer->shadowMapRenderer()->
+                getActivePointShadowRenderMode(),
+                shadow_time / measured_frames,
+                frame_time * 1000.0 / measured_frames});
+
+            frame = 0;
+            shadow_time = 0.0;
+            frame_time = 0.0;
+
+            if (++mode_index == modes.size())
+            {
+                master_renderer->stop();
+                return;
+            }
+
+            master_renderer->shadowMap()->setPointShadowRenderMode(
+                modes[mode_index]);
+        });
+
+        engine.start();
+
+        std::printf("%d casters, %d point lights, %d measured frames\n\n",
+            grid_size * grid_size, point_lights_count, measured_frames);
+        std::printf("%-16s %-16s %12s %12s\n", "requested mode", "used mode",
+            "shadows ms", "frame ms");
+        for (const auto &result : results)
+        {
+            std::printf("%-16s %-16s %12.3f %12.3f\n",
+                getModeName(result.mode).c_str(),
+                getModeName(result.active_mode).c_str(), result.shadow_time,
+                result.frame_time);
+        }
+    }
+    catch (const Exception &e)
+    {
+        std::printf("Benchmark failed: %s\n", e.getMessage().c_str());
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
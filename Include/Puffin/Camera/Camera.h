@@ -126,9 +126,11 @@ namespace puffin
             setRotation(horizontal_angle_, -vertical_angle_);
         }
 
+        // New position is not blended with previous one
         void setPosition(const glm::vec3 &position)
         {
             position_ = position;
+            previous_position_ = position;
             calculateViewMatrix();
         }
 
@@ -137,6 +139,14 @@ namespace puffin
             return position_;
         }
 
+        // Position blended between two last simulation steps, used by view
+        // matrix
+        glm::vec3 getRenderPosition() const
+        {
+            return glm::mix(previous_position_, position_,
+                interpolation_alpha_);
+        }
+
         void translate(const glm::vec3 &translation)
         {
             position_ += translation;
@@ -226,10 +236,23 @@ namespace puffin
                 camera_box_->setCameraVectors(direction_, up_, right_);
         }
 
+        void storePreviousPosition()
+        {
+            previous_position_ = position_;
+        }
+
+        // View matrix uses position blended between two last simulation
+        // steps
+        void setInterpolationAlpha(GLfloat alpha)
+        {
+            interpolation_alpha_ = alpha;
+            calculateViewMatrix();
+        }
+
         void calculateViewMatrix()
         {
             view_matrix_ = rotation_matrix_ * glm::translate(glm::mat4(1.0f),
-                -position_);
+                -getRenderPosition());
             view_matrix_static_ = glm::mat4(glm::mat3(view_matrix_));
             view_matrix_inverted_ = glm::inverse(view_matrix_);
 
@@ -274,6 +297,8 @@ namespace puffin
         glm::mat4 projection_matrix_inverted_{1.0f};
 
         glm::vec3 position_{0.0f, 0.0f, 0.0f};
+        glm::vec3 previous_position_{0.0f, 0.0f, 0.0f};
+        GLfloat interpolation_alpha_{1.0f};
         glm::vec3 direction_{0.0f, 0.0f, -1.0f};
         glm::vec3 right_{1.0f, 0.0f, 0.0f};
         glm::vec3 up_{0.0f, 1.0f, 0.0f};
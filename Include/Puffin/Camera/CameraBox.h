@@ -56,6 +56,9 @@ namespace puffin
         void update(GLfloat box_size);
         void recalculateSpace(const glm::mat4 &space_matrix);
 
+        std::vector<glm::vec3> calculateSliceCorners(GLfloat distance_near,
+            GLfloat distance_far) const;
+
     protected:
         glm::vec3 calculatePointPosition(const glm::vec3 &start,
             const glm::vec3 &direction, GLfloat width) const;
@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#ifndef PUFFIN_FRUSTUM_H
+#define PUFFIN_FRUSTUM_H
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <string>
+
+namespace puffin
+{
+    class Frustum
+    {
+    public:
+        Frustum()
+        {
+        }
+
+        explicit Frustum(const glm::mat4 &projection_view_matrix)
+        {
+            setMatrix(projection_view_matrix);
+        }
+
+        void setMatrix(const glm::mat4 &projection_view_matrix)
+        {
+            // Planes are extracted from matrix rows, order: left, right,
+            // bottom, top, near, far
+            auto row = [&projection_view_matrix](GLint index)
+            {
+                return glm::vec4(projection_view_matrix[0][index],
+                    projection_view_matrix[1][index],
+                    projection_view_matrix[2][index],
+                    projection_view_matrix[3][index]);
+            };
+
+            planes_[0] = row(3) + row(0);
+            planes_[1] = row(3) - row(0);
+            planes_[2] = row(3) + row(1);
+            planes_[3] = row(3) - row(1);
+            planes_[4] = row(3) + row(2);
+            planes_[5] = row(3) - row(2);
+
+            for (auto &plane : planes_)
+                plane /= glm::length(glm::vec3(plane));
+        }
+
+        GLboolean containsSphere(const glm::vec3 &center, GLfloat radius) const
+        {
+            for (const auto &plane : planes_)
+            {
+                if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+                    return false;
+            }
+
+            return true;
+        }
+
+    protected:
+        std::string name_{"frustum"};
+
+        std::array<glm::vec4, 6> planes_;
+    };
+} // namespace puffin
+
+#endif // PUFFIN_FRUSTUM_H
\ No newline at end of file
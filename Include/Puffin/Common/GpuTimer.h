@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#ifndef PUFFIN_GPU_TIMER_H
+#define PUFFIN_GPU_TIMER_H
+
+#include <GL/glew.h>
+
+#include <array>
+#include <memory>
+#include <string>
+
+#include "Puffin/Common/Logger.h"
+
+namespace puffin
+{
+    // Measures GPU time of commands issued between begin() and end(). Results
+    // are read a few frames later, so measuring never stalls the pipeline.
+    // Timestamp queries are used, so timers can be nested.
+    class GpuTimer
+    {
+    public:
+        explicit GpuTimer(std::string name = "")
+        {
+            if (!name.empty())
+                name_ = name;
+
+            glGenQueries(queries_count_, start_queries_.data());
+            glGenQueries(queries_count_, end_queries_.data());
+
+            logDebug(name_, "GpuTimer::GpuTimer()", "GPU timer created.");
+        }
+
+        virtual ~GpuTimer()
+        {
+            glDeleteQueries(queries_count_, start_queries_.data());
+            glDeleteQueries(queries_count_, end_queries_.data());
+
+            logDebug(name_, "GpuTimer::~GpuTimer()", "GPU timer destroyed.");
+        }
+
+        std::string getName() const
+        {
+            return name_;
+        }
+
+        void begin()
+        {
+            if (measuring_)
+            {
+                logWarning(name_, "GpuTimer::begin()",
+                    "GPU timer is already measuring.");
+                return;
+            }
+
+            glQueryCounter(start_queries_[current_query_], GL_TIMESTAMP);
+            measuring_ = true;
+        }
+
+        void end()
+        {
+            if (!measuring_)
+            {
+                logWarning(name_, "GpuTimer::end()",
+                    "GPU timer is not measuring.");
+                return;
+            }
+
+            glQueryCounter(end_queries_[current_query_], GL_TIMESTAMP);
+            measuring_ = false;
+
+            pending_[current_query_] = true;
+            current_query_ = (current_query_ + 1) % queries_count_;
+
+            // Collect results starting from the oldest query
+            for (GLint i = 0; i < queries_count_ - 1; i++)
+                fetchResult((current_query_ + i) % queries_count_);
+        }
+
+        // Time in milliseconds
+        GLdouble getElapsedTime() const
+        {
+            return elapsed_time_;
+        }
+
+        GLdouble getAverageElapsedTime() const
+        {
+            return average_elapsed_time_;
+        }
+
+    protected:
+        void fetchResult(GLint index)
+        {
+            if (!pending_[index])
+                return;
+
+            GLint available = 0;
+            glGetQueryObjectiv(end_queries_[index], GL_QUERY_RESULT_AVAILABLE,
+                &available);
+            if (!available)
+                return;
+
+            GLuint64 start_ns = 0;
+            GLuint64 end_ns = 0;
+            glGetQueryObjectui64v(start_queries_[index], GL_QUERY_RESULT,
+                &start_ns);
+            glGetQueryObjectui64v(end_queries_[index], GL_QUERY_RESULT,
+                &end_ns);
+            pending_[index] = false;
+
+            elapsed_time_ = static_cast<GLdouble>(end_ns - start_ns) /
+                1000000.0;
+            average_elapsed_time_ = average_elapsed_time_ * 0.9 +
+                elapsed_time_ * 0.1;
+        }
+
+        std::string name_{"unnamed_gpu_timer"};
+
+        static constexpr GLint queries_count_{4};
+
+        std::array<GLuint, queries_count_> start_queries_{};
+        std::array<GLuint, queries_count_> end_queries_{};
+        std::array<GLboolean, queries_count_> pending_{};
+        GLint current_query_{0};
+        GLboolean measuring_{false};
+
+        GLdouble elapsed_time_{0.0};
+        GLdouble average_elapsed_time_{0.0};
+    };
+
+    using GpuTimerPtr = std::shared_ptr<GpuTimer>;
+} // namespace puffin
+
+#endif // PUFFIN_GPU_TIMER_H
\ No newline at end of file
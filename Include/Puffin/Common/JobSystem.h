@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#ifndef PUFFIN_JOB_SYSTEM_H
+#define PUFFIN_JOB_SYSTEM_H
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Puffin/Common/Logger.h"
+
+namespace puffin
+{
+    using JobFunction = std::function<void(void)>;
+    using JobRangeFunction = std::function<void(GLuint, GLuint)>;
+
+    class Job
+    {
+        friend class JobSystem;
+
+    public:
+        GLboolean isFinished() const
+        {
+            return finished_;
+        }
+
+    protected:
+        JobFunction function_{nullptr};
+        GLboolean main_thread_{false};
+
+        // Job is queued when its last dependency finishes
+        std::atomic<GLint> unfinished_dependencies_{0};
+        std::atomic<bool> finished_{false};
+
+        // Set when function throws, rethrown by JobSystem::wait()
+        std::exception_ptr exception_{nullptr};
+
+        std::mutex dependents_mutex_;
+        std::vector<std::shared_ptr<Job>> dependents_;
+    };
+
+    using JobPtr = std::shared_ptr<Job>;
+
+    // Workers own queues of jobs. They take newest jobs from their own queue
+    // and steal oldest ones from queues of other workers, when they run out
+    // of work.
+    class JobSystem
+    {
+    public:
+        // Count of zero uses one worker per hardware thread, except thread
+        // which creates job system
+        explicit JobSystem(GLint workers_count = 0);
+        virtual ~JobSystem();
+
+        std::string getName() const
+        {
+            return name_;
+        }
+
+        GLint getWorkersCount() const
+        {
+            return static_cast<GLint>(workers_.size());
+        }
+
+        JobPtr schedule(JobFunction function,
+            const std::vector<JobPtr> &dependencies = {});
+        // Job is executed only by thread which created job system, inside of
+        // runMainThreadJobs() or wait()
+        JobPtr scheduleOnMainThread(JobFunction function,
+            const std::vector<JobPtr> &dependencies = {});
+
+        // Waiting thread executes other jobs in the meantime. Exception
+        // thrown by job is rethrown here, after all waited jobs finish.
+        void wait(JobPtr job);
+        void wait(const std::vector<JobPtr> &jobs);
+
+        // Range is split into batches executed in parallel. Batch size of
+        // zero is chosen from workers count, but is not smaller than
+        // min_batch_size_, so small ranges are processed by calling thread
+        // only. Returns after whole range is processed.
+        void parallelFor(GLuint count, JobRangeFunction function,
+            GLuint batch_size = 0);
+
+        void runMainThreadJobs();
+
+    protected:
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<JobPtr> jobs;
+        };
+
+        JobPtr createJob(JobFunction function, GLboolean main_thread,
+            const std::vector<JobPtr> &dependencies);
+        void enqueue(JobPtr job);
+        void execute(JobPtr job);
+
+        JobPtr popJob(GLint worker_index);
+        JobPtr stealJob(GLint worker_index);
+        JobPtr popMainThreadJob();
+        GLboolean executeNextJob();
+
+        void workerThread(GLint worker_index);
+
+        std::string name_{"core_job_system"};
+
+        // Scheduling a job costs more than a few cheap iterations
+        static constexpr GLuint min_batch_size_{64};
+
+        std::thread::id main_thread_id_;
+        std::vector<std::thread> workers_;
+        std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+        std::atomic<GLuint> next_queue_{0};
+
+        std::mutex main_thread_mutex_;
+        std::deque<JobPtr> main_thread_jobs_;
+
+        // Idle workers sleep until any job is queued
+        std::mutex sleep_mutex_;
+        std::condition_variable sleep_condition_;
+        std::atomic<GLint> queued_jobs_{0};
+        GLboolean running_{true};
+    };
+
+    using JobSystemPtr = std::shared_ptr<JobSystem>;
+} // namespace puffin
+
+#endif // PUFFIN_JOB_SYSTEM_H
\ No newline at end of file
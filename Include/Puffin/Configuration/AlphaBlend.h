@@ -22,6 +22,8 @@ namespace puffin
 
     class AlphaBlend
     {
+        friend class StateMachine;
+
     public:
         AlphaBlend()
         {
@@ -56,7 +58,10 @@ namespace puffin
         void enable(GLboolean state)
         {
             if (state == enabled_)
+            {
+                redundant_calls_++;
                 return;
+            }
 
             if (state)
                 glEnable(GL_BLEND);
@@ -74,7 +79,10 @@ namespace puffin
         void setBlendFunction(BlendFunction function)
         {
             if (function == blend_function_)
+            {
+                redundant_calls_++;
                 return;
+            }
 
             switch (function)
             {
@@ -92,6 +100,8 @@ namespace puffin
     protected:
         std::string name_{"core_alpha_blend"};
 
+        GLuint redundant_calls_{0};
+
         GLboolean enabled_{false};
         BlendFunction blend_function_{BlendFunction::NORMAL};
     };
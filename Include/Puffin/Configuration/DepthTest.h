@@ -16,6 +16,8 @@ namespace puffin
 {
     class DepthTest
     {
+        friend class StateMachine;
+
     public:
         DepthTest()
         {
@@ -38,7 +40,10 @@ namespace puffin
         void enable(GLboolean state)
         {
             if (state == enabled_)
+            {
+                redundant_calls_++;
                 return;
+            }
 
             if (state)
                 glEnable(GL_DEPTH_TEST);
@@ -56,7 +61,10 @@ namespace puffin
         void enableDepthMask(GLboolean state)
         {
             if (state == depth_mask_enabled_)
+            {
+                redundant_calls_++;
                 return;
+            }
 
             glDepthMask(state ? GL_TRUE : GL_FALSE);
             depth_mask_enabled_ = state;
@@ -70,6 +78,8 @@ namespace puffin
     protected:
         std::string name_{"core_depth_test"};
 
+        GLuint redundant_calls_{0};
+
         GLboolean enabled_{false};
         GLboolean depth_mask_enabled_{false};
     };
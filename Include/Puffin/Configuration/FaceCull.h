@@ -23,6 +23,8 @@ namespace puffin
 
     class FaceCull
     {
+        friend class StateMachine;
+
     public:
         FaceCull()
         {
@@ -59,7 +61,10 @@ namespace puffin
         void enable(GLboolean state)
         {
             if (state == enabled_)
+            {
+                redundant_calls_++;
                 return;
+            }
 
             if (state)
                 glEnable(GL_CULL_FACE);
@@ -77,7 +82,10 @@ namespace puffin
         void setCulledSide(CulledSide culled_side)
         {
             if (culled_side == culled_side_)
+            {
+                redundant_calls_++;
                 return;
+            }
 
             switch (culled_side)
             {
@@ -98,6 +106,8 @@ namespace puffin
     protected:
         std::string name_{"core_face_cull"};
 
+        GLuint redundant_calls_{0};
+
         GLboolean enabled_{false};
         CulledSide culled_side_{CulledSide::BACK};
     };
@@ -8,13 +8,23 @@
 
 #include <GL/glew.h>
 
+#include <array>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Puffin/Common/Logger.h"
 
 namespace puffin
 {
+    enum class PointShadowRenderMode
+    {
+        AUTOMATIC,
+        GEOMETRY_SHADER,
+        VERTEX_VIEWPORT,
+        SINGLE_FACE,
+    };
+
     class ShadowMapConfiguration
     {
     public:
@@ -55,6 +65,8 @@ namespace puffin
             return shadow_map_size_dir_light_;
         }
 
+        // Maximal size of point light's cube face tile. Actual size depends
+        // on light's screen coverage.
         void setShadowMapSizePointLight(GLint size)
         {
             if (size <= 0)
@@ -70,6 +82,38 @@ namespace puffin
             return shadow_map_size_point_light_;
         }
 
+        void setShadowMapMinSizePointLight(GLint size)
+        {
+            if (size <= 0)
+                logErrorAndThrow(name_,
+                    "ShadowMapConfiguration::setShadowMapMinSizePointLight()",
+                    "Shadow map size value out of range: {0 < VALUE}.");
+
+            shadow_map_min_size_point_light_ = size;
+        }
+
+        GLint getShadowMapMinSizePointLight() const
+        {
+            return shadow_map_min_size_point_light_;
+        }
+
+        // All point lights share one atlas, every light uses six tiles. Size
+        // has to be set before first render.
+        void setPointLightsAtlasSize(GLint size)
+        {
+            if (size <= 0)
+                logErrorAndThrow(name_,
+                    "ShadowMapConfiguration::setPointLightsAtlasSize()",
+                    "Atlas size value out of range: {0 < VALUE}.");
+
+            point_lights_atlas_size_ = size;
+        }
+
+        GLint getPointLightsAtlasSize() const
+        {
+            return point_lights_atlas_size_;
+        }
+
         void setShadowDistance(GLfloat distance)
         {
             if (distance <= 0.0f)
@@ -116,16 +160,163 @@ namespace puffin
             return pcf_samples_count_;
         }
 
+        void setCascadesCount(GLint count)
+        {
+            if (count < 1 || count > max_cascades_count_)
+                logErrorAndThrow(name_,
+                    "ShadowMapConfiguration::setCascadesCount()",
+                    "Cascades count value out of range: "
+                    "{1 <= VALUE <= 4}.");
+
+            cascades_count_ = count;
+            cascade_splits_.clear();
+        }
+
+        GLint getCascadesCount() const
+        {
+            return cascades_count_;
+        }
+
+        GLint getMaxCascadesCount() const
+        {
+            return max_cascades_count_;
+        }
+
+        // Blend factor between uniform (0.0) and logarithmic (1.0) split
+        // scheme. Used when cascade splits are not set manually.
+        void setCascadeSplitLambda(GLfloat lambda)
+        {
+            if (lambda < 0.0f || lambda > 1.0f)
+                logErrorAndThrow(name_,
+                    "ShadowMapConfiguration::setCascadeSplitLambda()",
+                    "Cascade split lambda value out of range: "
+                    "{0.0 <= VALUE <= 1.0}.");
+
+            cascade_split_lambda_ = lambda;
+        }
+
+        GLfloat getCascadeSplitLambda() const
+        {
+            return cascade_split_lambda_;
+        }
+
+        // Far distances of cascades as fractions of shadow distance. Empty
+        // container restores automatic splitting.
+        void setCascadeSplits(const std::vector<GLfloat> &splits)
+        {
+            if (!splits.empty() && static_cast<GLint>(splits.size()) !=
+                cascades_count_)
+                logErrorAndThrow(name_,
+                    "ShadowMapConfiguration::setCascadeSplits()",
+                    "Cascade splits count does not match cascades count.");
+
+            GLfloat previous = 0.0f;
+            for (const auto &split : splits)
+            {
+                if (split <= previous || split > 1.0f)
+                    logErrorAndThrow(name_,
+                        "ShadowMapConfiguration::setCascadeSplits()",
+                        "Cascade split value out of range: "
+                        "{PREVIOUS < VALUE <= 1.0}.");
+
+                previous = split;
+            }
+
+            cascade_splits_ = splits;
+        }
+
+        std::vector<GLfloat> getCascadeSplits() const
+        {
+            return cascade_splits_;
+        }
+
+        // Size of zero means that cascade uses directional light's shadow
+        // map size
+        void setCascadeMapSize(GLint cascade_index, GLint size)
+        {
+            if (cascade_index < 0 || cascade_index >= max_cascades_count_)
+                logErrorAndThrow(name_,
+                    "ShadowMapConfiguration::setCascadeMapSize()",
+                    "Cascade index value out of range: {0 <= VALUE < 4}.");
+
+            if (size < 0)
+                logErrorAndThrow(name_,
+                    "ShadowMapConfiguration::setCascadeMapSize()",
+                    "Shadow map size value out of range: {0 <= VALUE}.");
+
+            cascade_map_sizes_[cascade_index] = size;
+        }
+
+        GLint getCascadeMapSize(GLint cascade_index) const
+        {
+            if (cascade_index < 0 || cascade_index >= max_cascades_count_)
+                logErrorAndThrow(name_,
+                    "ShadowMapConfiguration::getCascadeMapSize()",
+                    "Cascade index value out of range: {0 <= VALUE < 4}.");
+
+            if (cascade_map_sizes_[cascade_index] == 0)
+                return shadow_map_size_dir_light_;
+
+            return cascade_map_sizes_[cascade_index];
+        }
+
+        // Cascade covers region bigger than its frustum slice by this
+        // factor. Region and static casters drawn into it are kept until
+        // slice leaves it, so bigger margin means less redraws, but lower
+        // shadow resolution.
+        void setCascadeCacheMargin(GLfloat margin)
+        {
+            if (margin < 1.0f)
+                logErrorAndThrow(name_,
+                    "ShadowMapConfiguration::setCascadeCacheMargin()",
+                    "Cascade cache margin value out of range: "
+                    "{1.0 <= VALUE}.");
+
+            cascade_cache_margin_ = margin;
+        }
+
+        GLfloat getCascadeCacheMargin() const
+        {
+            return cascade_cache_margin_;
+        }
+
+        // Automatic mode selects viewports from vertex shader when it is
+        // supported and falls back to rendering each face separately. Choice
+        // depends on extensions only, modes are not timed. They can be
+        // compared with Benchmarks/PointShadowBenchmark.cpp.
+        void setPointShadowRenderMode(PointShadowRenderMode mode)
+        {
+            point_shadow_render_mode_ = mode;
+        }
+
+        PointShadowRenderMode getPointShadowRenderMode() const
+        {
+            return point_shadow_render_mode_;
+        }
+
     protected:
         std::string name_{"core_shadow_map_configuration"};
 
+        static constexpr GLint max_cascades_count_{4};
+
         GLboolean shadows_enabled_{false};
         GLint shadow_map_size_dir_light_{1024};
         GLint shadow_map_size_point_light_{1024};
+        GLint shadow_map_min_size_point_light_{64};
+        GLint point_lights_atlas_size_{4096};
         GLfloat shadow_distance_{10.0f};
         GLfloat shadow_transition_distance_{5.0f};
 
         GLint pcf_samples_count_{1};
+
+        GLint cascades_count_{3};
+        GLfloat cascade_split_lambda_{0.75f};
+        std::vector<GLfloat> cascade_splits_;
+        std::array<GLint, max_cascades_count_> cascade_map_sizes_{};
+        GLfloat cascade_cache_margin_{1.25f};
+
+        PointShadowRenderMode point_shadow_render_mode_{
+            PointShadowRenderMode::AUTOMATIC};
     };
 
     using ShadowMapConfigurationPtr = std::shared_ptr<ShadowMapConfiguration>;
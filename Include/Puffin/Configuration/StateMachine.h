@@ -8,8 +8,12 @@
 
 #include <GL/glew.h>
 
+#include <glm/glm.hpp>
+
+#include <array>
 #include <map>
 #include <memory>
+#include <vector>
 
 #include "Puffin/Common/Logger.h"
 #include "Puffin/Configuration/AlphaBlend.h"
@@ -17,6 +21,7 @@
 #include "Puffin/Configuration/FaceCull.h"
 #include "Puffin/Mesh/BaseMesh.h"
 #include "Puffin/Renderer/FrameBuffer.h"
+#include "Puffin/Renderer/StencilBuffer.h"
 #include "Puffin/Shader/ShaderProgram.h"
 #include "Puffin/Texture/Texture.h"
 
@@ -30,14 +35,19 @@ namespace puffin
     };
 
 
+    // Keeps OpenGL state set by engine, so calls which would not change it
+    // are skipped
     class StateMachine
     {
+        friend class MasterRenderer;
+
     public:
         StateMachine()
         {
             alpha_blend_.reset(new AlphaBlend());
             depth_test_.reset(new DepthTest());
             face_cull_.reset(new FaceCull());
+            stencil_buffer_.reset(new StencilBuffer());
 
             logDebug(name_, "StateMachine::StateMachine()",
                 "State machine created.");
@@ -69,6 +79,17 @@ namespace puffin
             return face_cull_;
         }
 
+        StencilBufferPtr stencilBuffer() const
+        {
+            return stencil_buffer_;
+        }
+
+        // Count of calls skipped by state cache during last frame
+        GLuint getRedundantCallsCount() const
+        {
+            return last_frame_redundant_calls_;
+        }
+
         void activateShaderProgram(ShaderProgramPtr shader_program)
         {
             if (!shader_program)
@@ -77,63 +98,102 @@ namespace puffin
 
             if (active_shader_program_ && shader_program->handle_ ==
                 active_shader_program_->handle_)
+            {
+                redundant_calls_++;
                 return;
+            }
 
             glUseProgram(shader_program->handle_);
             active_shader_program_ = shader_program;
         }
 
+        // Textures are bound to active unit
+        void setActiveTextureUnit(GLint unit)
+        {
+            if (unit < 0)
+                logErrorAndThrow(name_, "StateMachine::setActiveTextureUnit()",
+                    "Texture unit value out of range: {0 <= VALUE}.");
+
+            if (unit == active_texture_unit_)
+            {
+                redundant_calls_++;
+                return;
+            }
+
+            glActiveTexture(GL_TEXTURE0 + unit);
+            active_texture_unit_ = unit;
+        }
+
+        GLint getActiveTextureUnit() const
+        {
+            return active_texture_unit_;
+        }
+
         void bindTexture(TexturePtr texture)
         {
             if (!texture)
                 logErrorAndThrow(name_, "StateMachine::bindTexture()",
                     "Object [Texture] pointer not set.");
 
-            if (bound_texture_ && texture->handle_ == bound_texture_->handle_)
+            GLenum target = getTextureTarget(texture->getType());
+            if (target == 0)
                 return;
 
-            switch (texture->getType())
+            auto &bound_texture = getBoundTexture(active_texture_unit_,
+                texture->getType());
+            if (bound_texture && texture->handle_ == bound_texture->handle_)
             {
-            case TextureType::TEXTURE_CUBE:
-                glBindTexture(GL_TEXTURE_CUBE_MAP, texture->handle_);
-                break;
-            case TextureType::TEXTURE_2D:
-                glBindTexture(GL_TEXTURE_2D, texture->handle_);
-                break;
-            case TextureType::TEXTURE_2D_MULTISAMPLED:
-                glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, texture->handle_);
+                redundant_calls_++;
+                return;
             }
 
-            bound_texture_ = texture;
+            glBindTexture(target, texture->handle_);
+            bound_texture = texture;
         }
 
         void unbindTexture(TextureType texture_type)
         {
-            if (bound_texture_ == nullptr)
+            GLenum target = getTextureTarget(texture_type);
+            if (target == 0)
                 return;
 
-            switch (texture_type)
+            auto &bound_texture = getBoundTexture(active_texture_unit_,
+                texture_type);
+            if (!bound_texture)
             {
-            case TextureType::TEXTURE_CUBE:
-                glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-                break;
-            case TextureType::TEXTURE_2D:
-                glBindTexture(GL_TEXTURE_2D, 0);
-                break;
-            case TextureType::TEXTURE_2D_MULTISAMPLED:
-                glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+                redundant_calls_++;
+                return;
             }
 
-            bound_texture_ = nullptr;
+            glBindTexture(target, 0);
+            bound_texture = nullptr;
         }
 
+        // Only units and targets with bound textures are cleared, active unit
+        // is restored afterwards
         void unbindAllTextures()
         {
-            glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-            glBindTexture(GL_TEXTURE_2D, 0);
-            glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
+            GLint active_unit = active_texture_unit_;
+
+            for (GLuint unit = 0; unit < bound_textures_.size(); unit++)
+            {
+                for (GLuint type = 0; type < texture_types_count_; type++)
+                {
+                    auto &bound_texture = bound_textures_[unit][type];
+                    if (!bound_texture)
+                        continue;
+
+                    if (active_texture_unit_ != static_cast<GLint>(unit))
+                        setActiveTextureUnit(unit);
+
+                    glBindTexture(getTextureTarget(bound_texture->getType()),
+                        0);
+                    bound_texture = nullptr;
+                }
+            }
 
-            bound_texture_ = nullptr;
+            if (active_texture_unit_ != active_unit)
+                setActiveTextureUnit(active_unit);
         }
 
         void bindMesh(BaseMeshPtr mesh)
@@ -143,7 +203,10 @@ namespace puffin
                     "Object [BaseMesh] pointer not set.");
 
             if (bound_mesh_ && mesh->handle_ == bound_mesh_->handle_)
+            {
+                redundant_calls_++;
                 return;
+            }
 
             glBindVertexArray(mesh->handle_);
             bound_mesh_ = mesh;
@@ -152,7 +215,10 @@ namespace puffin
         void unbindMesh()
         {
             if (!bound_mesh_)
+            {
+                redundant_calls_++;
                 return;
+            }
 
             glBindVertexArray(0);
             bound_mesh_ = nullptr;
@@ -170,34 +236,52 @@ namespace puffin
             case FrameBufferBindType::NORMAL:
                 if (bound_frame_buffer_ && frame_buffer->handle_ ==
                     bound_frame_buffer_->handle_)
+                {
+                    redundant_calls_++;
                     return;
+                }
 
                 glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer->handle_);
                 bound_frame_buffer_ = frame_buffer;
+                bound_only_read_ = frame_buffer;
+                bound_only_write_ = frame_buffer;
                 break;
             case FrameBufferBindType::ONLY_READ:
                 if (bound_only_read_ && frame_buffer->handle_ ==
                     bound_only_read_->handle_)
+                {
+                    redundant_calls_++;
                     return;
+                }
 
                 glBindFramebuffer(GL_READ_FRAMEBUFFER, frame_buffer->handle_);
                 bound_only_read_ = frame_buffer;
+                if (bound_frame_buffer_ != frame_buffer)
+                    bound_frame_buffer_ = nullptr;
                 break;
             case FrameBufferBindType::ONLY_WRITE:
                 if (bound_only_write_ && frame_buffer->handle_ ==
                     bound_only_write_->handle_)
+                {
+                    redundant_calls_++;
                     return;
+                }
 
                 glBindFramebuffer(GL_DRAW_FRAMEBUFFER, frame_buffer->handle_);
                 bound_only_write_ = frame_buffer;
+                if (bound_frame_buffer_ != frame_buffer)
+                    bound_frame_buffer_ = nullptr;
                 break;
             }
         }
 
         void unbindFrameBuffer()
         {
-            if (!bound_frame_buffer_)
+            if (!bound_frame_buffer_ && !bound_only_read_ && !bound_only_write_)
+            {
+                redundant_calls_++;
                 return;
+            }
 
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
             bound_frame_buffer_ = nullptr;
@@ -205,13 +289,98 @@ namespace puffin
             bound_only_write_ = nullptr;
         }
 
+        void setViewport(GLint x, GLint y, GLint width, GLint height)
+        {
+            glm::ivec4 viewport(x, y, width, height);
+            if (viewport == viewport_)
+            {
+                redundant_calls_++;
+                return;
+            }
+
+            glViewport(x, y, width, height);
+            viewport_ = viewport;
+        }
+
+        // Has to be called after viewport is changed without state machine,
+        // e.g. by indexed viewports
+        void invalidateViewport()
+        {
+            viewport_ = glm::ivec4(-1);
+        }
+
+        // OpenGL is queried only when viewport is not known
+        glm::ivec4 getViewport()
+        {
+            if (viewport_.z < 0)
+            {
+                GLint viewport[4];
+                glGetIntegerv(GL_VIEWPORT, viewport);
+                viewport_ = glm::ivec4(viewport[0], viewport[1], viewport[2],
+                    viewport[3]);
+            }
+
+            return viewport_;
+        }
+
     protected:
+        static constexpr GLuint texture_types_count_{6};
+
+        static GLenum getTextureTarget(TextureType texture_type)
+        {
+            switch (texture_type)
+            {
+            case TextureType::TEXTURE_CUBE:
+                return GL_TEXTURE_CUBE_MAP;
+            case TextureType::TEXTURE_2D:
+                return GL_TEXTURE_2D;
+            case TextureType::TEXTURE_2D_MULTISAMPLED:
+                return GL_TEXTURE_2D_MULTISAMPLE;
+            case TextureType::TEXTURE_2D_ARRAY:
+                return GL_TEXTURE_2D_ARRAY;
+            case TextureType::TEXTURE_BUFFER:
+                return GL_TEXTURE_BUFFER;
+            default:
+                return 0;
+            }
+        }
+
+        TexturePtr& getBoundTexture(GLint unit, TextureType texture_type)
+        {
+            if (static_cast<GLuint>(unit) >= bound_textures_.size())
+                bound_textures_.resize(unit + 1);
+
+            return bound_textures_[unit][static_cast<GLuint>(texture_type)];
+        }
+
+        // Called once per frame by master renderer
+        void endFrame()
+        {
+            last_frame_redundant_calls_ = redundant_calls_ +
+                alpha_blend_->redundant_calls_ +
+                depth_test_->redundant_calls_ +
+                face_cull_->redundant_calls_ +
+                stencil_buffer_->redundant_calls_;
+
+            redundant_calls_ = 0;
+            alpha_blend_->redundant_calls_ = 0;
+            depth_test_->redundant_calls_ = 0;
+            face_cull_->redundant_calls_ = 0;
+            stencil_buffer_->redundant_calls_ = 0;
+        }
+
         std::string name_{"core_state_machine"};
 
         BaseMeshPtr bound_mesh_{nullptr};
-        TexturePtr bound_texture_{nullptr};
         ShaderProgramPtr active_shader_program_{nullptr};
 
+        // Bound textures of every unit, indexed by texture type
+        GLint active_texture_unit_{0};
+        std::vector<std::array<TexturePtr, texture_types_count_>>
+            bound_textures_;
+
+        glm::ivec4 viewport_{-1};
+
         FrameBufferPtr bound_frame_buffer_{nullptr};
         FrameBufferPtr bound_only_read_{nullptr};
         FrameBufferPtr bound_only_write_{nullptr};
@@ -219,6 +388,10 @@ namespace puffin
         AlphaBlendPtr alpha_blend_{nullptr};
         DepthTestPtr depth_test_{nullptr};
         FaceCullPtr face_cull_{nullptr};
+        StencilBufferPtr stencil_buffer_{nullptr};
+
+        GLuint redundant_calls_{0};
+        GLuint last_frame_redundant_calls_{0};
     };
 
     using StateMachinePtr = std::shared_ptr<StateMachine>;
@@ -0,0 +1,18 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#ifndef PUFFIN_ANTIALIASING_MODE_H
+#define PUFFIN_ANTIALIASING_MODE_H
+
+namespace puffin
+{
+    enum class AntialiasingMode
+    {
+        MSAA,
+        FXAA,
+    };
+} // namespace puffin
+
+#endif // PUFFIN_ANTIALIASING_MODE_H
\ No newline at end of file
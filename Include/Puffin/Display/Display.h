@@ -100,6 +100,17 @@ namespace puffin
             glfwSwapBuffers(handle_);
         }
 
+        // OpenGL context can be current in one thread at a time
+        void makeContextCurrent() const
+        {
+            glfwMakeContextCurrent(handle_);
+        }
+
+        void releaseContext() const
+        {
+            glfwMakeContextCurrent(nullptr);
+        }
+
         std::string name_{"core_display"};
         std::string caption_{"Puffin Engine Window"};
 
@@ -10,6 +10,7 @@
 
 #include "Puffin/Common/Logger.h"
 #include "Puffin/Common/System.h"
+#include "Puffin/Display/AntialiasingMode.h"
 
 namespace puffin
 {
@@ -49,6 +50,20 @@ namespace puffin
             return fullscreen_;
         }
 
+        // FXAA renders scene to single sampled frame buffer and smooths
+        // edges in postprocess pass. MSAA samples count is ignored then.
+        void setAntialiasingMode(AntialiasingMode mode);
+
+        AntialiasingMode getAntialiasingMode() const
+        {
+            return antialiasing_mode_;
+        }
+
+        GLboolean isMultisamplingEnabled() const
+        {
+            return antialiasing_mode_ == AntialiasingMode::MSAA;
+        }
+
     protected:
         GLboolean checkIntValue(GLint value,
             std::vector<GLint> allowed_values) const;
@@ -62,6 +77,7 @@ namespace puffin
         GLint height_{240};
         GLint msaa_samples_{4};
         GLboolean fullscreen_{false};
+        AntialiasingMode antialiasing_mode_{AntialiasingMode::MSAA};
 
         SystemPtr system_{nullptr};
     };
@@ -6,6 +6,7 @@
 #ifndef PUFFIN_ENGINE_CORE_H
 #define PUFFIN_ENGINE_CORE_H
 
+#include "Puffin/Common/JobSystem.h"
 #include "Puffin/Common/RandomRealGenerator.h"
 #include "Puffin/Common/System.h"
 #include "Puffin/Common/Timer.h"
@@ -47,6 +48,11 @@ namespace puffin
             return input_;
         }
 
+        JobSystemPtr jobSystem() const
+        {
+            return job_system_;
+        }
+
         MasterRendererPtr masterRenderer() const
         {
             return master_renderer_;
@@ -77,6 +83,7 @@ namespace puffin
         DisplayPtr display_{nullptr};
         DisplayConfigurationPtr display_configuration_{nullptr};
         InputPtr input_{nullptr};
+        JobSystemPtr job_system_{nullptr};
         MasterManagerPtr master_manager_{nullptr};
         MasterRendererPtr master_renderer_{nullptr};
         StateMachinePtr state_machine_{nullptr};
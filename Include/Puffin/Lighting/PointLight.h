@@ -10,6 +10,7 @@
 
 #include <glm/glm.hpp>
 
+#include <cmath>
 #include <memory>
 
 #include "Puffin/Common/Logger.h"
@@ -72,6 +73,17 @@ namespace puffin
             return quadratic_factor_;
         }
 
+        // Distance at which attenuation drops below 1/256, so light's
+        // contribution is not visible anymore
+        GLfloat getRange() const
+        {
+            constexpr GLfloat threshold = 256.0f;
+
+            return (-linear_factor_ + std::sqrt(linear_factor_ *
+                linear_factor_ + 4.0f * quadratic_factor_ * (threshold -
+                1.0f))) / (2.0f * quadratic_factor_);
+        }
+
         void setPosition(const glm::vec3 &position)
         {
             position_ = position;
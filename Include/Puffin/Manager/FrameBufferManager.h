@@ -43,6 +43,12 @@ namespace puffin
         void addRenderBuffer(FrameBufferPtr frame_buffer, RenderBufferType type,
             GLint width, GLint height, GLboolean multisampled);
         void addCubeMapDepthBuffer(FrameBufferPtr frame_buffer, GLint size);
+        void setCubeMapDepthBufferFace(FrameBufferPtr frame_buffer,
+            TexturePtr cube_texture, GLint face);
+        void addDepthArrayBuffer(FrameBufferPtr frame_buffer, GLint size,
+            GLint layers);
+        void setDepthArrayBufferLayer(FrameBufferPtr frame_buffer,
+            GLint layer);
 
         void disableDrawBuffer(FrameBufferPtr frame_buffer);
         void disableReadBuffer(FrameBufferPtr frame_buffer);
@@ -16,6 +16,8 @@ namespace puffin
 {
     class LightManager : public BaseManager
     {
+        friend class MasterRenderer;
+
     public:
         LightManager() : BaseManager("core_light_manager")
         {
@@ -82,13 +84,69 @@ namespace puffin
             return point_light_containter_.size();
         }
 
+        // Lights read by renderers. When rendering runs on separate thread,
+        // these are copies from frame snapshot, so lights above can be
+        // changed during rendering.
+        GLboolean isRenderLightingEnabled() const
+        {
+            if (render_directional_light_)
+                return render_lighting_enabled_;
+
+            return lighting_enabled_;
+        }
+
+        DirectionalLightPtr renderDirectionalLight() const
+        {
+            if (render_directional_light_)
+                return render_directional_light_;
+
+            return directional_light_;
+        }
+
+        const std::vector<PointLightPtr>& getRenderPointLightContainer() const
+        {
+            if (render_point_lights_)
+                return *render_point_lights_;
+
+            return point_light_containter_;
+        }
+
+        PointLightPtr getRenderPointLight(GLuint index) const
+        {
+            const auto &point_lights = getRenderPointLightContainer();
+            if (index >= point_lights.size())
+                logErrorAndThrow(name_, "LightManager::getRenderPointLight()",
+                    "Point light index value out of range.");
+
+            return point_lights[index];
+        }
+
+        GLuint getRenderPointLightsCount() const
+        {
+            return getRenderPointLightContainer().size();
+        }
+
     protected:
-        static constexpr GLint max_point_lights_count_{4};
+        // Empty directional light restores lights above
+        void useRenderLights(GLboolean lighting_enabled,
+            DirectionalLightPtr directional_light,
+            const std::vector<PointLightPtr> *point_lights)
+        {
+            render_lighting_enabled_ = lighting_enabled;
+            render_directional_light_ = directional_light;
+            render_point_lights_ = directional_light ? point_lights : nullptr;
+        }
+
+        static constexpr GLint max_point_lights_count_{1024};
 
         GLboolean lighting_enabled_{false};
 
         DirectionalLightPtr directional_light_{nullptr};
         std::vector<PointLightPtr> point_light_containter_;
+
+        GLboolean render_lighting_enabled_{false};
+        DirectionalLightPtr render_directional_light_{nullptr};
+        const std::vector<PointLightPtr> *render_point_lights_{nullptr};
     };
 
     using LightManagerPtr = std::shared_ptr<LightManager>;
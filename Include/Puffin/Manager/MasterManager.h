@@ -9,6 +9,7 @@
 #include <memory>
 
 #include "Puffin/Common/Logger.h"
+#include "Puffin/Common/System.h"
 #include "Puffin/Configuration/StateMachine.h"
 #include "Puffin/Display/DisplayConfiguration.h"
 #include "Puffin/Manager/FrameBufferManager.h"
@@ -25,7 +26,7 @@ namespace puffin
     {
     public:
         MasterManager(DisplayConfigurationPtr display_configuration,
-            StateMachinePtr state_machine);
+            StateMachinePtr state_machine, SystemPtr system);
         virtual ~MasterManager();
 
         FrameBufferManagerPtr frameBufferManager() const
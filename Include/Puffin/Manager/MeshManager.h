@@ -47,6 +47,8 @@ namespace puffin
         void setMeshIndices(BaseMeshPtr mesh, std::vector<GLuint> data);
 
     protected:
+        void calculateBoundingSphere(BaseMeshPtr mesh,
+            const std::vector<GLfloat> &positions) const;
         std::string processTexturePath(std::string model_file_path,
             const aiString &texture_path);
 
@@ -11,27 +11,96 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
 #include <vector>
 
+#ifdef UNIX
+#include <sys/stat.h>
+#else
+#include <direct.h>
+#endif // UNIX
+
+#include "Puffin/Common/System.h"
 #include "Puffin/Configuration/StateMachine.h"
 #include "Puffin/Manager/BaseManager.h"
 #include "Puffin/Shader/ShaderProgram.h"
+#include "Puffin/Shader/ShaderVariants.h"
 
 namespace puffin
 {
     class ShaderManager : public BaseManager
     {
     public:
-        explicit ShaderManager(StateMachinePtr state_machine);
+        ShaderManager(StateMachinePtr state_machine, SystemPtr system);
         virtual ~ShaderManager();
 
+        // Defines are inserted after #version directive of every shader
         ShaderProgramPtr createShaderProgram(std::string program_name,
-            std::string vs_path, std::string fs_path, std::string gs_path = "");
+            std::string vs_path, std::string fs_path, std::string gs_path = "",
+            const std::vector<std::string> &defines = {});
+
+        // Compile and link are only started. Status is checked by
+        // isShaderProgramReady(), finishShaderPrograms() or first uniform
+        // set. Link error is thrown there and by every later use.
+        ShaderProgramPtr createShaderProgramAsync(std::string program_name,
+            std::string vs_path, std::string fs_path, std::string gs_path = "",
+            const std::vector<std::string> &defines = {});
+
+        // Does not block when driver compiles in parallel
+        GLboolean isShaderProgramReady(ShaderProgramPtr shader_program);
+        void finishShaderPrograms();
+
+        GLboolean isParallelCompileSupported() const
+        {
+            return parallel_compile_supported_;
+        }
+
+        ShaderVariantsPtr createShaderVariants(std::string variants_name,
+            std::string vs_path, std::string fs_path, std::string gs_path,
+            const std::vector<std::string> &features);
+        ShaderProgramPtr getShaderVariant(ShaderVariantsPtr shader_variants,
+            GLuint features_mask);
+        // Returned variant may be still compiling
+        ShaderProgramPtr requestShaderVariant(
+            ShaderVariantsPtr shader_variants, GLuint features_mask);
+
+        // Linked programs are stored in binary form and loaded on next run
+        // instead of compiling. Binaries rejected by driver are recompiled.
+        void enableBinaryCache(GLboolean state)
+        {
+            binary_cache_enabled_ = state;
+        }
+
+        GLboolean isBinaryCacheEnabled() const
+        {
+            return binary_cache_enabled_ && binary_cache_supported_;
+        }
+
+        // Directory is created on first save, its parent has to exist
+        void setBinaryCacheDirectory(std::string directory)
+        {
+            if (directory.empty())
+                logErrorAndThrow(name_,
+                    "ShaderManager::setBinaryCacheDirectory()",
+                    "Empty binary cache directory path.");
+
+            binary_cache_directory_ = directory;
+        }
+
+        std::string getBinaryCacheDirectory() const
+        {
+            return binary_cache_directory_;
+        }
 
         void setUniform(ShaderProgramPtr shader_program,
-            std::string uniform_name, const glm::mat4 &value) const
+            std::string uniform_name, const glm::mat4 &value)
         {
+            finishShaderProgram(shader_program);
             state_machine_->activateShaderProgram(shader_program);
 
             auto location = shader_program->getUniformLocation(uniform_name);
@@ -47,8 +116,27 @@ namespace puffin
         }
 
         void setUniform(ShaderProgramPtr shader_program,
-            std::string uniform_name, const glm::vec3 &value) const
+            std::string uniform_name, const glm::vec2 &value)
         {
+            finishShaderProgram(shader_program);
+            state_machine_->activateShaderProgram(shader_program);
+
+            auto location = shader_program->getUniformLocation(uniform_name);
+            if (location == -1)
+            {
+                logWarning(name_, "ShaderManager::setUniform()",
+                    "Uniform [" + uniform_name + "] does not exist in shader "
+                    "program [" + shader_program->getName() + "].");
+                return;
+            }
+
+            glUniform2fv(location, 1, glm::value_ptr(value));
+        }
+
+        void setUniform(ShaderProgramPtr shader_program,
+            std::string uniform_name, const glm::vec3 &value)
+        {
+            finishShaderProgram(shader_program);
             state_machine_->activateShaderProgram(shader_program);
 
             auto location = shader_program->getUniformLocation(uniform_name);
@@ -64,8 +152,9 @@ namespace puffin
         }
 
         void setUniform(ShaderProgramPtr shader_program,
-            std::string uniform_name, const glm::vec4 &value) const
+            std::string uniform_name, const glm::vec4 &value)
         {
+            finishShaderProgram(shader_program);
             state_machine_->activateShaderProgram(shader_program);
 
             auto location = shader_program->getUniformLocation(uniform_name);
@@ -81,8 +170,9 @@ namespace puffin
         }
 
         void setUniform(ShaderProgramPtr shader_program,
-            std::string uniform_name, GLint value) const
+            std::string uniform_name, GLint value)
         {
+            finishShaderProgram(shader_program);
             state_machine_->activateShaderProgram(shader_program);
 
             auto location = shader_program->getUniformLocation(uniform_name);
@@ -98,8 +188,27 @@ namespace puffin
         }
 
         void setUniform(ShaderProgramPtr shader_program,
-            std::string uniform_name, GLfloat value) const
+            std::string uniform_name, const glm::ivec3 &value)
         {
+            finishShaderProgram(shader_program);
+            state_machine_->activateShaderProgram(shader_program);
+
+            auto location = shader_program->getUniformLocation(uniform_name);
+            if (location == -1)
+            {
+                logWarning(name_, "ShaderManager::setUniform()",
+                    "Uniform [" + uniform_name + "] does not exist in shader "
+                    "program [" + shader_program->getName() + "].");
+                return;
+            }
+
+            glUniform3iv(location, 1, glm::value_ptr(value));
+        }
+
+        void setUniform(ShaderProgramPtr shader_program,
+            std::string uniform_name, GLfloat value)
+        {
+            finishShaderProgram(shader_program);
             state_machine_->activateShaderProgram(shader_program);
 
             auto location = shader_program->getUniformLocation(uniform_name);
@@ -118,14 +227,41 @@ namespace puffin
         GLint loadShaderCode(std::string file_path,
             std::string &shader_code) const;
 
-        GLint compileShader(GLuint shader_handle) const;
+        std::string injectDefines(const std::string &shader_code,
+            const std::vector<std::string> &defines) const;
+
+        ShaderProgramPtr submitShaderProgram(std::string program_name,
+            std::string vs_path, std::string fs_path, std::string gs_path,
+            const std::vector<std::string> &defines);
+        void finishShaderProgram(ShaderProgramPtr shader_program);
+
+        void compileShader(GLuint shader_handle) const;
         GLint checkShaderCompileStatus(GLuint shader_handle) const;
         std::string getShaderCompileMessage(GLuint shader_handle) const;
 
-        GLint linkProgram(ShaderProgramPtr shader_program) const;
+        void linkProgram(ShaderProgramPtr shader_program) const;
         GLint checkProgramLinkStatus(ShaderProgramPtr shader_program) const;
+        std::string getProgramLinkMessage(
+            ShaderProgramPtr shader_program) const;
+
+        std::string getBinaryCachePath(std::string program_name,
+            const std::vector<std::string> &sources) const;
+        GLint loadProgramBinary(ShaderProgramPtr shader_program,
+            std::string file_path) const;
+        void saveProgramBinary(ShaderProgramPtr shader_program,
+            std::string file_path) const;
+        void createBinaryCacheDirectory() const;
+        void releaseShaders(ShaderProgramPtr shader_program) const;
 
         StateMachinePtr state_machine_{nullptr};
+        SystemPtr system_{nullptr};
+
+        GLboolean binary_cache_supported_{false};
+        GLboolean binary_cache_enabled_{true};
+        std::string binary_cache_directory_{"shaders/cache"};
+
+        GLboolean parallel_compile_supported_{false};
+        std::vector<ShaderProgramPtr> pending_programs_;
 
         std::vector<ShaderProgramPtr> shader_program_container_;
     };
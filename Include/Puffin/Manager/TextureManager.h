@@ -16,6 +16,7 @@
 #include "Puffin/Configuration/StateMachine.h"
 #include "Puffin/Manager/BaseManager.h"
 #include "Puffin/Texture/Texture.h"
+#include "Puffin/Texture/TextureBufferFormat.h"
 #include "Puffin/Texture/TextureFilter.h"
 #include "Puffin/Texture/TextureWrap.h"
 
@@ -24,9 +25,11 @@ namespace puffin
     class TextureManager : public BaseManager
     {
         friend class FontRenderer;
+        friend class GlyphAtlas;
         friend class MasterRenderer;
         friend class Object3DRenderer;
         friend class ParticleRenderer;
+        friend class PostprocessRenderer;
         friend class SkyboxRenderer;
         friend class WaterRenderer;
 
@@ -45,11 +48,20 @@ namespace puffin
         TexturePtr createTexture2D(std::string texture_name = "");
         TexturePtr createTextureDepthBuffer(GLint width, GLint height,
             std::string texture_name = "");
+        TexturePtr createTextureDepthArray(GLint size, GLint layers,
+            std::string texture_name = "");
         TexturePtr createTextureRgbBuffer(GLint width, GLint height,
             GLboolean multisample, std::string texture_name = "");
+        TexturePtr createTextureBuffer(TextureBufferFormat format,
+            std::string texture_name = "");
 
         void setTexture2DData(TexturePtr texture, GLubyte *data, GLint width,
             GLint height, GLint color_channels);
+        // Replaces region of texture, data has texture's color channels
+        void updateTexture2DData(TexturePtr texture, const GLubyte *data,
+            GLint x, GLint y, GLint width, GLint height);
+        void setTextureBufferData(TexturePtr texture, const GLvoid *data,
+            GLsizeiptr size);
 
         void setTexture2DBorderColor(TexturePtr texture,
             const glm::vec4 &color) const;
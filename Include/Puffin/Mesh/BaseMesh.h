@@ -10,8 +10,11 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <map>
 #include <memory>
 #include <vector>
@@ -32,6 +35,7 @@ namespace puffin
 
     class BaseMesh
     {
+        friend class MasterRenderer;
         friend class MeshManager;
         friend class StateMachine;
 
@@ -71,6 +75,14 @@ namespace puffin
             return model_matrix_;
         }
 
+        // Model matrix blended between two last simulation steps. Used for
+        // rendering, so movement is smooth at any frame rate. It is set by
+        // renderer before drawing, so it never changes during a frame.
+        glm::mat4 getRenderModelMatrix() const
+        {
+            return render_model_matrix_;
+        }
+
         void setScale(const glm::vec3 &scale)
         {
             scale_ = scale;
@@ -128,9 +140,83 @@ namespace puffin
             model_matrix_changed_ = true;
         }
 
+        // Bounding sphere in world space
+        glm::vec3 getBoundingSphereCenter()
+        {
+            return glm::vec3(getModelMatrix() *
+                glm::vec4(bounding_sphere_center_, 1.0f));
+        }
+
+        GLfloat getBoundingSphereRadius() const
+        {
+            GLfloat max_scale = std::max(std::abs(scale_.x),
+                std::max(std::abs(scale_.y), std::abs(scale_.z)));
+            return bounding_sphere_radius_ * max_scale;
+        }
+
+        // Bounding sphere of transform used for rendering
+        glm::vec3 getRenderBoundingSphereCenter() const
+        {
+            return render_bounding_sphere_center_;
+        }
+
+        GLfloat getRenderBoundingSphereRadius() const
+        {
+            return render_bounding_sphere_radius_;
+        }
+
     protected:
         virtual void draw(GLuint index = 0) = 0;
 
+        void storePreviousTransform()
+        {
+            previous_model_matrix_ = getModelMatrix();
+            previous_translation_ = glm::vec3(translation_matrix_[3]);
+            previous_rotation_ = glm::quat_cast(rotation_matrix_);
+            previous_scale_ = scale_;
+            previous_transform_stored_ = true;
+        }
+
+        void setInterpolationAlpha(GLfloat alpha)
+        {
+            interpolation_alpha_ = alpha;
+        }
+
+        glm::mat4 calculateRenderModelMatrix()
+        {
+            // Object created after last step has nothing to blend with
+            auto model_matrix = getModelMatrix();
+            if (!previous_transform_stored_ || interpolation_alpha_ >= 1.0f ||
+                previous_model_matrix_ == model_matrix)
+                return model_matrix;
+
+            glm::vec3 translation = glm::mix(previous_translation_,
+                glm::vec3(translation_matrix_[3]), interpolation_alpha_);
+            glm::quat rotation = glm::slerp(previous_rotation_,
+                glm::quat_cast(rotation_matrix_), interpolation_alpha_);
+            glm::vec3 scale = glm::mix(previous_scale_, scale_,
+                interpolation_alpha_);
+
+            return glm::translate(glm::mat4(1.0f), translation) *
+                glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+        }
+
+        void updateRenderTransform()
+        {
+            setRenderTransform(calculateRenderModelMatrix(),
+                getBoundingSphereRadius());
+        }
+
+        // Render thread sets transform captured by simulation thread
+        void setRenderTransform(const glm::mat4 &model_matrix,
+            GLfloat bounding_sphere_radius)
+        {
+            render_model_matrix_ = model_matrix;
+            render_bounding_sphere_center_ = glm::vec3(model_matrix *
+                glm::vec4(bounding_sphere_center_, 1.0f));
+            render_bounding_sphere_radius_ = bounding_sphere_radius;
+        }
+
         std::string name_{"unnamed_base_mesh"};
 
         GLuint handle_{0};
@@ -143,6 +229,21 @@ namespace puffin
         glm::mat4 translation_matrix_{1.0f};
         glm::vec3 position_{0.0f, 0.0f, 0.0f};
         glm::vec3 scale_{1.0f, 1.0f, 1.0f};
+
+        // Transform at the beginning of last simulation step
+        glm::mat4 previous_model_matrix_{1.0f};
+        glm::vec3 previous_translation_{0.0f, 0.0f, 0.0f};
+        glm::quat previous_rotation_{1.0f, 0.0f, 0.0f, 0.0f};
+        glm::vec3 previous_scale_{1.0f, 1.0f, 1.0f};
+        GLboolean previous_transform_stored_{false};
+        GLfloat interpolation_alpha_{1.0f};
+
+        glm::mat4 render_model_matrix_{1.0f};
+        glm::vec3 render_bounding_sphere_center_{0.0f, 0.0f, 0.0f};
+        GLfloat render_bounding_sphere_radius_{0.0f};
+
+        glm::vec3 bounding_sphere_center_{0.0f, 0.0f, 0.0f};
+        GLfloat bounding_sphere_radius_{0.0f};
     };
 
     using BaseMeshPtr = std::shared_ptr<BaseMesh>;
@@ -19,6 +19,7 @@ namespace puffin
         friend class MeshManager;
         friend class Object3DRenderer;
         friend class ParticleRenderer;
+        friend class PostprocessRenderer;
 
     public:
         explicit Object3D(std::string name = "");
@@ -50,9 +51,26 @@ namespace puffin
 
         void addModifier(Object3DModifierPtr modifier);
 
-        Object3DModifierPtr getModifier(Object3DModifierType modifier_type)
+        Object3DModifierPtr getModifier(
+            Object3DModifierType modifier_type) const
         {
-            return modifiers_[modifier_type];
+            auto modifier = modifiers_.find(modifier_type);
+            if (modifier == modifiers_.end())
+                return nullptr;
+
+            return modifier->second;
+        }
+
+        // Static objects are rendered once into cached shadow maps. Moving
+        // static object invalidates the cache.
+        void setStatic(GLboolean state)
+        {
+            static_ = state;
+        }
+
+        GLboolean isStatic() const
+        {
+            return static_;
         }
 
     protected:
@@ -72,7 +90,32 @@ namespace puffin
                 glDrawArrays(GL_TRIANGLES, 0, entity->getVerticesCount());
         }
 
+        // Vertices range of object without indices
+        void drawRange(GLint first, GLint count)
+        {
+            glDrawArrays(GL_TRIANGLES, first, count);
+        }
+
+        void drawInstanced(GLuint index, GLint instances_count)
+        {
+            if (index >= entities_.size())
+                logErrorAndThrow(name_, "Object3D::drawInstanced()",
+                    "Entity index value out of range.");
+
+            auto entity = entities_[index];
+
+            if (use_indices_)
+                glDrawElementsInstanced(GL_TRIANGLES,
+                    entity->getIndicesCount(), GL_UNSIGNED_INT,
+                    reinterpret_cast<void*>(sizeof(GLint) *
+                        entity->getStartingIndex()), instances_count);
+            else
+                glDrawArraysInstanced(GL_TRIANGLES, 0,
+                    entity->getVerticesCount(), instances_count);
+        }
+
         GLboolean use_indices_{false};
+        GLboolean static_{false};
         std::vector<Object3DEntityPtr> entities_;
         std::map<Object3DModifierType, Object3DModifierPtr> modifiers_;
     };
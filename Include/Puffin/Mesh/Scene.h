@@ -22,6 +22,8 @@ namespace puffin
 {
     class Scene
     {
+        friend class MasterRenderer;
+
     public:
         explicit Scene(std::string name);
         virtual ~Scene();
@@ -100,6 +100,11 @@ namespace puffin
             glDrawArrays(GL_TRIANGLES, 0, 6);
         }
 
+        void drawInstanced(GLint instances_count)
+        {
+            glDrawArraysInstanced(GL_TRIANGLES, 0, 6, instances_count);
+        }
+
         glm::vec3 water_color_{0.0f, 0.3f, 0.5f};
         GLfloat wave_strength_{0.04f};
         GLfloat wave_speed_{0.01f};
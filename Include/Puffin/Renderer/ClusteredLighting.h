@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#ifndef PUFFIN_CLUSTERED_LIGHTING_H
+#define PUFFIN_CLUSTERED_LIGHTING_H
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Puffin/Camera/Camera.h"
+#include "Puffin/Camera/Frustum.h"
+#include "Puffin/Common/Logger.h"
+#include "Puffin/Configuration/StateMachine.h"
+#include "Puffin/Manager/MasterManager.h"
+
+namespace puffin
+{
+    // Splits view frustum into grid of clusters (froxels) with exponential
+    // depth slices and assigns point lights to clusters they affect. Shaders
+    // process only lights of fragment's cluster.
+    class ClusteredLighting
+    {
+        friend class Object3DRenderer;
+
+    public:
+        ClusteredLighting(MasterManagerPtr master_manager,
+            StateMachinePtr state_machine);
+        virtual ~ClusteredLighting();
+
+        void setGridSize(GLint size_x, GLint size_y, GLint size_z);
+
+        glm::ivec3 getGridSize() const
+        {
+            return grid_size_;
+        }
+
+        // Limits per pixel cost. Nearest lights are kept when cluster
+        // overflows.
+        void setMaxLightsPerCluster(GLint count);
+
+        GLint getMaxLightsPerCluster() const
+        {
+            return max_lights_per_cluster_;
+        }
+
+        GLuint getVisibleLightsCount() const
+        {
+            return visible_lights_count_;
+        }
+
+    protected:
+        struct ClusterBounds
+        {
+            glm::vec3 min;
+            glm::vec3 max;
+        };
+
+        struct VisibleLight
+        {
+            GLuint index;
+            glm::vec3 position_VIEW;
+            GLfloat range;
+        };
+
+        void update(CameraPtr camera,
+            const std::vector<glm::vec3> &shadow_tiles);
+        void calculateClustersBounds(CameraPtr camera);
+        void assignLight(const VisibleLight &light, GLuint light_index,
+            const glm::mat4 &projection_matrix);
+
+        GLint getSliceIndex(GLfloat depth) const;
+        GLint getClusterIndex(GLint x, GLint y, GLint z) const
+        {
+            return x + grid_size_.x * (y + grid_size_.y * z);
+        }
+
+        TexturePtr getLightsTexture() const
+        {
+            return lights_texture_;
+        }
+
+        TexturePtr getClustersTexture() const
+        {
+            return clusters_texture_;
+        }
+
+        TexturePtr getLightIndicesTexture() const
+        {
+            return light_indices_texture_;
+        }
+
+        glm::vec2 getScreenSize() const
+        {
+            return screen_size_;
+        }
+
+        GLfloat getNearPlane() const
+        {
+            return near_plane_;
+        }
+
+        // Multiplier converting logarithm of depth into slice index
+        GLfloat getDepthScale() const
+        {
+            return depth_scale_;
+        }
+
+        std::string name_{"core_clustered_lighting"};
+
+        MasterManagerPtr master_manager_{nullptr};
+        StateMachinePtr state_machine_{nullptr};
+
+        glm::ivec3 grid_size_{16, 9, 24};
+        GLint max_lights_per_cluster_{64};
+
+        glm::mat4 projection_matrix_{0.0f};
+        GLfloat near_plane_{0.0f};
+        GLfloat far_plane_{0.0f};
+        GLfloat depth_scale_{0.0f};
+        glm::vec2 screen_size_{1.0f, 1.0f};
+        GLboolean bounds_outdated_{true};
+
+        std::vector<ClusterBounds> clusters_bounds_;
+        std::vector<std::vector<GLuint>> clusters_lights_;
+        GLuint visible_lights_count_{0};
+
+        std::vector<GLfloat> lights_data_;
+        std::vector<GLuint> clusters_data_;
+        std::vector<GLuint> light_indices_data_;
+
+        TexturePtr lights_texture_{nullptr};
+        TexturePtr clusters_texture_{nullptr};
+        TexturePtr light_indices_texture_{nullptr};
+    };
+
+    using ClusteredLightingPtr = std::shared_ptr<ClusteredLighting>;
+} // namespace puffin
+
+#endif // PUFFIN_CLUSTERED_LIGHTING_H
\ No newline at end of file
@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#ifndef PUFFIN_DYNAMIC_RESOLUTION_H
+#define PUFFIN_DYNAMIC_RESOLUTION_H
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+
+#include "Puffin/Common/GpuTimer.h"
+#include "Puffin/Common/Logger.h"
+
+namespace puffin
+{
+    // Scales internal render resolution, so GPU time of a frame stays close
+    // to target frame time. Scene is rendered to part of postprocess frame
+    // buffer and stretched to the window.
+    class DynamicResolution
+    {
+        friend class MasterRenderer;
+
+    public:
+        DynamicResolution()
+        {
+            frame_timer_.reset(new GpuTimer("core_frame_timer"));
+
+            logDebug(name_, "DynamicResolution::DynamicResolution()",
+                "Dynamic resolution created.");
+        }
+
+        virtual ~DynamicResolution()
+        {
+            logDebug(name_, "DynamicResolution::~DynamicResolution()",
+                "Dynamic resolution destroyed.");
+        }
+
+        std::string getName() const
+        {
+            return name_;
+        }
+
+        void enable(GLboolean state)
+        {
+            enabled_ = state;
+            if (!enabled_)
+                render_scale_ = max_scale_;
+        }
+
+        GLboolean isEnabled() const
+        {
+            return enabled_;
+        }
+
+        // Time in milliseconds
+        void setTargetFrameTime(GLdouble time)
+        {
+            if (time <= 0.0)
+                logErrorAndThrow(name_,
+                    "DynamicResolution::setTargetFrameTime()",
+                    "Target frame time value out of range: {0.0 < VALUE}.");
+
+            target_frame_time_ = time;
+        }
+
+        GLdouble getTargetFrameTime() const
+        {
+            return target_frame_time_;
+        }
+
+        void setScaleRange(GLfloat min_scale, GLfloat max_scale)
+        {
+            if (min_scale <= 0.0f || min_scale > max_scale ||
+                max_scale > 1.0f)
+                logErrorAndThrow(name_, "DynamicResolution::setScaleRange()",
+                    "Scale range value out of range: "
+                    "{0.0 < MIN <= MAX <= 1.0}.");
+
+            min_scale_ = min_scale;
+            max_scale_ = max_scale;
+            render_scale_ = glm::clamp(render_scale_, min_scale_, max_scale_);
+        }
+
+        GLfloat getMinScale() const
+        {
+            return min_scale_;
+        }
+
+        GLfloat getMaxScale() const
+        {
+            return max_scale_;
+        }
+
+        // Fraction of window's width and height used for rendering scene
+        GLfloat getRenderScale() const
+        {
+            return render_scale_;
+        }
+
+        // Averaged GPU time of a frame in milliseconds
+        GLdouble getFrameTime() const
+        {
+            return frame_timer_->getAverageElapsedTime();
+        }
+
+    protected:
+        void beginFrame()
+        {
+            frame_timer_->begin();
+        }
+
+        void endFrame()
+        {
+            frame_timer_->end();
+            update();
+        }
+
+        void update()
+        {
+            if (!enabled_)
+                return;
+
+            // Measurements arrive a few frames late, so scale is changed
+            // only when result of previous change could be observed
+            if (++frames_since_change_ < adjust_interval_)
+                return;
+
+            auto frame_time = getFrameTime();
+            if (frame_time <= 0.0)
+                return;
+
+            // Scale is raised only with some headroom left, otherwise it
+            // would oscillate around target
+            if (frame_time <= target_frame_time_ &&
+                frame_time >= target_frame_time_ * headroom_)
+                return;
+
+            // Frame cost grows with pixels count, which is square of scale
+            GLfloat desired_scale = render_scale_ * static_cast<GLfloat>(
+                std::sqrt(target_frame_time_ * headroom_ / frame_time));
+            desired_scale = glm::clamp(desired_scale,
+                render_scale_ - max_scale_step_,
+                render_scale_ + max_scale_step_);
+            desired_scale = glm::clamp(desired_scale, min_scale_, max_scale_);
+
+            if (desired_scale != render_scale_)
+            {
+                render_scale_ = desired_scale;
+                frames_since_change_ = 0;
+            }
+        }
+
+        std::string name_{"core_dynamic_resolution"};
+
+        static constexpr GLint adjust_interval_{8};
+        static constexpr GLdouble headroom_{0.85};
+        static constexpr GLfloat max_scale_step_{0.1f};
+
+        GLboolean enabled_{false};
+        GLdouble target_frame_time_{1000.0 / 60.0};
+        GLfloat min_scale_{0.5f};
+        GLfloat max_scale_{1.0f};
+        GLfloat render_scale_{1.0f};
+        GLint frames_since_change_{0};
+
+        GpuTimerPtr frame_timer_{nullptr};
+    };
+
+    using DynamicResolutionPtr = std::shared_ptr<DynamicResolution>;
+} // namespace puffin
+
+#endif // PUFFIN_DYNAMIC_RESOLUTION_H
\ No newline at end of file
@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#ifndef PUFFIN_FIXED_TIMESTEP_H
+#define PUFFIN_FIXED_TIMESTEP_H
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "Puffin/Common/Logger.h"
+
+namespace puffin
+{
+    // Splits frame time into simulation steps of equal length. Time left
+    // after last step is carried to next frame.
+    class FixedTimestep
+    {
+        friend class MasterRenderer;
+
+    public:
+        FixedTimestep()
+        {
+            logDebug(name_, "FixedTimestep::FixedTimestep()",
+                "Fixed timestep created.");
+        }
+
+        virtual ~FixedTimestep()
+        {
+            logDebug(name_, "FixedTimestep::~FixedTimestep()",
+                "Fixed timestep destroyed.");
+        }
+
+        std::string getName() const
+        {
+            return name_;
+        }
+
+        void setTickRate(GLint ticks_per_second)
+        {
+            if (ticks_per_second <= 0)
+                logErrorAndThrow(name_, "FixedTimestep::setTickRate()",
+                    "Tick rate value out of range: {0 < VALUE}.");
+
+            tick_rate_ = ticks_per_second;
+        }
+
+        GLint getTickRate() const
+        {
+            return tick_rate_;
+        }
+
+        GLdouble getStep() const
+        {
+            return 1.0 / static_cast<GLdouble>(tick_rate_);
+        }
+
+        // Time exceeding this number of steps is dropped, so slow frames do
+        // not make simulation fall further behind
+        void setMaxStepsPerFrame(GLint steps)
+        {
+            if (steps <= 0)
+                logErrorAndThrow(name_, "FixedTimestep::setMaxStepsPerFrame()",
+                    "Steps count value out of range: {0 < VALUE}.");
+
+            max_steps_per_frame_ = steps;
+        }
+
+        GLint getMaxStepsPerFrame() const
+        {
+            return max_steps_per_frame_;
+        }
+
+        // Part of step elapsed since last simulation step
+        GLfloat getAlpha() const
+        {
+            return static_cast<GLfloat>(std::min(accumulator_ / getStep(),
+                1.0));
+        }
+
+        GLuint64 getTicksCount() const
+        {
+            return ticks_count_;
+        }
+
+    protected:
+        GLint advance(GLdouble frame_delta)
+        {
+            GLdouble step = getStep();
+            accumulator_ += std::min(std::max(frame_delta, 0.0),
+                step * max_steps_per_frame_);
+
+            GLint steps = std::min(static_cast<GLint>(accumulator_ / step),
+                max_steps_per_frame_);
+            accumulator_ -= steps * step;
+            ticks_count_ += steps;
+
+            return steps;
+        }
+
+        std::string name_{"core_fixed_timestep"};
+
+        GLint tick_rate_{60};
+        GLint max_steps_per_frame_{5};
+
+        GLdouble accumulator_{0.0};
+        GLuint64 ticks_count_{0};
+    };
+
+    using FixedTimestepPtr = std::shared_ptr<FixedTimestep>;
+} // namespace puffin
+
+#endif // PUFFIN_FIXED_TIMESTEP_H
\ No newline at end of file
@@ -0,0 +1,81 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#ifndef PUFFIN_FONT_FACE_H
+#define PUFFIN_FONT_FACE_H
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_SIZES_H
+#include FT_STROKER_H
+
+#include <GL/glew.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "Puffin/Common/Logger.h"
+
+namespace puffin
+{
+    // FreeType face shared by all texts using the same font. Size object is
+    // created once for every pixel size, so switching sizes does not scale
+    // face metrics again. FreeType objects are not thread safe, face has to
+    // be locked while glyphs are loaded.
+    class FontFace
+    {
+    public:
+        FontFace(FT_Library library, std::string path);
+        virtual ~FontFace();
+
+        std::unique_lock<std::mutex> lock()
+        {
+            return std::unique_lock<std::mutex>(mutex_);
+        }
+
+        std::string getPath() const
+        {
+            return path_;
+        }
+
+        // Following functions require face to be locked
+        void activateSize(GLint pixel_size);
+
+        FT_Face getFace() const
+        {
+            return face_;
+        }
+
+        FT_Stroker getStroker() const
+        {
+            return stroker_;
+        }
+
+        // Following functions lock face on their own
+        FT_UInt getGlyphIndex(wchar_t character);
+        // Kerning in pixels for given font size, zero when font has no
+        // kerning pairs
+        GLfloat getKerning(FT_UInt previous_index, FT_UInt glyph_index,
+            GLint pixel_size);
+
+    protected:
+        std::string name_{"core_font_face"};
+
+        std::string path_;
+        FT_Face face_{};
+        FT_Stroker stroker_{};
+
+        std::unordered_map<GLint, FT_Size> sizes_;
+        GLint active_size_{0};
+
+        std::mutex mutex_;
+    };
+
+    using FontFacePtr = std::shared_ptr<FontFace>;
+} // namespace puffin
+
+#endif // PUFFIN_FONT_FACE_H
\ No newline at end of file
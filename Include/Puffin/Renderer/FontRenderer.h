@@ -12,14 +12,22 @@
 
 #include <glm/glm.hpp>
 
-#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "Puffin/Configuration/StateMachine.h"
 #include "Puffin/Display/DisplayConfiguration.h"
 #include "Puffin/Manager/MasterManager.h"
 #include "Puffin/Mesh/Object3D.h"
 #include "Puffin/Renderer/BaseRenderer.h"
+#include "Puffin/Renderer/FontFace.h"
+#include "Puffin/Renderer/GlyphAtlas.h"
 #include "Puffin/UI/Text.h"
 
 
@@ -35,31 +43,152 @@ namespace puffin
             DisplayConfigurationPtr display_configuration);
         virtual ~FontRenderer();
 
+        GlyphAtlasPtr glyphAtlas() const
+        {
+            return glyph_atlas_;
+        }
+
+        // Font size used to generate distance field glyphs. Changing it
+        // clears glyph atlas.
+        void setDistanceFieldSize(GLint size);
+
+        GLint getDistanceFieldSize() const
+        {
+            return distance_field_size_;
+        }
+
+        // Distance in pixels (at distance field size) covered by field
+        // outside of glyph. It limits outline, glow and shadow offset.
+        void setDistanceFieldSpread(GLint spread);
+
+        GLint getDistanceFieldSpread() const
+        {
+            return distance_field_spread_;
+        }
+
+        // Size of box taken by text: wrap width (or width of widest line
+        // when wrapping is disabled) and height of all lines. Layout is
+        // cached, so text does not have to be rendered. Uploads glyphs, so
+        // with render thread enabled it has to be called on that thread.
+        glm::vec2 measure(TextPtr text);
+
     protected:
+        // Rasterized glyph copied out of FreeType, rows have no padding
+        struct GlyphBitmap
+        {
+            std::vector<GLubyte> data;
+            glm::ivec2 size{0, 0};
+            glm::ivec2 bearing{0, 0};
+            GLint advance{0};
+        };
+
+        // Pen position relative to baseline of text's first line
+        struct LayoutGlyph
+        {
+            wchar_t character{0};
+            glm::vec2 position{0.0f, 0.0f};
+            GLfloat advance{0.0f};
+        };
+
+        struct LayoutLine
+        {
+            GLint first{0};
+            GLint count{0};
+            GLfloat width{0.0f};
+        };
+
+        // Glyph positions of text, built again only when layout of text
+        // changes, not when text moves
+        struct TextLayout
+        {
+            GLuint version{0};
+            GLuint last_use_frame{0};
+            glm::vec2 size{0.0f, 0.0f};
+            std::vector<LayoutGlyph> glyphs;
+        };
+
+        // Range of text mesh drawn with one atlas page and color
+        struct TextBatch
+        {
+            GLboolean outline{false};
+            GLint page{0};
+            GLint first{0};
+            GLint count{0};
+        };
+
+        // Glyph quads of whole text, built again only when text changes
+        struct TextMesh
+        {
+            Object3DPtr mesh{nullptr};
+            GLuint version{0};
+            GLuint atlas_generation{0};
+            GLuint last_use_frame{0};
+            std::vector<TextBatch> batches;
+        };
+
         void render(ScenePtr scene);
 
         void loadShaders();
-        void setShaderUniforms(TextPtr text) const;
-        void createCharacterModel();
 
-        FT_Face createFontFace(TextPtr text);
-        FT_BitmapGlyph getCharacterGlyph(FT_Face font_face, wchar_t character,
-            GLint outline_size) const;
+        FontFacePtr createFontFace(TextPtr text);
+        GlyphAtlas::Glyph getGlyph(FontFacePtr font_face, TextPtr text,
+            wchar_t character, GLint outline_size);
+        GlyphAtlas::Glyph getTextGlyph(FontFacePtr font_face, TextPtr text,
+            wchar_t character);
+        GlyphAtlas::Glyph getDistanceFieldGlyph(FontFacePtr font_face,
+            TextPtr text, wchar_t character);
+        // Does not use OpenGL, so it can be called from any thread
+        GlyphBitmap rasterizeGlyph(FontFacePtr font_face, GLint pixel_size,
+            wchar_t character, GLint outline_size) const;
+
+        std::vector<GLubyte> calculateDistanceField(const GlyphBitmap &bitmap,
+            glm::ivec2 &size) const;
+        void calculateDistanceTransform(std::vector<GLfloat> &grid,
+            GLint width, GLint height) const;
+        void calculateLineDistances(const std::vector<GLfloat> &line,
+            GLint count, std::vector<GLfloat> &distances,
+            std::vector<GLint> &parabolas,
+            std::vector<GLfloat> &bounds) const;
 
         FT_Library ft_library_{};
-        FT_Stroker stroker_{};
-        std::unordered_map<std::string, FT_Face> font_faces_;
-
-        void renderSingleCharacter(FT_Face font_face, wchar_t character,
-            TextPtr text, GLint &cur_pos_x, GLint &cur_pos_y);
-        GLint processWhitespaces(FT_Face font_face, wchar_t character,
-            TextPtr text, GLint &cur_pos_x, GLint &cur_pos_y) const;
-        std::vector<glm::vec3> calculateVertices(GLint cursor_x, GLint cursor_y,
-            FT_BitmapGlyph bitmapGlyph) const;
+        std::unordered_map<std::string, FontFacePtr> font_faces_;
+        std::mutex font_faces_mutex_;
+
+        const TextLayout &getTextLayout(TextPtr text);
+        void layoutText(TextPtr text, TextLayout &layout);
+        void addLayoutLine(const TextLayout &layout, GLint first, GLint last,
+            std::vector<LayoutLine> &lines) const;
+        void alignLayoutLines(TextPtr text,
+            const std::vector<LayoutLine> &lines, TextLayout &layout) const;
+        GLfloat getKerning(FontFacePtr font_face, FT_UInt previous_index,
+            FT_UInt glyph_index, TextPtr text) const;
+
+        void buildTextMesh(TextPtr text, TextMesh &text_mesh);
+        void addGlyphQuad(const GlyphAtlas::Glyph &glyph, GLfloat cursor_x,
+            GLfloat cursor_y, GLfloat scale, std::vector<GLfloat> &positions,
+            std::vector<GLfloat> &texture_coords);
+        void renderTextMesh(TextPtr text, const TextMesh &text_mesh);
+        void setDistanceFieldUniforms(TextPtr text, GLint page);
+        std::vector<glm::vec3> calculateVertices(GLfloat cursor_x,
+            GLfloat cursor_y, GLfloat scale,
+            const GlyphAtlas::Glyph &glyph) const;
+
+        GLfloat getDistanceFieldScale(TextPtr text) const
+        {
+            return static_cast<GLfloat>(text->getFontSize()) /
+                static_cast<GLfloat>(distance_field_size_);
+        }
 
-        Object3DPtr character_object_{nullptr};
         ShaderProgramPtr shader_program_{nullptr};
-        TexturePtr character_texture_{nullptr};
+        ShaderProgramPtr distance_field_shader_program_{nullptr};
+        GlyphAtlasPtr glyph_atlas_{nullptr};
+
+        GLint distance_field_size_{48};
+        GLint distance_field_spread_{8};
+
+        std::unordered_map<TextPtr, TextLayout> text_layouts_;
+        std::unordered_map<TextPtr, TextMesh> text_meshes_;
+        GLuint frame_index_{0};
 
         GLfloat calculateScreenCoordX(GLfloat x)
         {
@@ -76,15 +205,6 @@ namespace puffin
         DisplayConfigurationPtr display_configuration_{nullptr};
         StateMachinePtr state_machine_{nullptr};
         MasterManagerPtr master_manager_{nullptr};
-
-        enum class TextRenderType
-        {
-            NO_OUTLINE,
-            OUTLINE,
-            TEXT,
-        };
-
-        TextRenderType render_type_{TextRenderType::NO_OUTLINE};
     };
 
     using FontRendererPtr = std::shared_ptr<FontRenderer>;
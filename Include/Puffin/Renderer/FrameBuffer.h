@@ -44,6 +44,11 @@ namespace puffin
             return cube_buffer_texture_;
         }
 
+        TexturePtr getDepthArrayTextureBuffer() const
+        {
+            return depth_array_texture_;
+        }
+
     protected:
         std::string name_{"unnamed_frame_buffer"};
 
@@ -53,6 +58,7 @@ namespace puffin
         TexturePtr rgb_buffer_texture_{nullptr};
         TexturePtr depth_buffer_texture_{nullptr};
         TexturePtr cube_buffer_texture_{nullptr};
+        TexturePtr depth_array_texture_{nullptr};
 
         // Render buffers
         struct RenderBuffer
@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#ifndef PUFFIN_FRAME_SNAPSHOT_H
+#define PUFFIN_FRAME_SNAPSHOT_H
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "Puffin/Camera/Camera.h"
+#include "Puffin/Lighting/DirectionalLight.h"
+#include "Puffin/Lighting/PointLight.h"
+#include "Puffin/Mesh/Scene.h"
+
+namespace puffin
+{
+    // State of one frame handed from simulation to render thread. Renderers
+    // read only snapshot, so simulation can change scene at the same time.
+    // Snapshots are reused, so their containers keep allocated memory.
+    class FrameSnapshot
+    {
+        friend class MasterRenderer;
+
+    public:
+        FrameSnapshot()
+        {
+            scene_.reset(new Scene("core_snapshot_scene"));
+            camera_.reset(new Camera("core_snapshot_camera"));
+            directional_light_.reset(new DirectionalLight());
+        }
+
+        GLuint64 getFrameIndex() const
+        {
+            return frame_index_;
+        }
+
+        // Simulation time covered by snapshot in seconds
+        GLdouble getDelta() const
+        {
+            return delta_;
+        }
+
+    protected:
+        struct ObjectState
+        {
+            Object3DPtr object;
+            glm::mat4 model_matrix;
+            GLfloat bounding_sphere_radius;
+        };
+
+        GLuint64 frame_index_{0};
+        GLdouble delta_{0.0};
+
+        ScenePtr scene_{nullptr};
+        CameraPtr camera_{nullptr};
+        std::vector<ObjectState> objects_;
+        // Copies of scene's texts, keyed by original text
+        std::map<TextPtr, TextPtr> texts_;
+
+        GLboolean lighting_enabled_{false};
+        DirectionalLightPtr directional_light_{nullptr};
+        std::vector<PointLightPtr> point_lights_;
+    };
+
+    using FrameSnapshotPtr = std::shared_ptr<FrameSnapshot>;
+} // namespace puffin
+
+#endif // PUFFIN_FRAME_SNAPSHOT_H
\ No newline at end of file
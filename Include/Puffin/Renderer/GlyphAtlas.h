@@ -0,0 +1,178 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#ifndef PUFFIN_GLYPH_ATLAS_H
+#define PUFFIN_GLYPH_ATLAS_H
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Puffin/Common/Logger.h"
+#include "Puffin/Manager/MasterManager.h"
+
+namespace puffin
+{
+    // Keeps rasterized glyphs in textures (pages) packed in shelves, so
+    // glyphs are rendered by FreeType only once. When all pages are full,
+    // page used least recently is cleared.
+    class GlyphAtlas
+    {
+        friend class FontRenderer;
+
+    public:
+        explicit GlyphAtlas(MasterManagerPtr master_manager);
+        virtual ~GlyphAtlas();
+
+        // Size of new pages, existing ones are not resized
+        void setPageSize(GLint size);
+
+        GLint getPageSize() const
+        {
+            return page_size_;
+        }
+
+        void setMaxPagesCount(GLint count);
+
+        GLint getMaxPagesCount() const
+        {
+            return max_pages_count_;
+        }
+
+        GLint getPagesCount() const
+        {
+            return static_cast<GLint>(pages_.size());
+        }
+
+        GLuint getGlyphsCount() const
+        {
+            return static_cast<GLuint>(glyphs_.size());
+        }
+
+        // Changes whenever glyphs are removed, so cached texts using old
+        // glyphs can be built again
+        GLuint getGeneration() const
+        {
+            return generation_;
+        }
+
+        // Removes all glyphs, pages are kept
+        void clear();
+
+    protected:
+        // Distance field glyphs are stored once per font, with size set to
+        // size used to generate field
+        struct GlyphKey
+        {
+            std::string font;
+            GLint size;
+            GLint outline_size;
+            GLuint codepoint;
+            GLboolean distance_field;
+
+            bool operator==(const GlyphKey &other) const
+            {
+                return codepoint == other.codepoint && size == other.size &&
+                    outline_size == other.outline_size &&
+                    distance_field == other.distance_field &&
+                    font == other.font;
+            }
+        };
+
+        struct GlyphKeyHash
+        {
+            std::size_t operator()(const GlyphKey &key) const
+            {
+                std::size_t hash = std::hash<std::string>()(key.font);
+                hash = hash * 31 + std::hash<GLint>()(key.size);
+                hash = hash * 31 + std::hash<GLint>()(key.outline_size);
+                hash = hash * 31 + std::hash<GLuint>()(key.codepoint);
+                hash = hash * 31 + (key.distance_field ? 1 : 0);
+                return hash;
+            }
+        };
+
+        // Glyphs without bitmap (e.g. space) have no page
+        struct Glyph
+        {
+            GLint page{-1};
+            glm::vec2 uv_min{0.0f, 0.0f};
+            glm::vec2 uv_max{0.0f, 0.0f};
+            glm::ivec2 size{0, 0};
+            glm::ivec2 bearing{0, 0};
+            GLint advance{0};
+        };
+
+        struct Shelf
+        {
+            GLint y{0};
+            GLint height{0};
+            GLint used_width{0};
+        };
+
+        struct Page
+        {
+            TexturePtr texture{nullptr};
+            std::vector<Shelf> shelves;
+            GLint used_height{0};
+            GLuint last_use_frame{0};
+        };
+
+        void beginFrame()
+        {
+            frame_index_++;
+        }
+
+        void usePage(GLint page)
+        {
+            pages_[page].last_use_frame = frame_index_;
+        }
+
+        GLboolean findGlyph(const GlyphKey &key, Glyph &glyph);
+        // Bitmap has one byte per pixel and no rows padding. Extra padding
+        // keeps empty border for shader taps reaching outside of glyph.
+        GLboolean addGlyph(const GlyphKey &key, const GLubyte *bitmap,
+            const glm::ivec2 &size, const glm::ivec2 &bearing, GLint advance,
+            Glyph &glyph, GLint extra_padding = 0);
+
+        TexturePtr getPageTexture(GLint page) const
+        {
+            return pages_[page].texture;
+        }
+
+        GLint createPage();
+        GLint getPageForGlyph(GLint width, GLint height, glm::ivec2 &position);
+        GLboolean packGlyph(Page &page, GLint width, GLint height,
+            glm::ivec2 &position) const;
+        GLint evictLeastRecentlyUsedPage();
+
+        std::string name_{"core_glyph_atlas"};
+
+        MasterManagerPtr master_manager_{nullptr};
+
+        // Empty border around every glyph, so filtering does not take
+        // texels of neighbours
+        static constexpr GLint glyph_padding_{1};
+
+        GLint page_size_{512};
+        GLint max_pages_count_{4};
+        GLuint frame_index_{0};
+        GLuint generation_{0};
+
+        std::vector<Page> pages_;
+        std::unordered_map<GlyphKey, Glyph, GlyphKeyHash> glyphs_;
+    };
+
+    using GlyphAtlasPtr = std::shared_ptr<GlyphAtlas>;
+} // namespace puffin
+
+#endif // PUFFIN_GLYPH_ATLAS_H
\ No newline at end of file
@@ -8,17 +8,26 @@
 
 #include <GL/glew.h>
 
+#include <condition_variable>
+#include <exception>
 #include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "Puffin/Camera/Camera.h"
+#include "Puffin/Common/JobSystem.h"
 #include "Puffin/Configuration/StateMachine.h"
 #include "Puffin/Display/Display.h"
 #include "Puffin/Display/DisplayConfiguration.h"
 #include "Puffin/Manager/MasterManager.h"
 #include "Puffin/Mesh/Scene.h"
 #include "Puffin/Renderer/Fog.h"
+#include "Puffin/Renderer/DynamicResolution.h"
+#include "Puffin/Renderer/FixedTimestep.h"
 #include "Puffin/Renderer/FontRenderer.h"
 #include "Puffin/Renderer/FpsCounter.h"
+#include "Puffin/Renderer/FrameSnapshot.h"
 #include "Puffin/Renderer/Object3DRenderer.h"
 #include "Puffin/Renderer/ParticleRenderer.h"
 #include "Puffin/Renderer/PolygonMode.h"
@@ -35,7 +44,8 @@ namespace puffin
     public:
         MasterRenderer(MasterManagerPtr master_manager,
             StateMachinePtr state_machine, DisplayPtr display,
-            DisplayConfigurationPtr display_configuration);
+            DisplayConfigurationPtr display_configuration,
+            JobSystemPtr job_system);
         virtual ~MasterRenderer();
 
         GLboolean isRenderingEnabled() const
@@ -46,7 +56,50 @@ namespace puffin
         void start();
         void stop();
         void assignRenderingFunction(std::function<void()> function);
+        // Called with fixed time step, possibly several times per frame.
+        // Once it is assigned, objects should be moved only here, because
+        // rendering blends their transforms between two last steps.
+        void assignSimulationFunction(std::function<void(GLdouble)> function);
 
+        // Rendering runs on separate thread, which owns OpenGL context and
+        // draws snapshot of scene made after every simulation. Rendering
+        // function is not called in this mode, scene set by useScene() is
+        // drawn instead. Has to be set before start().
+        // Main thread has no OpenGL context while render thread runs, so
+        // creating meshes, loading textures, requesting shaders and
+        // measuring texts must be passed to runOnRenderThread(). Results
+        // can be handed back with JobSystem::scheduleOnMainThread().
+        // Snapshot holds camera, lights, texts and object transforms only.
+        // Fog, polygon mode, shadow map configuration, postprocess and
+        // dynamic resolution are read by render thread directly, so they
+        // also have to be changed through runOnRenderThread(). The same
+        // applies to water tiles and particle systems, which render thread
+        // draws and animates live.
+        // Exception thrown while rendering stops rendering and is rethrown
+        // from start().
+        void enableRenderThread(GLboolean state);
+
+        GLboolean isRenderThreadEnabled() const
+        {
+            return render_thread_enabled_;
+        }
+
+        // Function is called by render thread before it draws next
+        // snapshot, or immediately if render thread does not run
+        void runOnRenderThread(std::function<void()> function);
+
+        // Scene simulated and drawn by render thread
+        void useScene(ScenePtr scene)
+        {
+            if (!scene)
+                logErrorAndThrow(name_, "MasterRenderer::useScene()",
+                    "Object [Scene] pointer not set.");
+
+            used_scene_ = scene;
+        }
+
+        // Objects below are used by renderers. With render thread enabled
+        // they are changed only through runOnRenderThread().
         PostprocessRendererPtr postprocessRenderer() const
         {
             return postprocess_renderer_;
@@ -62,11 +115,21 @@ namespace puffin
             return fps_counter_;
         }
 
+        FixedTimestepPtr fixedTimestep() const
+        {
+            return fixed_timestep_;
+        }
+
         FogPtr fog() const
         {
             return fog_;
         }
 
+        DynamicResolutionPtr dynamicResolution() const
+        {
+            return dynamic_resolution_;
+        }
+
         PolygonModePtr polygonMode() const
         {
             return polygon_mode_;
@@ -77,6 +140,21 @@ namespace puffin
             return shadow_map_;
         }
 
+        ShadowMapRendererPtr shadowMapRenderer() const
+        {
+            return shadow_map_renderer_;
+        }
+
+        FontRendererPtr fontRenderer() const
+        {
+            return font_renderer_;
+        }
+
+        ClusteredLightingPtr clusteredLighting() const
+        {
+            return model3d_renderer_->clusteredLighting();
+        }
+
         void useCamera(CameraPtr camera)
         {
             if (!camera)
@@ -85,17 +163,39 @@ namespace puffin
 
             active_camera_ = camera;
 
-            model3d_renderer_->useCamera(active_camera_);
-            skybox_renderer_->useCamera(active_camera_);
-            shadow_map_renderer_->useCamera(active_camera_);
-            water_renderer_->useCamera(active_camera_);
-            particle_renderer_->useCamera(active_camera_);
+            // Render thread uses camera from snapshot
+            if (!render_thread_.joinable())
+                useRenderCamera(active_camera_);
         }
 
+        // Scene drawn last is updated by simulation steps
         void drawScene(ScenePtr scene);
 
     protected:
         void createScreenModel();
+        void simulate(GLdouble delta);
+        void interpolate(GLfloat alpha);
+        void renderScene(ScenePtr scene);
+        void updateRenderTransforms(ScenePtr scene);
+
+        void useRenderCamera(CameraPtr camera)
+        {
+            render_camera_ = camera;
+
+            model3d_renderer_->useCamera(render_camera_);
+            skybox_renderer_->useCamera(render_camera_);
+            shadow_map_renderer_->useCamera(render_camera_);
+            water_renderer_->useCamera(render_camera_);
+            particle_renderer_->useCamera(render_camera_);
+        }
+
+        void startWithRenderThread();
+        void stopRenderThread();
+        void renderThreadLoop();
+        void runRenderThreadJobs();
+        GLboolean submitSnapshot(GLdouble delta);
+        void captureSnapshot(FrameSnapshotPtr snapshot, GLdouble delta);
+        void renderSnapshot(FrameSnapshotPtr snapshot);
 
         void clear()
         {
@@ -104,26 +204,45 @@ namespace puffin
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT |
                 GL_STENCIL_BUFFER_BIT);
 
-            glViewport(0, 0, display_configuration_->getWidth(),
-                display_configuration_->getHeight());
+            state_machine_->setViewport(0, 0, display_configuration_->
+                getWidth(), display_configuration_->getHeight());
         }
 
         std::string name_{"core_master_renderer"};
 
         GLboolean rendering_enabled_{false};
         std::function<void()> rendering_function_{nullptr};
+        std::function<void(GLdouble)> simulation_function_{nullptr};
 
         MasterManagerPtr master_manager_{nullptr};
         StateMachinePtr state_machine_{nullptr};
         DisplayPtr target_display_{nullptr};
         DisplayConfigurationPtr display_configuration_{nullptr};
+        JobSystemPtr job_system_{nullptr};
 
+        DynamicResolutionPtr dynamic_resolution_{nullptr};
         FogPtr fog_{nullptr};
         FpsCounterPtr fps_counter_{nullptr};
+        FixedTimestepPtr fixed_timestep_{nullptr};
+        ScenePtr simulated_scene_{nullptr};
         PolygonModePtr polygon_mode_{nullptr};
         ShadowMapConfigurationPtr shadow_map_{nullptr};
 
+        // Render thread takes ready snapshot, simulation fills free one
+        GLboolean render_thread_enabled_{false};
+        GLboolean render_thread_running_{false};
+        ScenePtr used_scene_{nullptr};
+        std::thread render_thread_;
+        std::mutex snapshot_mutex_;
+        std::condition_variable snapshot_condition_;
+        std::vector<FrameSnapshotPtr> free_snapshots_;
+        FrameSnapshotPtr ready_snapshot_{nullptr};
+        GLuint64 snapshots_count_{0};
+        std::vector<std::function<void()>> render_thread_jobs_;
+        std::exception_ptr render_thread_exception_{nullptr};
+
         CameraPtr active_camera_{nullptr};
+        CameraPtr render_camera_{nullptr};
         Object3DPtr screen_{nullptr};
 
         FontRendererPtr font_renderer_{nullptr};
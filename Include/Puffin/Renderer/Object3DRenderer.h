@@ -6,13 +6,20 @@
 #ifndef PUFFIN_OBJECT_3D_RENDERER_H
 #define PUFFIN_OBJECT_3D_RENDERER_H
 
+#include <cstdint>
+#include <vector>
+
+#include "Puffin/Common/GpuTimer.h"
+#include "Puffin/Common/JobSystem.h"
 #include "Puffin/Configuration/ShadowMapConfiguration.h"
 #include "Puffin/Configuration/StateMachine.h"
 #include "Puffin/Display/DisplayConfiguration.h"
 #include "Puffin/Manager/MasterManager.h"
 #include "Puffin/Renderer/BaseRenderer.h"
+#include "Puffin/Renderer/ClusteredLighting.h"
 #include "Puffin/Renderer/Fog.h"
 #include "Puffin/Renderer/PolygonMode.h"
+#include "Puffin/Renderer/RenderCommandBuffer.h"
 #include "Puffin/Renderer/StencilBuffer.h"
 
 namespace puffin
@@ -28,7 +35,7 @@ namespace puffin
             StateMachinePtr state_machine,
             DisplayConfigurationPtr display_configuration,
             ShadowMapConfigurationPtr shadow_map_configuration, FogPtr fog,
-            PolygonModePtr polygon_mode);
+            PolygonModePtr polygon_mode, JobSystemPtr job_system);
         virtual ~Object3DRenderer();
 
         void enableFullRender(GLboolean enable)
@@ -36,18 +43,72 @@ namespace puffin
             full_render_ = enable;
         }
 
+        ClusteredLightingPtr clusteredLighting() const
+        {
+            return clustered_lighting_;
+        }
+
+        // Averaged GPU time of main objects pass in milliseconds
+        GLdouble getRenderTime() const
+        {
+            return render_timer_->getAverageElapsedTime();
+        }
+
+        // Commands executed by last pass
+        GLuint getCommandsCount() const
+        {
+            return command_buffer_.getCommandsCount();
+        }
+
     protected:
+        // Bits of basic shader's features mask, in the same order as
+        // features of basic shader variants
+        enum BasicShaderFeature : GLuint
+        {
+            FEATURE_LIGHTING = 1 << 0,
+            FEATURE_SHADOWS = 1 << 1,
+            FEATURE_FOG = 1 << 2,
+            FEATURE_DIFFUSE_TEXTURE = 1 << 3,
+            FEATURE_NORMALMAP_TEXTURE = 1 << 4,
+        };
+
+        // Passes of command buffer, executed in this order. Outlined objects
+        // mark stencil buffer, so outlines are drawn only around them.
+        enum CommandPass : GLuint
+        {
+            COMMAND_PASS_OPAQUE,
+            COMMAND_PASS_OUTLINED,
+            COMMAND_PASS_OUTLINE,
+        };
+
         void render(ScenePtr scene);
+        void render(ScenePtr scene,
+            const std::vector<Object3DPtr> &objects_3d);
         void render(ScenePtr scene, ShaderProgramPtr shader_program);
+        void render(const std::vector<Object3DPtr> &objects,
+            ShaderProgramPtr shader_program);
+        void renderDepth(Object3DPtr object, ShaderProgramPtr shader_program,
+            GLint instances_count = 1);
 
-        void renderObject3D(Object3DPtr object3d);
-        void renderObject3DEntities(Object3DPtr object3d,
-            ShaderProgramPtr shader_program, GLboolean use_materials);
+        void renderPolygonMode(Object3DPtr object3d);
+        void renderObject3DEntities(Object3DPtr object3d);
+        void renderOutline(Object3DPtr object3d, GLboolean activate_shader);
+
+        void buildCommands(const std::vector<Object3DPtr> &objects_3d);
+        void addObjectCommands(RenderCommandBuffer &command_buffer,
+            Object3DPtr object3d, GLuint object_index, GLuint frame_features,
+            const glm::vec3 &camera_position) const;
+        void executeCommands(const std::vector<Object3DPtr> &objects_3d);
+        void beginCommandPass(GLuint pass);
+        void endCommandPasses();
+
+        GLuint getFrameFeatures() const;
+        GLuint getMaterialFeatures(MaterialPtr material,
+            GLuint frame_features) const;
 
         void loadShaders();
         void prepareRendering();
-        void setCameraMatricesUniforms(ShaderProgramPtr shader_program,
-            Object3DPtr object3d);
+        void setCameraMatricesUniforms(ShaderProgramPtr shader_program);
         void setFogUniforms(ShaderProgramPtr shader_program);
         void setOutlineUniforms(ShaderProgramPtr shader_program,
             OutlinePtr outline);
@@ -55,14 +116,21 @@ namespace puffin
         void setLightsUniforms(ShaderProgramPtr shader_program);
         void setEnvironmentMapUniforms(ShaderProgramPtr shader_program);
         void setShadowMapUniforms(ShaderProgramPtr shader_program);
+        void setBasicShaderUniforms(ShaderProgramPtr shader_program,
+            GLuint features);
         void setMaterials(Object3DPtr object3d, GLuint entity_index,
-            ShaderProgramPtr shader_program);
+            ShaderProgramPtr shader_program, GLuint features);
 
         void setClippingDistance(const glm::vec4 &plane)
         {
             clip_plane_ = plane;
         }
 
+        void setTextureLodBias(GLfloat bias)
+        {
+            texture_lod_bias_ = bias;
+        }
+
         GLboolean full_render_{true};
 
         DisplayConfigurationPtr display_configuration_{nullptr};
@@ -72,16 +140,31 @@ namespace puffin
         ShadowMapConfigurationPtr shadow_map_{nullptr};
         StateMachinePtr state_machine_{nullptr};
         StencilBufferPtr stencil_buffer_{nullptr};
+        ClusteredLightingPtr clustered_lighting_{nullptr};
+        GpuTimerPtr render_timer_{nullptr};
+        JobSystemPtr job_system_{nullptr};
 
-        ShaderProgramPtr basic_shader_{nullptr};
+        // Commands are built by batches of objects in parallel, every batch
+        // has its own buffer. They are merged into one sorted buffer.
+        static constexpr GLuint commands_batch_size_{64};
+        std::vector<RenderCommandBuffer> batch_command_buffers_;
+        RenderCommandBuffer command_buffer_;
+
+        ShaderVariantsPtr basic_shader_variants_{nullptr};
         ShaderProgramPtr outline_shader_{nullptr};
         ShaderProgramPtr polygon_mode_shader_{nullptr};
 
         SkyboxPtr active_skybox_{nullptr};
         TexturePtr shadow_map_texture_{nullptr};
-        std::vector<TexturePtr> point_light_shadow_maps_;
+        TexturePtr point_shadow_atlas_texture_{nullptr};
+        std::vector<glm::vec3> point_shadow_tiles_;
+
+        std::vector<glm::mat4> shadow_cascade_matrices_;
+        std::vector<GLfloat> shadow_cascade_distances_;
+        std::vector<GLfloat> shadow_cascade_scales_;
 
         glm::vec4 clip_plane_{0.0f, 0.0f, 0.0f, 0.0f};
+        GLfloat texture_lod_bias_{0.0f};
     };
 
     using Object3DRendererPtr = std::shared_ptr<Object3DRenderer>;
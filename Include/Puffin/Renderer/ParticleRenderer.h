@@ -11,7 +11,6 @@
 #include "Puffin/Manager/MasterManager.h"
 #include "Puffin/Mesh/Particle.h"
 #include "Puffin/Renderer/BaseRenderer.h"
-#include "Puffin/Renderer/FpsCounter.h"
 
 namespace puffin
 {
@@ -22,8 +21,7 @@ namespace puffin
     public:
         ParticleRenderer(MasterManagerPtr master_manager,
             StateMachinePtr state_machine,
-            DisplayConfigurationPtr display_configuration,
-            FpsCounterPtr fps_counter);
+            DisplayConfigurationPtr display_configuration);
         virtual ~ParticleRenderer();
 
     protected:
@@ -31,6 +29,7 @@ namespace puffin
         void createParticleModel();
 
         void render(ScenePtr scene);
+        void update(ScenePtr scene, GLdouble delta);
         void setCameraUniforms(ShaderProgramPtr shader_program);
 
         Object3DPtr particle_model_{nullptr};
@@ -39,7 +38,6 @@ namespace puffin
         DisplayConfigurationPtr display_configuration_{nullptr};
         MasterManagerPtr master_manager_{nullptr};
         StateMachinePtr state_machine_{nullptr};
-        FpsCounterPtr fps_counter_{nullptr};
     };
 
     using ParticleRendererPtr = std::shared_ptr<ParticleRenderer>;
@@ -10,13 +10,18 @@
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "Puffin/Common/Logger.h"
 #include "Puffin/Configuration/StateMachine.h"
 #include "Puffin/Display/DisplayConfiguration.h"
 #include "Puffin/Manager/FrameBufferManager.h"
 #include "Puffin/Manager/MasterManager.h"
+#include "Puffin/Mesh/Object3D.h"
 
 namespace puffin
 {
@@ -42,9 +47,33 @@ namespace puffin
             FrameBufferManagerPtr frame_buffer_manager);
         virtual ~PostprocessRenderer();
 
+        // Replaces whole effects chain with single effect
         void setEffect(PostprocessEffect effect)
         {
-            effect_ = effect;
+            clearEffects();
+            addEffect(effect);
+        }
+
+        // Effects are applied in order of adding. Half resolution effects
+        // are cheaper, result is upscaled by following pass.
+        void addEffect(PostprocessEffect effect,
+            GLboolean half_resolution = false)
+        {
+            // No-op effect does not need a pass
+            if (effect == PostprocessEffect::NONE)
+                return;
+
+            effects_.push_back(PostprocessPass{effect, half_resolution});
+        }
+
+        void clearEffects()
+        {
+            effects_.clear();
+        }
+
+        GLuint getEffectsCount() const
+        {
+            return static_cast<GLuint>(effects_.size());
         }
 
         void setKernelSize(GLfloat size)
@@ -74,26 +103,91 @@ namespace puffin
         }
 
     protected:
+        struct PostprocessPass
+        {
+            PostprocessEffect effect;
+            GLboolean half_resolution;
+        };
+
+        // Frame buffer not set means window
+        struct PostprocessImage
+        {
+            FrameBufferPtr frame_buffer;
+            GLboolean half_resolution;
+        };
+
         void loadShaders();
-        void setShaderUniforms();
         void createFrameBuffers();
-
+        void render(Object3DPtr screen);
+        void renderPass(ShaderProgramPtr shader_program,
+            const PostprocessImage &input, const PostprocessImage &output,
+            Object3DPtr screen);
+        void setEffectUniforms(ShaderProgramPtr shader_program,
+            PostprocessEffect effect);
+
+        PostprocessImage acquireTarget(GLboolean half_resolution,
+            const PostprocessImage &input);
         FrameBufferPtr getFrameBufferToRender() const;
 
+        // Frame buffers keep display size, scene uses only part of them
+        void setRenderScale(GLfloat scale)
+        {
+            render_scale_ = scale;
+        }
+
+        GLint getRenderWidth() const
+        {
+            return std::max(1, static_cast<GLint>(
+                display_configuration_->getWidth() * render_scale_));
+        }
+
+        GLint getRenderHeight() const
+        {
+            return std::max(1, static_cast<GLint>(
+                display_configuration_->getHeight() * render_scale_));
+        }
+
+        // Without effects, scaling and FXAA, scene can be rendered straight
+        // to the multisampled window, so no resolve or copy pass is needed
+        GLboolean canRenderDirectly() const
+        {
+            return effects_.empty() &&
+                display_configuration_->isMultisamplingEnabled() &&
+                getRenderWidth() == display_configuration_->getWidth() &&
+                getRenderHeight() == display_configuration_->getHeight();
+        }
+
+        // Size of image part used by scene
+        glm::ivec2 getImageSize(const PostprocessImage &image) const;
+        // Size of image's whole texture
+        glm::ivec2 getImageTextureSize(const PostprocessImage &image) const;
+        // Fraction of image's texture used by scene
+        glm::vec2 getImageUvScale(const PostprocessImage &image) const;
+
         std::string name_{"core_postprocess_renderer"};
 
         DisplayConfigurationPtr display_configuration_{nullptr};
         FrameBufferManagerPtr frame_buffer_manager_{nullptr};
         MasterManagerPtr master_manager_{nullptr};
-        ShaderProgramPtr shader_program_{nullptr};
+        ShaderProgramPtr copy_shader_{nullptr};
+        ShaderProgramPtr blur_shader_{nullptr};
+        ShaderProgramPtr fxaa_shader_{nullptr};
+        std::map<PostprocessEffect, ShaderProgramPtr> effect_shaders_;
         StateMachinePtr state_machine_{nullptr};
 
+        // Single sampled when FXAA is used, resolve target is created only
+        // for multisampled one
         FrameBufferPtr frame_buffer_multisample_{nullptr};
         FrameBufferPtr frame_buffer_simple_{nullptr};
 
-        PostprocessEffect effect_{PostprocessEffect::NONE};
+        // Ping-pong targets, created when chain needs them
+        std::vector<PostprocessImage> targets_pool_;
+
+        std::vector<PostprocessPass> effects_;
+
         GLfloat kernel_size_{300.0f};
         glm::vec3 tint_color_{1.0f, 1.0f, 1.0f};
+        GLfloat render_scale_{1.0f};
     };
 
     using PostprocessRendererPtr = std::shared_ptr<PostprocessRenderer>;
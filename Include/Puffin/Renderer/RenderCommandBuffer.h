@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#ifndef PUFFIN_RENDER_COMMAND_BUFFER_H
+#define PUFFIN_RENDER_COMMAND_BUFFER_H
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "Puffin/Common/Logger.h"
+
+namespace puffin
+{
+    // Draw of one entity. Commands refer to objects by index, so they can be
+    // built on any thread without touching OpenGL.
+    struct RenderCommand
+    {
+        GLuint64 key{0};
+        GLuint object_index{0};
+        GLuint entity_index{0};
+        GLuint features{0};
+    };
+
+    // Commands are executed in order of their keys, so draws sharing state
+    // are submitted together
+    class RenderCommandBuffer
+    {
+    public:
+        // Fields of sort key, from the most significant one
+        static constexpr GLuint pass_bits{4};
+        static constexpr GLuint shader_bits{12};
+        static constexpr GLuint material_bits{16};
+        static constexpr GLuint depth_bits{16};
+        static constexpr GLuint object_bits{16};
+
+        // Values wider than their fields are truncated, which only makes
+        // sorting less exact. Depth is in range [0.0, 1.0], object keeps
+        // entities of objects at equal depth together.
+        static GLuint64 makeKey(GLuint pass, GLuint shader, GLuint material,
+            GLfloat depth, GLuint object)
+        {
+            GLuint64 depth_value = static_cast<GLuint64>(std::min(std::max(
+                depth, 0.0f), 1.0f) * ((1 << depth_bits) - 1));
+
+            GLuint64 key = pass & ((1 << pass_bits) - 1);
+            key = (key << shader_bits) | (shader & ((1 << shader_bits) - 1));
+            key = (key << material_bits) | (material &
+                ((1 << material_bits) - 1));
+            key = (key << depth_bits) | depth_value;
+            key = (key << object_bits) | (object & ((1 << object_bits) - 1));
+            return key;
+        }
+
+        static GLuint getPass(GLuint64 key)
+        {
+            return static_cast<GLuint>(key >> (64 - pass_bits));
+        }
+
+        void add(const RenderCommand &command)
+        {
+            commands_.push_back(command);
+        }
+
+        void append(const RenderCommandBuffer &buffer)
+        {
+            commands_.insert(commands_.end(), buffer.commands_.begin(),
+                buffer.commands_.end());
+        }
+
+        void clear()
+        {
+            commands_.clear();
+        }
+
+        GLuint getCommandsCount() const
+        {
+            return static_cast<GLuint>(commands_.size());
+        }
+
+        const std::vector<RenderCommand>& getCommands() const
+        {
+            return commands_;
+        }
+
+        void sort();
+
+    protected:
+        std::vector<RenderCommand> commands_;
+        std::vector<RenderCommand> sorted_commands_;
+    };
+
+    using RenderCommandBufferPtr = std::shared_ptr<RenderCommandBuffer>;
+} // namespace puffin
+
+#endif // PUFFIN_RENDER_COMMAND_BUFFER_H
\ No newline at end of file
@@ -10,9 +10,14 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <memory>
 #include <vector>
 
+#include "Puffin/Camera/Frustum.h"
+#include "Puffin/Common/GpuTimer.h"
 #include "Puffin/Configuration/ShadowMapConfiguration.h"
 #include "Puffin/Configuration/StateMachine.h"
 #include "Puffin/Display/DisplayConfiguration.h"
@@ -33,17 +38,135 @@ namespace puffin
             ShadowMapConfigurationPtr shadow_map_configuration);
         virtual ~ShadowMapRenderer();
 
+        // Mode used by last frame, after automatic selection and fallbacks
+        PointShadowRenderMode getActivePointShadowRenderMode() const
+        {
+            return active_point_shadow_render_mode_;
+        }
+
+        // Averaged GPU time of point lights shadow pass in milliseconds.
+        // Render modes are compared by switching them with
+        // ShadowMapConfiguration::setPointShadowRenderMode() on scene with
+        // moving casters, because cached shadow maps are not redrawn.
+        GLdouble getPointLightsRenderTime() const
+        {
+            return point_lights_timer_->getAverageElapsedTime();
+        }
+
     protected:
+        struct CasterState
+        {
+            Object3DPtr object;
+            glm::mat4 model_matrix;
+            glm::vec3 center;
+            GLfloat radius;
+
+            bool operator==(const CasterState &other) const
+            {
+                return object == other.object &&
+                    model_matrix == other.model_matrix;
+            }
+
+            bool operator!=(const CasterState &other) const
+            {
+                return !(*this == other);
+            }
+        };
+
+        // Light space region covered by cascade. Center and radius are in
+        // light's view space.
+        struct CascadeCache
+        {
+            GLboolean valid{false};
+            GLint map_size{0};
+            glm::vec3 direction{0.0f, 0.0f, 0.0f};
+            GLfloat casters_distance{0.0f};
+            glm::vec3 center{0.0f, 0.0f, 0.0f};
+            GLfloat radius{0.0f};
+            glm::mat4 matrix{1.0f};
+        };
+
+        // Block of six cube face tiles inside of point lights atlas. Size of
+        // zero means that light has no shadow this frame.
+        struct PointLightTile
+        {
+            GLint x{0};
+            GLint y{0};
+            GLint size{0};
+
+            bool operator==(const PointLightTile &other) const
+            {
+                return x == other.x && y == other.y && size == other.size;
+            }
+
+            bool operator!=(const PointLightTile &other) const
+            {
+                return !(*this == other);
+            }
+        };
+
+        struct PointLightCache
+        {
+            GLboolean valid{false};
+            glm::vec3 position{0.0f, 0.0f, 0.0f};
+            GLfloat shadow_distance{0.0f};
+            PointLightTile tile;
+            std::array<std::vector<CasterState>, 6> face_casters;
+        };
+
         void loadShaders();
         void createFrameBufferDirectionalLight();
         void createFrameBufferPointLights();
 
         void render(ScenePtr scene);
-        void renderDirectionalLight(ScenePtr scene);
-        void renderPointLights(ScenePtr scene);
+        void renderDirectionalLight();
+        void renderPointLights();
+
+        void collectCasters(ScenePtr scene);
+        std::vector<Object3DPtr> getCasterObjects(
+            const std::vector<CasterState> &casters) const;
+        void copyCascadeFromCache(GLint cascade_index);
+        void clearPointLightFaces(const PointLightTile &tile,
+            GLint faces_mask);
+
+        GLint calculatePointLightTileSize(const glm::vec3 &light_position,
+            const Frustum &camera_frustum) const;
+        std::vector<PointLightTile> packPointLightTiles(
+            std::vector<GLint> tile_sizes, GLint atlas_size) const;
+        glm::ivec2 getPointLightFaceOrigin(const PointLightTile &tile,
+            GLint face) const;
+
+        void resolvePointShadowRenderMode();
+        GLboolean isViewportArraySupported() const;
+        GLboolean isVertexViewportSupported() const;
+        void setPointLightViewports(const PointLightTile &tile);
+        void renderPointLightGeometryShader(const PointLightTile &tile,
+            const glm::vec3 &light_position,
+            const std::vector<glm::mat4> &shadow_transforms,
+            const std::vector<Object3DPtr> &objects,
+            const std::vector<GLint> &objects_faces);
+        void renderPointLightVertexViewport(const PointLightTile &tile,
+            const glm::vec3 &light_position,
+            const std::vector<glm::mat4> &shadow_transforms,
+            const std::vector<Object3DPtr> &objects,
+            const std::vector<GLint> &objects_faces);
+        void renderPointLightSingleFace(const PointLightTile &tile,
+            const glm::vec3 &light_position,
+            const std::vector<glm::mat4> &shadow_transforms,
+            const std::vector<Object3DPtr> &objects,
+            const std::vector<GLint> &objects_faces);
+        void setPointLightUniforms(ShaderProgramPtr shader_program,
+            const glm::vec3 &light_position);
+
+        void calculateCascadeSplits();
+        GLboolean updateCascadeRegion(CascadeCache &cache,
+            const glm::vec3 &light_direction, GLfloat distance_near,
+            GLfloat distance_far, GLint map_size) const;
 
         ShaderProgramPtr depth_map_directional_shader_{nullptr};
         ShaderProgramPtr depth_map_point_shader_{nullptr};
+        ShaderProgramPtr depth_map_point_viewport_shader_{nullptr};
+        ShaderProgramPtr depth_map_point_face_shader_{nullptr};
 
         MasterManagerPtr master_manager_{nullptr};
         Object3DRendererPtr object3d_renderer_{nullptr};
@@ -51,9 +174,25 @@ namespace puffin
         StateMachinePtr state_machine_{nullptr};
 
         FrameBufferPtr dir_light_frame_buffer_{nullptr};
-        std::vector<FrameBufferPtr> point_light_frame_buffer_container_;
+        FrameBufferPtr dir_light_cache_frame_buffer_{nullptr};
+        FrameBufferPtr point_light_frame_buffer_{nullptr};
+
+        // Shadow maps are redrawn only when casters or lights change
+        std::vector<CasterState> static_casters_;
+        std::vector<CasterState> dynamic_casters_;
+        GLboolean static_casters_changed_{true};
+        GLboolean dynamic_casters_changed_{true};
+
+        std::vector<CascadeCache> cascade_cache_;
+        std::vector<PointLightCache> point_light_cache_;
+
+        std::vector<GLfloat> cascade_distances_;
 
         glm::mat4 pl_projection_matrix_{1.0f};
+
+        PointShadowRenderMode active_point_shadow_render_mode_{
+            PointShadowRenderMode::AUTOMATIC};
+        GpuTimerPtr point_lights_timer_{nullptr};
     };
 
     using ShadowMapRendererPtr = std::shared_ptr<ShadowMapRenderer>;
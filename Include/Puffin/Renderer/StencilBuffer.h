@@ -22,6 +22,8 @@ namespace puffin
 
     class StencilBuffer
     {
+        friend class StateMachine;
+
     public:
         StencilBuffer()
         {
@@ -34,6 +36,16 @@ namespace puffin
             else
                 drawing_enabled_ = false;
 
+            glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, &value);
+            if (value == GL_REPLACE)
+                action_ = StencilBufferAction::REPLACE;
+            else
+                action_ = StencilBufferAction::KEEP;
+
+            glGetIntegerv(GL_STENCIL_FUNC, &value);
+            function_ = static_cast<GLenum>(value);
+            glGetIntegerv(GL_STENCIL_REF, &reference_value_);
+
             logDebug(name_, "StencilBuffer::StencilBuffer()",
                 "Stencil buffer created.");
         }
@@ -47,7 +59,10 @@ namespace puffin
         void enable(GLboolean state)
         {
             if (state == enabled_)
+            {
+                redundant_calls_++;
                 return;
+            }
 
             if (state)
                 glEnable(GL_STENCIL_TEST);
@@ -64,6 +79,12 @@ namespace puffin
 
         void enableDrawing(GLboolean state)
         {
+            if (state == drawing_enabled_)
+            {
+                redundant_calls_++;
+                return;
+            }
+
             glStencilMask(state ? 0xFF : 0x00);
             drawing_enabled_ = state;
         }
@@ -73,8 +94,14 @@ namespace puffin
             return drawing_enabled_;
         }
 
-        void setAction(StencilBufferAction action) const
+        void setAction(StencilBufferAction action)
         {
+            if (action == action_)
+            {
+                redundant_calls_++;
+                return;
+            }
+
             switch (action)
             {
             case StencilBufferAction::REPLACE:
@@ -83,23 +110,43 @@ namespace puffin
             case StencilBufferAction::KEEP:
                 glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
             }
+
+            action_ = action;
         }
 
-        void passesAlways(GLint value) const
+        void passesAlways(GLint value)
         {
-            glStencilFunc(GL_ALWAYS, value, 0xFF);
+            setFunction(GL_ALWAYS, value);
         }
 
-        void passesNotEqual(GLint value) const
+        void passesNotEqual(GLint value)
         {
-            glStencilFunc(GL_NOTEQUAL, value, 0xFF);
+            setFunction(GL_NOTEQUAL, value);
         }
 
     protected:
+        void setFunction(GLenum function, GLint value)
+        {
+            if (function == function_ && value == reference_value_)
+            {
+                redundant_calls_++;
+                return;
+            }
+
+            glStencilFunc(function, value, 0xFF);
+            function_ = function;
+            reference_value_ = value;
+        }
+
         std::string name_{"core_stencil_buffer"};
 
+        GLuint redundant_calls_{0};
+
         GLboolean drawing_enabled_{false};
         GLboolean enabled_{false};
+        StencilBufferAction action_{StencilBufferAction::KEEP};
+        GLenum function_{GL_ALWAYS};
+        GLint reference_value_{0};
     };
 
     using StencilBufferPtr = std::shared_ptr<StencilBuffer>;
@@ -8,15 +8,17 @@
 
 #include <GL/glew.h>
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "Puffin/Camera/Frustum.h"
 #include "Puffin/Configuration/StateMachine.h"
 #include "Puffin/Display/DisplayConfiguration.h"
 #include "Puffin/Manager/MasterManager.h"
 #include "Puffin/Renderer/BaseRenderer.h"
-#include "Puffin/Renderer/FpsCounter.h"
 #include "Puffin/Renderer/Fog.h"
 #include "Puffin/Renderer/Object3DRenderer.h"
 #include "Puffin/Renderer/SkyboxRenderer.h"
@@ -31,42 +33,121 @@ namespace puffin
         WaterRenderer(MasterManagerPtr master_manager,
             StateMachinePtr state_machine,
             DisplayConfigurationPtr display_configuration, FogPtr fog,
-            FpsCounterPtr fps_counter, Object3DRendererPtr model3d_renderer,
+            Object3DRendererPtr model3d_renderer,
             SkyboxRendererPtr skybox_renderer);
         virtual ~WaterRenderer();
 
         void setReflectionResolution(GLint width, GLint height);
         void setRefractionResolution(GLint width, GLint height);
 
+        // Textures are rendered once per given number of frames, meanwhile
+        // water reprojects them using matrices of the frame they come from
+        void setReflectionUpdateInterval(GLint frames);
+
+        GLint getReflectionUpdateInterval() const
+        {
+            return reflection_update_interval_;
+        }
+
+        void setRefractionUpdateInterval(GLint frames);
+
+        GLint getRefractionUpdateInterval() const
+        {
+            return refraction_update_interval_;
+        }
+
+        // Mipmap bias of objects' textures in reflection
+        void setReflectionLodBias(GLfloat bias);
+
+        GLfloat getReflectionLodBias() const
+        {
+            return reflection_lod_bias_;
+        }
+
     protected:
+        // Visible tiles placed at the same height share reflection and
+        // refraction textures
+        struct WaterGroup
+        {
+            GLfloat water_level{0.0f};
+            std::vector<WaterTilePtr> visible_tiles;
+        };
+
+        struct WaterFrameBuffers
+        {
+            FrameBufferPtr reflection{nullptr};
+            FrameBufferPtr refraction{nullptr};
+
+            GLboolean valid{false};
+            GLfloat water_level{0.0f};
+            GLint reflection_age{0};
+            GLint refraction_age{0};
+            glm::mat4 reflection_matrix{1.0f};
+            glm::mat4 refraction_matrix{1.0f};
+        };
+
         void render(ScenePtr scene);
+        void update(ScenePtr scene, GLdouble delta);
         void renderToFrameBuffers(ScenePtr scene);
-        void renderReflectionTexture(WaterTilePtr water_tile, ScenePtr scene);
-        void renderRefractionTexture(WaterTilePtr water_tile, ScenePtr scene);
+        void renderReflectionTexture(GLfloat water_level,
+            WaterFrameBuffers &frame_buffers, ScenePtr scene);
+        void renderRefractionTexture(GLfloat water_level,
+            WaterFrameBuffers &frame_buffers, ScenePtr scene);
+        void renderWaterGroup(const WaterGroup &group,
+            const WaterFrameBuffers &frame_buffers);
+
+        void groupWaterTiles(const std::vector<WaterTilePtr> &water_tiles);
+        void updateMoveFactors(const std::vector<WaterTilePtr> &water_tiles,
+            GLdouble delta);
+        GLboolean canBatchTiles(WaterTilePtr first, WaterTilePtr second) const;
+        std::vector<Object3DPtr> getClippedObjects(ScenePtr scene,
+            const glm::vec4 &clip_plane) const;
 
         void loadShaders();
-        void createFrameBuffers();
+        WaterFrameBuffers createFrameBuffers(GLuint index);
         void clearFrameBuffer(GLint width, GLint height) const;
-        void setTextureUniforms(ShaderProgramPtr shader_program,
-            WaterTilePtr water_tile);
-        void setCameraMatricesUniforms(ShaderProgramPtr shader_program,
-            WaterTilePtr water_tile);
+        void setTextureUniforms(ShaderProgramPtr shader_program);
+        void setFrameBufferUniforms(ShaderProgramPtr shader_program,
+            const WaterFrameBuffers &frame_buffers);
+        void bindWaterTileTextures(WaterTilePtr water_tile);
+        void setCameraMatricesUniforms(ShaderProgramPtr shader_program);
         void setWaterTileUniforms(ShaderProgramPtr shader_program,
             WaterTilePtr water_tile);
+        void setInstancesUniforms(ShaderProgramPtr shader_program,
+            const std::vector<WaterTilePtr> &water_tiles);
         void setFogUniforms(ShaderProgramPtr shader_program);
         void setLightingUniforms(ShaderProgramPtr shader_program);
 
-        FrameBufferPtr reflection_frame_buffer_{nullptr};
-        FrameBufferPtr refraction_frame_buffer_{nullptr};
+        // Frame buffers are reused between frames, group with given index
+        // renders to frame buffers with the same index
+        std::vector<WaterFrameBuffers> frame_buffers_;
+        std::vector<WaterGroup> water_groups_;
         ShaderProgramPtr shader_program_{nullptr};
 
+        // Must match size of point lights array in water shaders
+        static constexpr GLuint max_point_lights_count_{4};
+        // Must match size of instance arrays in water vertex shader
+        static constexpr GLuint max_instances_count_{32};
+        // Tiles with water level difference below this value use the same
+        // reflection
+        static constexpr GLfloat water_level_epsilon_{0.001f};
+
+        static constexpr GLint reflection_texture_slot_{0};
+        static constexpr GLint refraction_texture_slot_{1};
+        static constexpr GLint dudv_texture_slot_{2};
+        static constexpr GLint normal_map_texture_slot_{3};
+        static constexpr GLint depth_map_texture_slot_{4};
+
         GLint reflection_width_{640};
         GLint reflection_height_{320};
         GLint refraction_width_{1280};
         GLint refraction_height_{720};
 
+        GLint reflection_update_interval_{1};
+        GLint refraction_update_interval_{1};
+        GLfloat reflection_lod_bias_{0.0f};
+
         DisplayConfigurationPtr display_configuration_{nullptr};
-        FpsCounterPtr fps_counter_{nullptr};
         FogPtr fog_{nullptr};
         MasterManagerPtr master_manager_{nullptr};
         Object3DRendererPtr model3d_renderer_{nullptr};
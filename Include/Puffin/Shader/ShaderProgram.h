@@ -9,7 +9,9 @@
 #include <GL/glew.h>
 
 #include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "Puffin/Common/Logger.h"
 
@@ -50,6 +52,13 @@ namespace puffin
         GLuint handle_gs_{0};
 
         std::unordered_map<std::string, GLint> uniforms_;
+
+        // Program was linked, but its status was not checked yet
+        GLboolean pending_{false};
+        // Failed program stays pending, so every use reports link error
+        GLboolean link_failed_{false};
+        std::vector<std::string> shader_files_;
+        std::string binary_path_;
     };
 
     using ShaderProgramPtr = std::shared_ptr<ShaderProgram>;
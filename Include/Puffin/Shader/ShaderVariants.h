@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#ifndef PUFFIN_SHADER_VARIANTS_H
+#define PUFFIN_SHADER_VARIANTS_H
+
+#include <GL/glew.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Puffin/Common/Logger.h"
+#include "Puffin/Shader/ShaderProgram.h"
+
+namespace puffin
+{
+    // Set of shader programs built from the same files. Every feature is
+    // enabled by one bit of features mask and compiled in as a define.
+    // Programs are created by shader manager when they are first used.
+    class ShaderVariants
+    {
+        friend class ShaderManager;
+
+    public:
+        ShaderVariants(std::string name, std::string vs_path,
+            std::string fs_path, std::string gs_path,
+            const std::vector<std::string> &features) : name_(name),
+            vs_path_(vs_path), fs_path_(fs_path), gs_path_(gs_path),
+            features_(features)
+        {
+            if (features_.size() > max_features_count_)
+                logErrorAndThrow(name_, "ShaderVariants::ShaderVariants()",
+                    "Features count value out of range: {VALUE <= 32}.");
+        }
+
+        std::string getName() const
+        {
+            return name_;
+        }
+
+        GLuint getFeaturesCount() const
+        {
+            return static_cast<GLuint>(features_.size());
+        }
+
+        // Count of variants compiled so far
+        GLuint getVariantsCount() const
+        {
+            return static_cast<GLuint>(programs_.size());
+        }
+
+    protected:
+        std::vector<std::string> getDefines(GLuint features_mask) const
+        {
+            std::vector<std::string> defines;
+            for (GLuint i = 0; i < features_.size(); i++)
+            {
+                if (features_mask & (1u << i))
+                    defines.push_back(features_[i]);
+            }
+
+            return defines;
+        }
+
+        ShaderProgramPtr getProgram(GLuint features_mask) const
+        {
+            auto program = programs_.find(features_mask);
+            if (program == programs_.end())
+                return nullptr;
+
+            return program->second;
+        }
+
+        static constexpr GLuint max_features_count_{32};
+
+        std::string name_{"unnamed_shader_variants"};
+
+        std::string vs_path_;
+        std::string fs_path_;
+        std::string gs_path_;
+        std::vector<std::string> features_;
+
+        std::unordered_map<GLuint, ShaderProgramPtr> programs_;
+    };
+
+    using ShaderVariantsPtr = std::shared_ptr<ShaderVariants>;
+} // namespace puffin
+
+#endif // PUFFIN_SHADER_VARIANTS_H
\ No newline at end of file
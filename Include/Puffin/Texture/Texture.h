@@ -66,6 +66,11 @@ namespace puffin
             return color_channels_;
         }
 
+        GLint getLayersCount() const
+        {
+            return layers_;
+        }
+
         TextureType getType() const
         {
             return type_;
@@ -77,10 +82,12 @@ namespace puffin
         GLint width_{0};
         GLint height_{0};
         GLint color_channels_{0};
+        GLint layers_{1};
         GLubyte *image_data_{nullptr};
         std::string path_{};
 
         GLuint handle_{0};
+        GLuint buffer_handle_{0};
         GLboolean has_mipmap_{false};
 
         TextureType type_{TextureType::TEXTURE_UNDEFINED};
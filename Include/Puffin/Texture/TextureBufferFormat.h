@@ -0,0 +1,19 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#ifndef PUFFIN_TEXTURE_BUFFER_FORMAT_H
+#define PUFFIN_TEXTURE_BUFFER_FORMAT_H
+
+namespace puffin
+{
+    enum class TextureBufferFormat
+    {
+        R32UI,
+        RG32UI,
+        RGBA32F,
+    };
+} // namespace puffin
+
+#endif // PUFFIN_TEXTURE_BUFFER_FORMAT_H
\ No newline at end of file
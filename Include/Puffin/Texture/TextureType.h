@@ -14,6 +14,8 @@ namespace puffin
         TEXTURE_CUBE,
         TEXTURE_2D,
         TEXTURE_2D_MULTISAMPLED,
+        TEXTURE_2D_ARRAY,
+        TEXTURE_BUFFER,
     };
 } // namespace puffin
 
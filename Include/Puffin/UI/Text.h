@@ -10,6 +10,13 @@
 
 namespace puffin
 {
+    enum class TextAlignment
+    {
+        LEFT,
+        CENTER,
+        RIGHT,
+    };
+
     class Text : public UiComponent
     {
     public:
@@ -34,6 +41,7 @@ namespace puffin
         void setText(std::wstring text)
         {
             text_ = text;
+            changeLayout();
         }
 
         std::wstring getText() const
@@ -72,6 +80,7 @@ namespace puffin
                     "Outline size value out of range: {0 <= VALUE}.");
 
             outline_size_ = size;
+            changeLayout();
         }
 
         GLint getOutlineSize() const
@@ -79,12 +88,142 @@ namespace puffin
             return outline_size_;
         }
 
+        // Glyphs are drawn from signed distance field, which serves every
+        // font size. Glow and shadow are available only in this mode.
+        void enableDistanceField(GLboolean state)
+        {
+            distance_field_enabled_ = state;
+            changeLayout();
+        }
+
+        GLboolean isDistanceFieldEnabled() const
+        {
+            return distance_field_enabled_;
+        }
+
+        void setGlowColor(const glm::vec3 &color)
+        {
+            glow_color_ = glm::vec3(glm::clamp(color.r, 0.0f, 1.0f),
+                glm::clamp(color.g, 0.0f, 1.0f),
+                glm::clamp(color.b, 0.0f, 1.0f));
+        }
+
+        glm::vec3 getGlowColor() const
+        {
+            return glow_color_;
+        }
+
+        // Size of zero disables glow
+        void setGlowSize(GLint size)
+        {
+            if (size < 0)
+                logErrorAndThrow(name_, "Text::setGlowSize()",
+                    "Glow size value out of range: {0 <= VALUE}.");
+
+            glow_size_ = size;
+        }
+
+        GLint getGlowSize() const
+        {
+            return glow_size_;
+        }
+
+        void enableShadow(GLboolean state)
+        {
+            shadow_enabled_ = state;
+        }
+
+        GLboolean isShadowEnabled() const
+        {
+            return shadow_enabled_;
+        }
+
+        void setShadowColor(const glm::vec3 &color)
+        {
+            shadow_color_ = glm::vec3(glm::clamp(color.r, 0.0f, 1.0f),
+                glm::clamp(color.g, 0.0f, 1.0f),
+                glm::clamp(color.b, 0.0f, 1.0f));
+        }
+
+        glm::vec3 getShadowColor() const
+        {
+            return shadow_color_;
+        }
+
+        // Offset in pixels, positive values move shadow right and down
+        void setShadowOffset(const glm::ivec2 &offset)
+        {
+            shadow_offset_ = offset;
+        }
+
+        glm::ivec2 getShadowOffset() const
+        {
+            return shadow_offset_;
+        }
+
+        void setShadowSoftness(GLint softness)
+        {
+            if (softness < 0)
+                logErrorAndThrow(name_, "Text::setShadowSoftness()",
+                    "Shadow softness value out of range: {0 <= VALUE}.");
+
+            shadow_softness_ = softness;
+        }
+
+        GLint getShadowSoftness() const
+        {
+            return shadow_softness_;
+        }
+
+        // Lines longer than wrap width are broken at last space. Width of
+        // zero disables wrapping.
+        void setWrapWidth(GLint width)
+        {
+            if (width < 0)
+                logErrorAndThrow(name_, "Text::setWrapWidth()",
+                    "Wrap width value out of range: {0 <= VALUE}.");
+
+            wrap_width_ = width;
+            changeLayout();
+        }
+
+        GLint getWrapWidth() const
+        {
+            return wrap_width_;
+        }
+
+        // Lines are aligned inside of wrap width, or inside of widest line
+        // when wrapping is disabled
+        void setAlignment(TextAlignment alignment)
+        {
+            alignment_ = alignment;
+            changeLayout();
+        }
+
+        TextAlignment getAlignment() const
+        {
+            return alignment_;
+        }
+
         void setVerticalSpacing(GLint spacing);
         GLint getVerticalSpacing() const;
         void setHorizontalSpacing(GLint spacing);
         GLint getHorizontalSpacing() const;
 
+        // Incremented only by changes of content, font and spacing, so
+        // layout is kept when text is moved
+        GLuint getLayoutVersion() const
+        {
+            return layout_version_;
+        }
+
     protected:
+        void changeLayout()
+        {
+            version_++;
+            layout_version_++;
+        }
+
         std::wstring text_{L""};
         std::string font_{""};
         GLint font_size_{16};
@@ -93,8 +232,23 @@ namespace puffin
         GLint outline_size_{0};
         glm::vec3 outline_color_{0.0f, 0.0f, 0.0f};
 
+        GLboolean distance_field_enabled_{false};
+
+        glm::vec3 glow_color_{1.0f, 1.0f, 1.0f};
+        GLint glow_size_{0};
+
+        GLboolean shadow_enabled_{false};
+        glm::vec3 shadow_color_{0.0f, 0.0f, 0.0f};
+        glm::ivec2 shadow_offset_{2, 2};
+        GLint shadow_softness_{1};
+
+        GLint wrap_width_{0};
+        TextAlignment alignment_{TextAlignment::LEFT};
+
         GLint vertical_spacing_{0};
         GLint horizontal_spacing_{0};
+
+        GLuint layout_version_{1};
     };
 
     using TextPtr = std::shared_ptr<Text>;
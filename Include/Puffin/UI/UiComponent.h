@@ -42,12 +42,14 @@ namespace puffin
         void setPosition(const glm::uvec2 &position)
         {
             position_ = position;
+            version_++;
         }
 
         void setPosition(GLint x, GLint y)
         {
             position_.x = x;
             position_.y = y;
+            version_++;
         }
 
         glm::uvec2 getPosition() const
@@ -55,10 +57,18 @@ namespace puffin
             return position_;
         }
 
+        // Incremented by every change of component's geometry, so renderers
+        // can keep generated meshes until it changes
+        GLuint getVersion() const
+        {
+            return version_;
+        }
+
     protected:
         std::string name_{"unnamed_ui_component"};
 
         glm::uvec2 position_{0, 0};
+        GLuint version_{1};
     };
 
     using UiComponentPtr = std::shared_ptr<UiComponent>;
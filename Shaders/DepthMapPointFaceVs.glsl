@@ -0,0 +1,19 @@
+#version 330 core
+
+layout (location = 0) in vec3 position;
+
+struct Matrices
+{
+    mat4 model_matrix;
+};
+
+uniform Matrices matrices;
+uniform mat4 face_matrix;
+
+out vec4 frag_pos;
+
+void main()
+{
+    frag_pos = matrices.model_matrix * vec4(position, 1.0);
+    gl_Position = face_matrix * frag_pos;
+}
\ No newline at end of file
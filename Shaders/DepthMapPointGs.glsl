@@ -1,4 +1,5 @@
 #version 330 core
+#extension GL_ARB_viewport_array : require
 
 layout (triangles) in;
 layout (triangle_strip, max_vertices = 18) out;
@@ -9,6 +10,7 @@ struct Matrix
 };
 
 uniform Matrix shadow_matrices[6];
+uniform int faces_mask;
 
 out vec4 frag_pos; 
 
@@ -16,7 +18,12 @@ void main()
 {
     for (int face = 0; face < 6; face++)
     {
-        gl_Layer = face; 
+        // Faces not changed since last frame are skipped
+        if ((faces_mask & (1 << face)) == 0)
+            continue;
+
+        // Every face has its own viewport inside shadow atlas
+        gl_ViewportIndex = face;
         for (int i = 0; i < 3; i++)
         {
             frag_pos = gl_in[i].gl_Position;
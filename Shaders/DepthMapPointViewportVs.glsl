@@ -0,0 +1,31 @@
+#version 330 core
+#extension GL_ARB_shader_viewport_layer_array : enable
+#extension GL_AMD_vertex_shader_viewport_index : enable
+
+layout (location = 0) in vec3 position;
+
+struct Matrices
+{
+    mat4 model_matrix;
+};
+
+struct Matrix
+{
+    mat4 mat;
+};
+
+uniform Matrices matrices;
+uniform Matrix shadow_matrices[6];
+uniform int instance_faces[6];
+
+out vec4 frag_pos;
+
+void main()
+{
+    // Each instance renders object to viewport of one cube face tile
+    int face = instance_faces[gl_InstanceID];
+
+    frag_pos = matrices.model_matrix * vec4(position, 1.0);
+    gl_Position = shadow_matrices[face].mat * frag_pos;
+    gl_ViewportIndex = face;
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#version 330
+
+struct Color
+{
+    sampler2D font_texture;
+    vec3 font_color;
+    vec3 outline_color;
+    vec3 glow_color;
+    vec3 shadow_color;
+};
+
+// Edges are field values, glyph's edge lies at 0.5
+struct DistanceField
+{
+    float outline_edge;
+    float glow_edge;
+    bool shadow_enabled;
+    float shadow_edge;
+    vec2 shadow_offset;
+};
+
+in VS_OUT
+{
+    vec2 texture_coordinates;
+} fs_in;
+
+out vec4 frag_colour;
+
+uniform Color color;
+uniform DistanceField distance_field;
+
+vec4 blendOver(vec4 top, vec4 bottom)
+{
+    float alpha = top.a + bottom.a * (1.0 - top.a);
+    if (alpha <= 0.0)
+        return vec4(0.0);
+
+    vec3 rgb = (top.rgb * top.a + bottom.rgb * bottom.a * (1.0 - top.a)) /
+        alpha;
+    return vec4(rgb, alpha);
+}
+
+void main()
+{
+    float distance = texture(color.font_texture,
+        fs_in.texture_coordinates).r;
+
+    // Antialiasing width follows scale of text on screen
+    float width = max(fwidth(distance) * 0.5, 0.001);
+
+    float fill = smoothstep(0.5 - width, 0.5 + width, distance);
+    float body = smoothstep(distance_field.outline_edge - width,
+        distance_field.outline_edge + width, distance);
+    vec4 result = vec4(mix(color.outline_color, color.font_color, fill),
+        body);
+
+    if (distance_field.glow_edge < distance_field.outline_edge)
+    {
+        float glow = smoothstep(distance_field.glow_edge,
+            distance_field.outline_edge, distance);
+        result = blendOver(result, vec4(color.glow_color, glow));
+    }
+
+    if (distance_field.shadow_enabled)
+    {
+        float shadow_distance = texture(color.font_texture,
+            fs_in.texture_coordinates - distance_field.shadow_offset).r;
+        float shadow = smoothstep(distance_field.shadow_edge - width,
+            distance_field.outline_edge + width, shadow_distance);
+        result = blendOver(result, vec4(color.shadow_color, shadow));
+    }
+
+    frag_colour = result;
+}
\ No newline at end of file
@@ -1,6 +1,6 @@
 #version 330 core
 
-#define POINT_LIGHTS_COUNT 4
+#define MAX_CASCADES_COUNT 4
 
 struct DirectionalLight
 {
@@ -11,11 +11,20 @@ struct DirectionalLight
 
 struct PointLight
 {
-    bool enabled;
     vec3 position;
-    vec3 color;    
+    vec3 color;
+    float range;
     float linear_factor;
-    float quadratic_factor; 
+    float quadratic_factor;
+    vec3 shadow_tile;
+};
+
+struct Clusters
+{
+    ivec3 grid_size;
+    vec2 screen_size;
+    float near_plane;
+    float depth_scale;
 };
 
 struct Matrices
@@ -23,30 +32,30 @@ struct Matrices
     mat4 view_matrix;
     mat4 projection_matrix;
     mat4 model_matrix;
-    mat4 dir_light_pv_matrix;
     mat4 env_map_model_matrix;
 };
 
 struct Fog
 {
-    bool enabled;
     vec3 color;
     float density;
 };
 
 struct Shadow
 {
-    bool enabled;
     float distance;
     float transition_distance;
     int map_size;
     int pcf_filter_count;
+    int cascades_count;
+    mat4 cascade_matrices[MAX_CASCADES_COUNT];
+    float cascade_distances[MAX_CASCADES_COUNT];
+    float cascade_scales[MAX_CASCADES_COUNT];
+    int point_atlas_size;
 };
 
 struct Material
 {
-    bool has_diffuse_texture;
-    bool has_normalmap_texture;
     sampler2D diffuse_texture;
     sampler2D normalmap_texture;
     vec3 ka;
@@ -56,44 +65,73 @@ struct Material
     float reflectivity;
 };
 
-in GS_OUT
+in VS_OUT
 {
-    float clip_height;
-
     vec3 normal_vector_VIEW;
     vec2 texture_coord_MODEL;
-    vec3 view_position_TANGENT;
     vec3 position_WORLD;
     vec3 position_VIEW;
+#ifdef NORMALMAP_TEXTURE
     vec3 position_TANGENT;
-    vec3 point_light_position_VIEW[POINT_LIGHTS_COUNT];
-    vec3 point_light_position_TANGENT[POINT_LIGHTS_COUNT];
-    vec3 directional_light_direction_VIEW; 
+    vec3 view_position_TANGENT;
     vec3 directional_light_direction_TANGENT;
-    vec4 frag_pos_DIR_LIGHT;
+    mat3 tbn_matrix;
+#endif
 } fs_in;
 
 out vec4 frag_color;
 
-uniform bool lighting_enabled;
 uniform DirectionalLight directional_light;
-uniform PointLight point_lights[POINT_LIGHTS_COUNT];
-uniform int used_point_lights_count;
+uniform Clusters clusters;
 
 uniform Matrices matrices;
 uniform Fog fog;
 uniform Shadow shadow;
 
-uniform samplerCube point_shadow_map_1;
-uniform samplerCube point_shadow_map_2;
-uniform samplerCube point_shadow_map_3;
-uniform samplerCube point_shadow_map_4;
-uniform sampler2D shadow_map_texture;
+uniform sampler2D point_shadow_atlas;
+uniform samplerBuffer point_lights_data;
+uniform usamplerBuffer clusters_data;
+uniform usamplerBuffer light_indices;
+uniform sampler2DArray shadow_map_texture;
 uniform samplerCube env_map_texture;
 uniform Material object_material;
 
-float calcDirectionalShadow(vec4 frag_pos)
+// Positive values select smaller mipmaps, used by cheaper render passes
+uniform float texture_lod_bias;
+
+// Features are compiled in by shader manager:
+// LIGHTING, SHADOWS, FOG, DIFFUSE_TEXTURE, NORMALMAP_TEXTURE.
+// SHADOWS and NORMALMAP_TEXTURE are used only together with LIGHTING.
+
+#ifdef SHADOWS
+float calcDirectionalShadow()
 {
+    float view_distance = -fs_in.position_VIEW.z;
+    if (shadow.cascades_count == 0 || view_distance > shadow.distance)
+        return 1.0f;
+
+    // Choose cascade covering fragment
+    int cascade = shadow.cascades_count - 1;
+    for (int i = 0; i < shadow.cascades_count; i++)
+    {
+        if (view_distance < shadow.cascade_distances[i])
+        {
+            cascade = i;
+            break;
+        }
+    }
+
+    vec4 frag_pos = shadow.cascade_matrices[cascade] * 
+        vec4(fs_in.position_WORLD, 1.0f);
+    frag_pos = 0.5f + 0.5f * frag_pos;
+
+    float current_depth = frag_pos.z;
+    if (current_depth > 1.0f)
+        return 1.0f;
+
+    // Cascade may use only part of texture array layer
+    vec2 frag_coord = frag_pos.xy * shadow.cascade_scales[cascade];
+
     float total_texels = (shadow.pcf_filter_count * 2.0f + 1.0f) * 
         (shadow.pcf_filter_count * 2.0f + 1.0f);
 
@@ -105,22 +143,26 @@ float calcDirectionalShadow(vec4 frag_pos)
         for (int y = -shadow.pcf_filter_count; y <= shadow.pcf_filter_count; 
             y++)
         {
-            float current_depth = frag_pos.z;
-            if (current_depth > 1.0f)
-                return 1.0f;
-
-            float closest_depth = texture(shadow_map_texture, frag_pos.xy +
-                vec2(x, y) * texel_size).r;
+            float closest_depth = texture(shadow_map_texture, vec3(frag_coord +
+                vec2(x, y) * texel_size, cascade)).r;
             if (current_depth  > closest_depth + 0.005f)
                 total += 1.0f;
         }
     }
 
     total /= total_texels;
-    float light_factor = 1.0f - (total * frag_pos.w * 1.0f);
+
+    // Fade shadow out at the end of shadow distance
+    float fade = (view_distance - (shadow.distance - 
+        shadow.transition_distance)) / shadow.transition_distance;
+    fade = clamp(1.0f - fade, 0.0f, 1.0f);
+
+    float light_factor = 1.0f - (total * fade);
     return light_factor;
 }
+#endif
 
+#ifdef LIGHTING
 vec3 calcDirectionalLight()
 {
     vec3 ambient = vec3(0.0f, 0.0f, 0.0f);
@@ -128,61 +170,50 @@ vec3 calcDirectionalLight()
     vec3 specular = vec3(0.0f, 0.0f, 0.0f);
 
     // Get light direction
-    vec3 light_direction = vec3(0.0f, 1.0f, 0.0f);
-    if (object_material.has_normalmap_texture)
-        light_direction = fs_in.directional_light_direction_TANGENT;
-    else
-        light_direction = fs_in.directional_light_direction_VIEW;
+#ifdef NORMALMAP_TEXTURE
+    vec3 light_direction = fs_in.directional_light_direction_TANGENT;
+#else
+    vec3 light_direction = normalize(vec3(matrices.view_matrix * 
+        vec4(directional_light.direction, 0.0f)));
+#endif
 
     // Get normal vector
-    vec3 normal_vector = vec3(0.0f, 1.0f, 0.0f);
-    if (object_material.has_normalmap_texture)
-    {
-        vec3 normal_vector_TANGENT = texture(object_material.normalmap_texture,  
-            fs_in.texture_coord_MODEL).rgb;
-        normal_vector_TANGENT = normalize(normal_vector_TANGENT * 2.0f - 1.0f);
-        normal_vector = normal_vector_TANGENT;
-    }
-    else
-    {
-        normal_vector = fs_in.normal_vector_VIEW;
-    }
+#ifdef NORMALMAP_TEXTURE
+    vec3 normal_vector = texture(object_material.normalmap_texture,
+        fs_in.texture_coord_MODEL, texture_lod_bias).rgb;
+    normal_vector = normalize(normal_vector * 2.0f - 1.0f);
+#else
+    vec3 normal_vector = fs_in.normal_vector_VIEW;
+#endif
 
     // Get view direction
-    vec3 view_direction = vec3(0.0f, 1.0f, 0.0f);
-    if (object_material.has_normalmap_texture)
-    {
-        vec3 view_direction_TANGENT = normalize(fs_in.view_position_TANGENT - 
-            fs_in.position_TANGENT);
-        view_direction = view_direction_TANGENT;
-    }
-    else
-    {
-        vec3 view_direction_VIEW = normalize(-fs_in.position_VIEW);
-        view_direction = view_direction_VIEW;
-    }
+#ifdef NORMALMAP_TEXTURE
+    vec3 view_direction = normalize(fs_in.view_position_TANGENT - 
+        fs_in.position_TANGENT);
+#else
+    vec3 view_direction = normalize(-fs_in.position_VIEW);
+#endif
 
     // Calculate lighting
     // Ambient
     ambient = directional_light.color * object_material.ka;
 
-    if (object_material.has_diffuse_texture)
-        ambient = ambient * vec3(texture(object_material.diffuse_texture,
-            fs_in.texture_coord_MODEL));
+#ifdef DIFFUSE_TEXTURE
+    vec4 texel = texture(object_material.diffuse_texture,
+        fs_in.texture_coord_MODEL, texture_lod_bias);
+    if (texel.a < 0.2f)
+        discard;
+
+    ambient = ambient * vec3(texel);
+#endif
 
     // Diffuse
     float diffuse_power = max(dot(normal_vector, -light_direction), 0.0f);
     diffuse = directional_light.color * diffuse_power * object_material.kd;
 
-    if (object_material.has_diffuse_texture)
-    {
-        vec4 texel = texture(object_material.diffuse_texture,
-            fs_in.texture_coord_MODEL);
-        if (texel.a < 0.2f)
-            discard;
-
-        diffuse = diffuse * vec3(texel);
-    }
+#ifdef DIFFUSE_TEXTURE
+    diffuse = diffuse * vec3(texel);
+#endif
 
     // Specular
     vec3 reflected_ray = normalize(reflect(light_direction, normal_vector));
@@ -192,12 +223,15 @@ vec3 calcDirectionalLight()
 
     // Shadow
     float shadow_value = 1.0f;
-    if (shadow.enabled)
-        shadow_value = calcDirectionalShadow(fs_in.frag_pos_DIR_LIGHT);
-    
+#ifdef SHADOWS
+    shadow_value = calcDirectionalShadow();
+#endif
+
     return (ambient + shadow_value * (diffuse + specular));
 }
+#endif
 
+#ifdef FOG
 vec3 calcFog(vec3 input_color)
 {
     float distance = length(fs_in.position_VIEW);
@@ -207,6 +241,7 @@ vec3 calcFog(vec3 input_color)
     vec3 result = mix(input_color, fog.color, fog_power);
     return result;
 }
+#endif
 
 vec3 calcReflection(vec3 input_color)
 {
@@ -225,148 +260,210 @@ vec3 calcReflection(vec3 input_color)
     return result;
 }
 
-float calcPointShadow(vec3 frag_pos, int light_index)
+#ifdef LIGHTING
+PointLight fetchPointLight(int light_index)
 {
-    vec3 frag_to_light = frag_pos - point_lights[light_index].position;
-
-    float closest_depth = 0.0f;
-    if (light_index == 0)
-        closest_depth = texture(point_shadow_map_1, frag_to_light).r;
-    else if (light_index == 1)
-        closest_depth = texture(point_shadow_map_2, frag_to_light).r;
-    else if (light_index == 2)
-        closest_depth = texture(point_shadow_map_3, frag_to_light).r;
-    else if (light_index == 3)
-        closest_depth = texture(point_shadow_map_4, frag_to_light).r;
-    closest_depth *= shadow.distance;
+    vec4 texel_0 = texelFetch(point_lights_data, light_index * 3);
+    vec4 texel_1 = texelFetch(point_lights_data, light_index * 3 + 1);
+    vec4 texel_2 = texelFetch(point_lights_data, light_index * 3 + 2);
+
+    PointLight light;
+    light.position = texel_0.xyz;
+    light.range = texel_0.w;
+    light.color = texel_1.rgb;
+    light.linear_factor = texel_1.a;
+    light.quadratic_factor = texel_2.x;
+    light.shadow_tile = texel_2.yzw;
+
+    return light;
+}
 
-    float current_depth = length(frag_to_light);
+// Returns offset and count of lights assigned to fragment's cluster
+uvec2 fetchCluster()
+{
+    float depth = -fs_in.position_VIEW.z;
+
+    ivec3 cluster = ivec3(0, 0, 0);
+    cluster.xy = ivec2(gl_FragCoord.xy / clusters.screen_size * 
+        vec2(clusters.grid_size.xy));
+    cluster.z = int(log(max(depth / clusters.near_plane, 1.0f)) * 
+        clusters.depth_scale);
+    cluster = clamp(cluster, ivec3(0, 0, 0), clusters.grid_size - 1);
+
+    int index = cluster.x + clusters.grid_size.x * (cluster.y + 
+        clusters.grid_size.y * cluster.z);
+    return texelFetch(clusters_data, index).rg;
+}
 
+#ifdef SHADOWS
+float calcPointShadow(vec3 frag_pos, PointLight light)
+{
+    vec3 frag_to_light = frag_pos - light.position;
+    float current_depth = length(frag_to_light);
     float bias = 0.05f;
+
+    // Light without tile is not visible, so only fragments out of shadow
+    // distance can be seen
+    vec3 tile = light.shadow_tile;
+    if (tile.z == 0.0f)
+        return current_depth - bias > shadow.distance ? 1.0 : 0.0;
+
+    // Select cube face and its coordinates the same way as cube map does
+    vec3 abs_dir = abs(frag_to_light);
+    int face = 0;
+    float major_axis = 0.0f;
+    vec2 face_coord = vec2(0.0f, 0.0f);
+
+    if (abs_dir.x >= abs_dir.y && abs_dir.x >= abs_dir.z)
+    {
+        face = frag_to_light.x > 0.0f ? 0 : 1;
+        major_axis = abs_dir.x;
+        face_coord = vec2(frag_to_light.x > 0.0f ? -frag_to_light.z : 
+            frag_to_light.z, -frag_to_light.y);
+    }
+    else if (abs_dir.y >= abs_dir.z)
+    {
+        face = frag_to_light.y > 0.0f ? 2 : 3;
+        major_axis = abs_dir.y;
+        face_coord = vec2(frag_to_light.x, frag_to_light.y > 0.0f ? 
+            frag_to_light.z : -frag_to_light.z);
+    }
+    else
+    {
+        face = frag_to_light.z > 0.0f ? 4 : 5;
+        major_axis = abs_dir.z;
+        face_coord = vec2(frag_to_light.z > 0.0f ? frag_to_light.x : 
+            -frag_to_light.x, -frag_to_light.y);
+    }
+
+    face_coord = 0.5f + 0.5f * face_coord / major_axis;
+
+    // Samples cannot leak into neighbouring tiles
+    face_coord = clamp(face_coord, 0.5f / tile.z, 1.0f - 0.5f / tile.z);
+
+    vec2 face_origin = tile.xy + vec2(face % 3, face / 3) * tile.z;
+    vec2 atlas_coord = (face_origin + face_coord * tile.z) / 
+        shadow.point_atlas_size;
+
+    float closest_depth = texture(point_shadow_atlas, atlas_coord).r;
+    closest_depth *= shadow.distance;
+
     float shadow = current_depth - bias > closest_depth ? 1.0 : 0.0;
 
     return shadow;
 }
+#endif
 
-vec3 calculatePointLight(int light_index)
+vec3 calculatePointLight(PointLight light)
 {
     vec3 ambient = vec3(0.0f, 0.0f, 0.0f);
     vec3 diffuse = vec3(0.0f, 0.0f, 0.0f);
     vec3 specular = vec3(0.0f, 0.0f, 0.0f);
 
-    float vertex_dist = length(fs_in.point_light_position_VIEW[light_index] - 
-        fs_in.position_VIEW);
-    float attenuation = 1.0f / (1.0f + point_lights[light_index].linear_factor * 
-        vertex_dist + point_lights[light_index].quadratic_factor * vertex_dist * 
-        vertex_dist);
+    vec3 light_position_VIEW = vec3(matrices.view_matrix * 
+        vec4(light.position, 1.0f));
+
+    float vertex_dist = length(light_position_VIEW - fs_in.position_VIEW);
+    if (vertex_dist > light.range)
+        return vec3(0.0f, 0.0f, 0.0f);
+
+    float attenuation = 1.0f / (1.0f + light.linear_factor * vertex_dist + 
+        light.quadratic_factor * vertex_dist * vertex_dist);
 
     // Get light direction
-    vec3 light_direction = vec3(0.0f, 1.0f, 0.0f);
-    if (object_material.has_normalmap_texture)
-    {
-        vec3 light_direction_TANGENT = normalize(
-            fs_in.point_light_position_TANGENT[light_index] - 
-            fs_in.position_TANGENT);
-        light_direction = light_direction_TANGENT;
-    }
-    else
-    {
-        vec3 light_direction_VIEW = normalize(
-            fs_in.point_light_position_VIEW[light_index] - fs_in.position_VIEW);
-        light_direction = light_direction_VIEW;
-    } 
+#ifdef NORMALMAP_TEXTURE
+    vec3 light_direction = normalize(fs_in.tbn_matrix * light.position - 
+        fs_in.position_TANGENT);
+#else
+    vec3 light_direction = normalize(light_position_VIEW - 
+        fs_in.position_VIEW);
+#endif
 
     // Get normal vector
-    vec3 normal_vector = vec3(0.0f, 1.0f, 0.0f);
-    if (object_material.has_normalmap_texture)
-    {
-        vec3 normal_vector_TANGENT = texture(object_material.normalmap_texture,  
-            fs_in.texture_coord_MODEL).rgb;
-        normal_vector_TANGENT = normalize(normal_vector_TANGENT * 2.0f - 1.0f);
-        normal_vector = normal_vector_TANGENT;
-    }
-    else
-    {
-        normal_vector = fs_in.normal_vector_VIEW;
-    }
+#ifdef NORMALMAP_TEXTURE
+    vec3 normal_vector = texture(object_material.normalmap_texture,
+        fs_in.texture_coord_MODEL, texture_lod_bias).rgb;
+    normal_vector = normalize(normal_vector * 2.0f - 1.0f);
+#else
+    vec3 normal_vector = fs_in.normal_vector_VIEW;
+#endif
 
     // Get view direction
-    vec3 view_direction = vec3(0.0f, 1.0f, 0.0f);
-    if (object_material.has_normalmap_texture)
-    {
-        vec3 view_direction_TANGENT = normalize(fs_in.view_position_TANGENT - 
-            fs_in.position_TANGENT);
-        view_direction = view_direction_TANGENT;
-    }
-    else
-    {
-        vec3 view_direction_VIEW = normalize(-fs_in.position_VIEW);
-        view_direction = view_direction_VIEW;
-    }
+#ifdef NORMALMAP_TEXTURE
+    vec3 view_direction = normalize(fs_in.view_position_TANGENT - 
+        fs_in.position_TANGENT);
+#else
+    vec3 view_direction = normalize(-fs_in.position_VIEW);
+#endif
 
     // Calculate lighting
     // Ambient
-    ambient = point_lights[light_index].color * attenuation * 
+    ambient = light.color * attenuation * 
         object_material.ka;
 
-    if (object_material.has_diffuse_texture)
-        ambient = ambient * vec3(texture(object_material.diffuse_texture, 
-            fs_in.texture_coord_MODEL));
+#ifdef DIFFUSE_TEXTURE
+    vec3 texel = vec3(texture(object_material.diffuse_texture, 
+        fs_in.texture_coord_MODEL, texture_lod_bias));
+    ambient = ambient * texel;
+#endif
 
     // Diffuse
     float diffuse_power = max(dot(normal_vector, light_direction), 0.0f);
-    diffuse = point_lights[light_index].color * diffuse_power * attenuation * 
+    diffuse = light.color * diffuse_power * attenuation * 
         object_material.kd;
 
-    if (object_material.has_diffuse_texture)
-        diffuse = diffuse * vec3(texture(object_material.diffuse_texture, 
-            fs_in.texture_coord_MODEL));
+#ifdef DIFFUSE_TEXTURE
+    diffuse = diffuse * texel;
+#endif
 
     // Specular
     vec3 reflected_ray = normalize(reflect(-light_direction, normal_vector));
     float specular_power = pow(max(dot(reflected_ray, view_direction), 0.0f), 
         object_material.shininess);
-    specular = point_lights[light_index].color * specular_power * 
+    specular = light.color * specular_power * 
         object_material.ks * attenuation;
 
     // Shadow
     float shadow_value = 1.0f;
-    if (shadow.enabled)
-        shadow_value = 1.0f - calcPointShadow(fs_in.position_WORLD, 
-            light_index);
+#ifdef SHADOWS
+    shadow_value = 1.0f - calcPointShadow(fs_in.position_WORLD, light);
+#endif
 
     return (ambient + shadow_value * (diffuse + specular));
 }
+#endif
 
 void main()
 {
     vec3 result_color = vec3(0.0f, 0.0f, 0.0f);
 
-    if (lighting_enabled)
-    {
-        if (directional_light.enabled)
-            result_color = calcDirectionalLight();
+#ifdef LIGHTING
+    if (directional_light.enabled)
+        result_color = calcDirectionalLight();
 
-        for (int i = 0; i < used_point_lights_count; i++)
-        {
-            if (point_lights[i].enabled)
-                result_color += calculatePointLight(i);
-        }
-    }
-    else
+    // Only lights assigned to fragment's cluster are processed
+    uvec2 cluster = fetchCluster();
+    for (uint i = 0u; i < cluster.y; i++)
     {
-        if (object_material.has_diffuse_texture)
-            result_color = vec3(texture(object_material.diffuse_texture,
-                fs_in.texture_coord_MODEL));
-        else
-            result_color = object_material.kd;
+        int light_index = int(texelFetch(light_indices, 
+            int(cluster.x + i)).r);
+        result_color += calculatePointLight(fetchPointLight(light_index));
     }
+#else
+#ifdef DIFFUSE_TEXTURE
+    result_color = vec3(texture(object_material.diffuse_texture,
+        fs_in.texture_coord_MODEL, texture_lod_bias));
+#else
+    result_color = object_material.kd;
+#endif
+#endif
 
     if (object_material.reflectivity > 0.0f)
         result_color = calcReflection(result_color);
 
-    if (fog.enabled)
-        result_color = calcFog(result_color);
+#ifdef FOG
+    result_color = calcFog(result_color);
+#endif
 
     frag_color = vec4(result_color, 1.0f);
 }
\ No newline at end of file
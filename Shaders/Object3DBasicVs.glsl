@@ -6,8 +6,6 @@ layout(location = 2) in vec2 texture_coord;
 layout(location = 3) in vec3 tangent;
 layout(location = 4) in vec3 bitangent;
 
-#define POINT_LIGHTS_COUNT 4
-
 struct DirectionalLight
 {
     bool enabled;
@@ -15,56 +13,32 @@ struct DirectionalLight
     vec3 direction;
 };
 
-struct PointLight
-{
-    bool enabled;
-    vec3 position;
-    vec3 color;    
-    float linear_factor;
-    float quadratic_factor;    
-};
-
 struct Matrices
 {
     mat4 view_matrix;
     mat4 projection_matrix;
     mat4 model_matrix;
-    mat4 dir_light_pv_matrix;
     mat4 env_map_model_matrix;
 };
 
-struct Shadow
-{
-    bool enabled;
-    float distance;
-    float transition_distance;
-    int map_size;
-    int pcf_filter_count;
-};
-
+// Tangent space is passed only to variants using normal map
 out VS_OUT
 {
-    float clip_height;
-
     vec3 normal_vector_VIEW;
     vec2 texture_coord_MODEL;
-    vec3 view_position_TANGENT;
     vec3 position_WORLD;
     vec3 position_VIEW;
+#ifdef NORMALMAP_TEXTURE
     vec3 position_TANGENT;
-    vec3 point_light_position_VIEW[POINT_LIGHTS_COUNT];
-    vec3 point_light_position_TANGENT[POINT_LIGHTS_COUNT];
-    vec3 directional_light_direction_VIEW; 
+    vec3 view_position_TANGENT;
     vec3 directional_light_direction_TANGENT;
-    vec4 frag_pos_DIR_LIGHT;
+    mat3 tbn_matrix;
+#endif
 } vs_out;
 
 uniform DirectionalLight directional_light;
-uniform PointLight point_lights[POINT_LIGHTS_COUNT];
-uniform int used_point_lights_count;
 
 uniform Matrices matrices;
-uniform Shadow shadow;
 
 uniform vec4 clip_plane;
 
@@ -79,6 +53,7 @@ void main()
     vs_out.position_VIEW = vec3(matrices.view_matrix * 
         vec4(vs_out.position_WORLD, 1.0f));       
 
+#ifdef NORMALMAP_TEXTURE
     vec3 camera_pos_WORLD = (inverse(matrices.view_matrix) * 
         vec4(0.0f, 0.0f, 0.0f, 1.0f)).xyz;
 
@@ -92,29 +67,15 @@ void main()
     vs_out.position_TANGENT = tbn_matrix * vs_out.position_WORLD;
     vs_out.view_position_TANGENT = tbn_matrix * camera_pos_WORLD;
 
-    for (int i = 0; i < used_point_lights_count; i++)
-    {
-        vs_out.point_light_position_TANGENT[i] = tbn_matrix * 
-            point_lights[i].position;
-        vs_out.point_light_position_VIEW[i] = vec3(matrices.view_matrix * 
-            vec4(point_lights[i].position, 1.0f));
-    }
+    // Point lights are transformed per fragment, because their count is
+    // not limited
+    vs_out.tbn_matrix = tbn_matrix;
 
-    vs_out.directional_light_direction_VIEW = normalize(vec3(
-        matrices.view_matrix * vec4(directional_light.direction, 0.0f)));
     vs_out.directional_light_direction_TANGENT = normalize(tbn_matrix * 
         directional_light.direction);
+#endif
 
-    vs_out.clip_height = dot(vec4(vs_out.position_WORLD, 1.0f), clip_plane); 
-
-    float distance = length(vs_out.position_VIEW);
-    distance = distance - (shadow.distance - shadow.transition_distance);
-    distance = distance / shadow.transition_distance;
-
-    vs_out.frag_pos_DIR_LIGHT = matrices.dir_light_pv_matrix * 
-        vec4(vs_out.position_WORLD, 1.0f);
-    vs_out.frag_pos_DIR_LIGHT = 0.5f + 0.5f * vs_out.frag_pos_DIR_LIGHT;
-    vs_out.frag_pos_DIR_LIGHT.w = clamp(1.0f - distance, 0.0f, 1.0f);
+    gl_ClipDistance[0] = dot(vec4(vs_out.position_WORLD, 1.0f), clip_plane);
 
     gl_Position = matrices.projection_matrix * vec4(vs_out.position_VIEW, 1.0f);
 }
\ No newline at end of file
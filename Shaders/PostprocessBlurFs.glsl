@@ -0,0 +1,30 @@
+#version 330 core
+
+in VS_OUT
+{
+    vec2 tex_coord;
+} fs_in;
+
+out vec4 frag_color;
+
+uniform sampler2D screen_texture;
+// Last texel centre of part covered by scene
+uniform vec2 uv_max;
+uniform float kernel_size;
+// Horizontal (1, 0) or vertical (0, 1) pass
+uniform vec2 direction;
+
+void main()
+{
+    // Two passes of 1-2-1 kernel give the same result as 3x3 Gaussian kernel
+    vec2 offset = direction / kernel_size;
+
+    vec3 result_color = texture(screen_texture, min(fs_in.tex_coord, 
+        uv_max)).rgb * 0.5f;
+    result_color += texture(screen_texture, min(fs_in.tex_coord - offset, 
+        uv_max)).rgb * 0.25f;
+    result_color += texture(screen_texture, min(fs_in.tex_coord + offset, 
+        uv_max)).rgb * 0.25f;
+
+    frag_color = vec4(result_color, 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#version 330 core
+
+in VS_OUT
+{
+    vec2 tex_coord;
+} fs_in;
+
+out vec4 frag_color;
+
+uniform sampler2D screen_texture;
+// Last texel centre of part covered by scene
+uniform vec2 uv_max;
+uniform float kernel[9];
+uniform float kernel_size;
+
+void main()
+{
+    float offset = 1.0f / kernel_size;
+    vec2 offsets[9] = vec2[](
+        vec2(-offset, offset),
+        vec2(0.0f, offset),
+        vec2(offset, offset),
+        vec2(-offset, 0.0f),
+        vec2(0.0f, 0.0f),
+        vec2(offset, 0.0f),
+        vec2(-offset, -offset),
+        vec2(0.0f, -offset),
+        vec2(offset, -offset));
+
+    vec3 result_color = vec3(0.0f, 0.0f, 0.0f);
+    for (int i = 0; i < 9; i++)
+        result_color += texture(screen_texture, min(fs_in.tex_coord + 
+            offsets[i], uv_max)).rgb * kernel[i];
+
+    frag_color = vec4(result_color, 1.0f);
+}
\ No newline at end of file
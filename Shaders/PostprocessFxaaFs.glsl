@@ -0,0 +1,68 @@
+#version 330 core
+
+#define FXAA_SPAN_MAX 8.0f
+#define FXAA_REDUCE_MUL (1.0f / 8.0f)
+#define FXAA_REDUCE_MIN (1.0f / 128.0f)
+
+in VS_OUT
+{
+    vec2 tex_coord;
+} fs_in;
+
+out vec4 frag_color;
+
+uniform sampler2D screen_texture;
+// Last texel centre of part covered by scene
+uniform vec2 uv_max;
+uniform vec2 texel_size;
+
+float luma(vec3 color)
+{
+    return dot(color, vec3(0.299f, 0.587f, 0.114f));
+}
+
+vec3 sampleScreen(vec2 offset)
+{
+    return texture(screen_texture, min(fs_in.tex_coord + offset, uv_max)).rgb;
+}
+
+void main()
+{
+    vec3 rgb_m = sampleScreen(vec2(0.0f, 0.0f));
+
+    float luma_nw = luma(sampleScreen(vec2(-1.0f, -1.0f) * texel_size));
+    float luma_ne = luma(sampleScreen(vec2(1.0f, -1.0f) * texel_size));
+    float luma_sw = luma(sampleScreen(vec2(-1.0f, 1.0f) * texel_size));
+    float luma_se = luma(sampleScreen(vec2(1.0f, 1.0f) * texel_size));
+    float luma_m = luma(rgb_m);
+
+    float luma_min = min(luma_m, min(min(luma_nw, luma_ne), 
+        min(luma_sw, luma_se)));
+    float luma_max = max(luma_m, max(max(luma_nw, luma_ne), 
+        max(luma_sw, luma_se)));
+
+    // Blur direction is perpendicular to luma gradient, so along the edge
+    vec2 direction = vec2(-((luma_nw + luma_ne) - (luma_sw + luma_se)),
+        (luma_nw + luma_sw) - (luma_ne + luma_se));
+
+    float direction_reduce = max((luma_nw + luma_ne + luma_sw + luma_se) * 
+        (0.25f * FXAA_REDUCE_MUL), FXAA_REDUCE_MIN);
+    float inverse_direction_min = 1.0f / (min(abs(direction.x), 
+        abs(direction.y)) + direction_reduce);
+
+    direction = clamp(direction * inverse_direction_min, 
+        vec2(-FXAA_SPAN_MAX, -FXAA_SPAN_MAX), 
+        vec2(FXAA_SPAN_MAX, FXAA_SPAN_MAX)) * texel_size;
+
+    vec3 rgb_a = 0.5f * (sampleScreen(direction * (1.0f / 3.0f - 0.5f)) +
+        sampleScreen(direction * (2.0f / 3.0f - 0.5f)));
+    vec3 rgb_b = rgb_a * 0.5f + 0.25f * (sampleScreen(direction * -0.5f) +
+        sampleScreen(direction * 0.5f));
+
+    // Wider blur crossed another edge, use the narrower one
+    float luma_b = luma(rgb_b);
+    if (luma_b < luma_min || luma_b > luma_max)
+        frag_color = vec4(rgb_a, 1.0f);
+    else
+        frag_color = vec4(rgb_b, 1.0f);
+}
\ No newline at end of file
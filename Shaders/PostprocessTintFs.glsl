@@ -0,0 +1,20 @@
+#version 330 core
+
+in VS_OUT
+{
+    vec2 tex_coord;
+} fs_in;
+
+out vec4 frag_color;
+
+uniform sampler2D screen_texture;
+// Last texel centre of part covered by scene
+uniform vec2 uv_max;
+uniform vec3 tint_color;
+
+void main()
+{
+    vec3 texel_color = texture(screen_texture, min(fs_in.tex_coord, 
+        uv_max)).rgb;
+    frag_color = vec4(texel_color * tint_color, 1.0f);
+}
\ No newline at end of file
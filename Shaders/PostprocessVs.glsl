@@ -8,8 +8,11 @@ out VS_OUT
     vec2 tex_coord;
 } vs_out;
 
+// Part of screen texture covered by rendered scene
+uniform vec2 uv_scale;
+
 void main()
 {
-    vs_out.tex_coord = tex_coord;
+    vs_out.tex_coord = tex_coord * uv_scale;
     gl_Position = vec4(position, 1.0f);
 }
\ No newline at end of file
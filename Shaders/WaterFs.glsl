@@ -6,7 +6,6 @@ struct Matrices
 {
     mat4 view_matrix;
     mat4 projection_matrix;
-    mat4 model_matrix;
 };
 
 struct Fog
@@ -35,10 +34,12 @@ struct PointLight
 in VS_OUT
 {
     vec2 texture_coords;
-    vec4 clip_space;
+    vec4 reflection_clip_space;
+    vec4 refraction_clip_space;
     vec3 to_camera_vector;
     vec3 position_VIEW;
     vec3 point_light_position_VIEW[POINT_LIGHTS_COUNT];
+    flat float move_factor;
 } fs_in;
 
 out vec4 frag_color;
@@ -54,7 +55,6 @@ uniform sampler2D depth_map;
 
 uniform float clip_near;
 uniform float clip_far;
-uniform float move_factor;
 
 uniform vec3 water_color;
 uniform float wave_strenght;
@@ -139,9 +139,12 @@ vec3 calculatePointLight(vec3 input_color, vec3 normal_vector, int light_index)
 
 void main()
 {
-    vec2 ndc = (fs_in.clip_space.xy / fs_in.clip_space.w) / 2.0f + 0.5f;
-    vec2 refract_tex_coords = ndc;
-    vec2 reflect_tex_coords = vec2(ndc.x, -ndc.y);
+    // Textures can be rendered in previous frames, so coordinates are
+    // calculated using matrices of the frame they were rendered in
+    vec2 reflect_tex_coords = (fs_in.reflection_clip_space.xy / 
+        fs_in.reflection_clip_space.w) / 2.0f + 0.5f;
+    vec2 refract_tex_coords = (fs_in.refraction_clip_space.xy / 
+        fs_in.refraction_clip_space.w) / 2.0f + 0.5f;
 
     // Soft edges
     float depth = texture(depth_map, refract_tex_coords).r;
@@ -150,7 +153,8 @@ void main()
         (clip_far + clip_near  - (2.0f * depth - 1.0f) * 
         (clip_far - clip_near));
 
-    depth = gl_FragCoord.z;
+    depth = (fs_in.refraction_clip_space.z / 
+        fs_in.refraction_clip_space.w) / 2.0f + 0.5f;
     float water_distance = 2.0f * clip_near * clip_far / 
         (clip_far + clip_near  - (2.0f * depth - 1.0f) * 
         (clip_far - clip_near));
@@ -160,9 +164,9 @@ void main()
     float water_depth = (floor_distance - water_distance) * 2.0f;
 
     vec2 distorted_tex_coords = texture(dudv_map, vec2(fs_in.texture_coords.x +
-        move_factor, fs_in.texture_coords.y)).rg * 0.1f;
+        fs_in.move_factor, fs_in.texture_coords.y)).rg * 0.1f;
     distorted_tex_coords = fs_in.texture_coords + vec2(distorted_tex_coords.x,
-        distorted_tex_coords.y + move_factor);
+        distorted_tex_coords.y + fs_in.move_factor);
     
     vec2 total_distortion = (texture(dudv_map, distorted_tex_coords).rg * 
         2.0f - 1.0f) * wave_strenght * clamp(water_depth / 2.5f, 0.0f, 1.0f);
@@ -171,8 +175,7 @@ void main()
     refract_tex_coords = clamp(refract_tex_coords, 0.001f, 0.999f);
 
     reflect_tex_coords += total_distortion;
-    reflect_tex_coords.x = clamp(reflect_tex_coords.x, 0.001f, 0.999f);
-    reflect_tex_coords.y = clamp(reflect_tex_coords.y, -0.999f, 0.001f);
+    reflect_tex_coords = clamp(reflect_tex_coords, 0.001f, 0.999f);
 
     vec4 reflection_color = texture(reflection_texture, reflect_tex_coords);
     vec4 refraction_color = texture(refraction_texture, refract_tex_coords);
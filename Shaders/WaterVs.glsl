@@ -1,6 +1,7 @@
 #version 330 core
 
 #define POINT_LIGHTS_COUNT 4
+#define MAX_INSTANCES 32
 
 layout(location = 0) in vec3 position;
 
@@ -8,7 +9,6 @@ struct Matrices
 {
     mat4 view_matrix;
     mat4 projection_matrix;
-    mat4 model_matrix;
 };
 
 struct PointLight
@@ -23,13 +23,19 @@ struct PointLight
 out VS_OUT
 {
     vec2 texture_coords;
-    vec4 clip_space;
+    vec4 reflection_clip_space;
+    vec4 refraction_clip_space;
     vec3 to_camera_vector;
     vec3 position_VIEW;
     vec3 point_light_position_VIEW[POINT_LIGHTS_COUNT];
+    flat float move_factor;
 } vs_out;
 
 uniform Matrices matrices;
+uniform mat4 reflection_matrix;
+uniform mat4 refraction_matrix;
+uniform mat4 model_matrices[MAX_INSTANCES];
+uniform float move_factors[MAX_INSTANCES];
 uniform int texture_tiling;
 uniform vec3 camera_position;
 
@@ -38,16 +44,17 @@ uniform int used_point_lights_count;
 
 void main()
 {
-    vec3 world_pos = vec3(matrices.model_matrix * vec4(position.x, position.y, 
-        position.z, 1.0f));
+    vec3 world_pos = vec3(model_matrices[gl_InstanceID] * vec4(position.x, 
+        position.y, position.z, 1.0f));
 
     vs_out.texture_coords = vec2(position.x / 2.0f + 0.5f, 
         position.z / 2.0f + 0.5f) * texture_tiling;
     vs_out.to_camera_vector = camera_position - world_pos;
+    vs_out.move_factor = move_factors[gl_InstanceID];
 
     vs_out.position_VIEW =  vec3(matrices.view_matrix * vec4(world_pos, 1.0f));
-    vs_out.clip_space = matrices.projection_matrix * 
-        vec4(vs_out.position_VIEW, 1.0f);
+    vs_out.reflection_clip_space = reflection_matrix * vec4(world_pos, 1.0f);
+    vs_out.refraction_clip_space = refraction_matrix * vec4(world_pos, 1.0f);
 
     for (int i = 0; i < used_point_lights_count; i++)
     {
@@ -55,5 +62,6 @@ void main()
             vec4(point_lights[i].position, 1.0f));
     }
 
-    gl_Position = vs_out.clip_space;
+    gl_Position = matrices.projection_matrix * 
+        vec4(vs_out.position_VIEW, 1.0f);
 }
\ No newline at end of file
@@ -148,6 +148,36 @@ void CameraBox::recalculateSpace(const glm::mat4 &space_matrix)
     }
 }
 
+std::vector<glm::vec3> CameraBox::calculateSliceCorners(GLfloat distance_near,
+    GLfloat distance_far) const
+{
+    // Returns world space corners of the camera frustum part placed between
+    // given distances. Corners are calculated in view space and transformed
+    // with inverted view matrix.
+
+    if (distance_near < 0.0f || distance_far <= distance_near)
+        logErrorAndThrow(name_, "CameraBox::calculateSliceCorners()",
+            "Slice distance value out of range: {0.0 <= NEAR < FAR}.");
+
+    std::vector<glm::vec3> corners;
+    GLfloat tan_half_fov = std::tan(fov_ / 2.0f);
+
+    for (GLfloat distance : {distance_near, distance_far})
+    {
+        GLfloat half_height = distance * tan_half_fov;
+        GLfloat half_width = half_height * aspect_;
+
+        for (GLfloat x : {-half_width, half_width})
+        {
+            for (GLfloat y : {-half_height, half_height})
+                corners.push_back(glm::vec3(view_matrix_inverted_ *
+                    glm::vec4(x, y, -distance, 1.0f)));
+        }
+    }
+
+    return corners;
+}
+
 void CameraBox::setCameraParameters(GLfloat distance_near, GLfloat aspect,
     GLfloat fov)
 {
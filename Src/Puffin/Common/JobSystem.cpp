@@ -0,0 +1,353 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#include "Puffin/Common/JobSystem.h"
+
+using namespace puffin;
+
+namespace
+{
+    // Workers push jobs scheduled by them to their own queue
+    thread_local const JobSystem *current_job_system = nullptr;
+    thread_local GLint current_worker_index = -1;
+}
+
+JobSystem::JobSystem(GLint workers_count)
+{
+    if (workers_count < 0)
+        logErrorAndThrow(name_, "JobSystem::JobSystem()",
+            "Workers count value out of range: {0 <= VALUE}.");
+
+    // Thread which creates job system executes jobs while waiting
+    if (workers_count == 0)
+    {
+        workers_count = std::max(static_cast<GLint>(
+            std::thread::hardware_concurrency()) - 1, 1);
+    }
+
+    main_thread_id_ = std::this_thread::get_id();
+
+    for (GLint i = 0; i < workers_count; i++)
+        worker_queues_.emplace_back(new WorkerQueue());
+
+    for (GLint i = 0; i < workers_count; i++)
+        workers_.emplace_back(&JobSystem::workerThread, this, i);
+
+    logDebug(name_, "JobSystem::JobSystem()", "Job system created with [" +
+        std::to_string(workers_count) + "] workers.");
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        running_ = false;
+    }
+
+    sleep_condition_.notify_all();
+
+    for (auto &worker : workers_)
+        worker.join();
+
+    logDebug(name_, "JobSystem::~JobSystem()", "Job system destroyed.");
+}
+
+JobPtr JobSystem::schedule(JobFunction function,
+    const std::vector<JobPtr> &dependencies)
+{
+    return createJob(function, false, dependencies);
+}
+
+JobPtr JobSystem::scheduleOnMainThread(JobFunction function,
+    const std::vector<JobPtr> &dependencies)
+{
+    return createJob(function, true, dependencies);
+}
+
+JobPtr JobSystem::createJob(JobFunction function, GLboolean main_thread,
+    const std::vector<JobPtr> &dependencies)
+{
+    if (!function)
+        logErrorAndThrow(name_, "JobSystem::createJob()",
+            "Specified empty job function pointer.");
+
+    JobPtr job(new Job());
+    job->function_ = function;
+    job->main_thread_ = main_thread;
+
+    // Extra dependency prevents queueing before all dependencies are added
+    job->unfinished_dependencies_ = 1;
+
+    for (const auto &dependency : dependencies)
+    {
+        if (!dependency)
+            logErrorAndThrow(name_, "JobSystem::createJob()",
+                "Object [Job] pointer not set.");
+
+        std::lock_guard<std::mutex> lock(dependency->dependents_mutex_);
+        if (!dependency->finished_)
+        {
+            job->unfinished_dependencies_++;
+            dependency->dependents_.push_back(job);
+        }
+    }
+
+    if (--job->unfinished_dependencies_ == 0)
+        enqueue(job);
+
+    return job;
+}
+
+void JobSystem::enqueue(JobPtr job)
+{
+    if (job->main_thread_)
+    {
+        std::lock_guard<std::mutex> lock(main_thread_mutex_);
+        main_thread_jobs_.push_back(job);
+        return;
+    }
+
+    GLint queue_index = 0;
+    if (current_job_system == this)
+        queue_index = current_worker_index;
+    else
+        queue_index = next_queue_++ % worker_queues_.size();
+
+    {
+        std::lock_guard<std::mutex> lock(worker_queues_[queue_index]->mutex);
+        worker_queues_[queue_index]->jobs.push_back(job);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        queued_jobs_++;
+    }
+
+    sleep_condition_.notify_one();
+}
+
+void JobSystem::execute(JobPtr job)
+{
+    // Job always finishes, so waiters and dependents are not blocked
+    try
+    {
+        job->function_();
+    }
+    catch (...)
+    {
+        job->exception_ = std::current_exception();
+    }
+
+    std::vector<JobPtr> dependents;
+    {
+        std::lock_guard<std::mutex> lock(job->dependents_mutex_);
+        job->finished_ = true;
+        dependents.swap(job->dependents_);
+    }
+
+    for (const auto &dependent : dependents)
+    {
+        if (--dependent->unfinished_dependencies_ == 0)
+            enqueue(dependent);
+    }
+}
+
+JobPtr JobSystem::popJob(GLint worker_index)
+{
+    auto &queue = *worker_queues_[worker_index];
+
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty())
+        return nullptr;
+
+    // Newest job uses data which is still in cache
+    auto job = queue.jobs.back();
+    queue.jobs.pop_back();
+    queued_jobs_--;
+    return job;
+}
+
+JobPtr JobSystem::stealJob(GLint worker_index)
+{
+    GLint queues_count = static_cast<GLint>(worker_queues_.size());
+    for (GLint i = 1; i <= queues_count; i++)
+    {
+        auto &queue = *worker_queues_[(worker_index + i) % queues_count];
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty())
+            continue;
+
+        // Oldest job is usually the biggest part of work left
+        auto job = queue.jobs.front();
+        queue.jobs.pop_front();
+        queued_jobs_--;
+        return job;
+    }
+
+    return nullptr;
+}
+
+JobPtr JobSystem::popMainThreadJob()
+{
+    std::lock_guard<std::mutex> lock(main_thread_mutex_);
+    if (main_thread_jobs_.empty())
+        return nullptr;
+
+    auto job = main_thread_jobs_.front();
+    main_thread_jobs_.pop_front();
+    return job;
+}
+
+GLboolean JobSystem::executeNextJob()
+{
+    JobPtr job = nullptr;
+
+    GLboolean is_worker = current_job_system == this;
+    if (is_worker)
+        job = popJob(current_worker_index);
+
+    if (!job && std::this_thread::get_id() == main_thread_id_)
+        job = popMainThreadJob();
+
+    if (!job)
+        job = stealJob(is_worker ? current_worker_index : 0);
+
+    if (!job)
+        return false;
+
+    execute(job);
+    return true;
+}
+
+void JobSystem::wait(JobPtr job)
+{
+    if (!job)
+        logErrorAndThrow(name_, "JobSystem::wait()",
+            "Object [Job] pointer not set.");
+
+    while (!job->isFinished())
+    {
+        if (!executeNextJob())
+            std::this_thread::yield();
+    }
+
+    if (job->exception_)
+        std::rethrow_exception(job->exception_);
+}
+
+void JobSystem::wait(const std::vector<JobPtr> &jobs)
+{
+    std::exception_ptr exception = nullptr;
+    for (const auto &job : jobs)
+    {
+        try
+        {
+            wait(job);
+        }
+        catch (...)
+        {
+            if (!exception)
+                exception = std::current_exception();
+        }
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void JobSystem::parallelFor(GLuint count, JobRangeFunction function,
+    GLuint batch_size)
+{
+    if (!function)
+        logErrorAndThrow(name_, "JobSystem::parallelFor()",
+            "Specified empty job function pointer.");
+
+    if (count == 0)
+        return;
+
+    // Few batches per thread let fast threads take work of slow ones
+    if (batch_size == 0)
+    {
+        GLuint batches_count = (workers_.size() + 1) * 4;
+        batch_size = (count + batches_count - 1) / batches_count;
+        if (batch_size < min_batch_size_)
+            batch_size = min_batch_size_;
+    }
+
+    // Not worth scheduling
+    if (count <= batch_size)
+    {
+        function(0, count);
+        return;
+    }
+
+    // Calling thread processes first batch itself
+    std::vector<JobPtr> jobs;
+    for (GLuint begin = batch_size; begin < count; begin += batch_size)
+    {
+        GLuint end = std::min(begin + batch_size, count);
+        jobs.push_back(schedule([function, begin, end]()
+        {
+            function(begin, end);
+        }));
+    }
+
+    std::exception_ptr exception = nullptr;
+    try
+    {
+        function(0, batch_size);
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    // Batches may use data of caller's stack, so they have to finish
+    // before exception leaves
+    try
+    {
+        wait(jobs);
+    }
+    catch (...)
+    {
+        if (!exception)
+            exception = std::current_exception();
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void JobSystem::runMainThreadJobs()
+{
+    if (std::this_thread::get_id() != main_thread_id_)
+        logErrorAndThrow(name_, "JobSystem::runMainThreadJobs()",
+            "Main thread jobs executed by other thread.");
+
+    while (auto job = popMainThreadJob())
+        execute(job);
+}
+
+void JobSystem::workerThread(GLint worker_index)
+{
+    current_job_system = this;
+    current_worker_index = worker_index;
+
+    while (true)
+    {
+        if (executeNextJob())
+            continue;
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_condition_.wait(lock, [this]()
+        {
+            return queued_jobs_ > 0 || !running_;
+        });
+
+        if (!running_)
+            break;
+    }
+}
\ No newline at end of file
@@ -19,7 +19,8 @@ Display::Display(DisplayConfigurationPtr display_configuration, SystemPtr system
 
     width_ = display_configuration->getWidth();
     height_ = display_configuration->getHeight();
-    msaa_samples_ = display_configuration->getMsaaSamples();
+    msaa_samples_ = display_configuration->isMultisamplingEnabled() ?
+        display_configuration->getMsaaSamples() : 0;
     fullscreen_ = display_configuration->isFullscreen();
 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
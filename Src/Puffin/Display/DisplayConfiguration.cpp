@@ -67,6 +67,18 @@ void DisplayConfiguration::configure(GLint width, GLint height,
     fullscreen_ = fullscreen;
 }
 
+void DisplayConfiguration::setAntialiasingMode(AntialiasingMode mode)
+{
+    if (blocked_)
+    {
+        logWarning(name_, "DisplayConfiguration::setAntialiasingMode()",
+            "Cannot change display configuration at runtime.");
+        return;
+    }
+
+    antialiasing_mode_ = mode;
+}
+
 GLboolean DisplayConfiguration::checkIntValue(GLint value,
     std::vector<GLint> allowed_values) const
 {
@@ -10,6 +10,7 @@ using namespace puffin;
 void EngineCore::initialize()
 {
     system_.reset(new System());
+    job_system_.reset(new JobSystem());
     display_configuration_.reset(new DisplayConfiguration(system_));
 }
 
@@ -25,10 +26,10 @@ void EngineCore::createDisplay(std::string window_caption)
     state_machine_->faceCulling()->enable(true);
 
     master_manager_.reset(new MasterManager(display_configuration_,
-        state_machine_));
+        state_machine_, system_));
     main_camera_.reset(new Camera("main_camera"));
     master_renderer_.reset(new MasterRenderer(master_manager_, state_machine_,
-        display_, display_configuration_));
+        display_, display_configuration_, job_system_));
 }
 
 void EngineCore::start()
@@ -138,6 +138,78 @@ void FrameBufferManager::addCubeMapDepthBuffer(FrameBufferPtr frame_buffer,
         frame_buffer->cube_buffer_texture_->handle_, 0);
 }
 
+void FrameBufferManager::setCubeMapDepthBufferFace(FrameBufferPtr frame_buffer,
+    TexturePtr cube_texture, GLint face)
+{
+    // Attaches single face of existing cube texture, so it can be cleared or
+    // rendered separately
+
+    if (!frame_buffer)
+        logErrorAndThrow(name_,
+            "FrameBufferManager::setCubeMapDepthBufferFace()",
+            "Object [FrameBuffer] pointer not set.");
+
+    if (!cube_texture || cube_texture->getType() != TextureType::TEXTURE_CUBE)
+        logErrorAndThrow(name_,
+            "FrameBufferManager::setCubeMapDepthBufferFace()",
+            "Object [Texture] pointer not set or invalid texture type.");
+
+    if (face < 0 || face >= 6)
+        logErrorAndThrow(name_,
+            "FrameBufferManager::setCubeMapDepthBufferFace()",
+            "Cube face value out of range: {0 <= VALUE < 6}.");
+
+    state_machine_->bindFrameBuffer(frame_buffer);
+
+    frame_buffer->cube_buffer_texture_ = cube_texture;
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+        GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, cube_texture->handle_, 0);
+}
+
+void FrameBufferManager::addDepthArrayBuffer(FrameBufferPtr frame_buffer,
+    GLint size, GLint layers)
+{
+    if (!frame_buffer)
+        logErrorAndThrow(name_, "FrameBufferManager::addDepthArrayBuffer()",
+            "Object [FrameBuffer] pointer not set.");
+
+    if (size <= 0 || layers <= 0)
+        logErrorAndThrow(name_, "FrameBufferManager::addDepthArrayBuffer()",
+            "Depth array buffer size value out of range: {0 < VALUE}.");
+
+    state_machine_->bindFrameBuffer(frame_buffer);
+
+    frame_buffer->depth_array_texture_ = texture_manager_->
+        createTextureDepthArray(size, layers);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+        frame_buffer->depth_array_texture_->handle_, 0, 0);
+}
+
+void FrameBufferManager::setDepthArrayBufferLayer(FrameBufferPtr frame_buffer,
+    GLint layer)
+{
+    if (!frame_buffer)
+        logErrorAndThrow(name_,
+            "FrameBufferManager::setDepthArrayBufferLayer()",
+            "Object [FrameBuffer] pointer not set.");
+
+    if (!frame_buffer->depth_array_texture_)
+        logErrorAndThrow(name_,
+            "FrameBufferManager::setDepthArrayBufferLayer()",
+            "Frame buffer has no depth array buffer.");
+
+    if (layer < 0 || layer >= frame_buffer->depth_array_texture_->
+        getLayersCount())
+        logErrorAndThrow(name_,
+            "FrameBufferManager::setDepthArrayBufferLayer()",
+            "Depth array buffer layer value out of range: "
+            "{0 <= VALUE < LAYERS_COUNT}.");
+
+    state_machine_->bindFrameBuffer(frame_buffer);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+        frame_buffer->depth_array_texture_->handle_, 0, layer);
+}
+
 void FrameBufferManager::disableDrawBuffer(FrameBufferPtr frame_buffer)
 {
     if (!frame_buffer)
@@ -8,7 +8,8 @@
 using namespace puffin;
 
 MasterManager::MasterManager(DisplayConfigurationPtr display_configuration,
-    StateMachinePtr state_machine) : BaseManager("core_master_manager")
+    StateMachinePtr state_machine, SystemPtr system) :
+    BaseManager("core_master_manager")
 {
     if (!display_configuration)
         logErrorAndThrow(name_, "MasterManager::MasterManager()",
@@ -18,12 +19,16 @@ MasterManager::MasterManager(DisplayConfigurationPtr display_configuration,
         logErrorAndThrow(name_, "MasterManager::MasterManager()",
             "Object [StateMachine] pointer not set.");
 
+    if (!system)
+        logErrorAndThrow(name_, "MasterManager::MasterManager()",
+            "Object [System] pointer not set.");
+
     display_configuration_ = display_configuration;
     state_machine_ = state_machine;
 
     light_manager_.reset(new LightManager());
     scene_manager_.reset(new SceneManager());
-    shader_manager_.reset(new ShaderManager(state_machine_));
+    shader_manager_.reset(new ShaderManager(state_machine_, system));
     texture_manager_.reset(new TextureManager(state_machine_,
         display_configuration_));
     ui_manager_.reset(new UiManager());
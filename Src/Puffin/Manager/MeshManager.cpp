@@ -326,6 +326,39 @@ WaterTilePtr MeshManager::createWaterTile(std::string dudv_texture,
     return tile;
 }
 
+void MeshManager::calculateBoundingSphere(BaseMeshPtr mesh,
+    const std::vector<GLfloat> &positions) const
+{
+    if (positions.size() < 3)
+    {
+        mesh->bounding_sphere_center_ = glm::vec3(0.0f, 0.0f, 0.0f);
+        mesh->bounding_sphere_radius_ = 0.0f;
+        return;
+    }
+
+    glm::vec3 min(positions[0], positions[1], positions[2]);
+    glm::vec3 max = min;
+
+    for (std::size_t i = 0; i + 2 < positions.size(); i += 3)
+    {
+        glm::vec3 point(positions[i], positions[i + 1], positions[i + 2]);
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    glm::vec3 center = (min + max) / 2.0f;
+
+    GLfloat radius = 0.0f;
+    for (std::size_t i = 0; i + 2 < positions.size(); i += 3)
+    {
+        glm::vec3 point(positions[i], positions[i + 1], positions[i + 2]);
+        radius = std::max(radius, glm::length(point - center));
+    }
+
+    mesh->bounding_sphere_center_ = center;
+    mesh->bounding_sphere_radius_ = radius;
+}
+
 void MeshManager::setMeshData(BaseMeshPtr mesh, std::vector<GLfloat> data,
     VertexDataType vertex_data_type, GLboolean dynamic_draw)
 {
@@ -351,6 +384,8 @@ void MeshManager::setMeshData(BaseMeshPtr mesh, std::vector<GLfloat> data,
             glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
             glEnableVertexAttribArray(0);
         }
+
+        calculateBoundingSphere(mesh, data);
         break;
     case VertexDataType::TEXTURE_COORD:
         glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(GLfloat),
@@ -7,14 +7,40 @@
 
 using namespace puffin;
 
-ShaderManager::ShaderManager(StateMachinePtr state_machine) :
-    BaseManager("core_shader_manager")
+ShaderManager::ShaderManager(StateMachinePtr state_machine,
+    SystemPtr system) : BaseManager("core_shader_manager")
 {
     if (!state_machine)
         logErrorAndThrow(name_, "ShaderManager::ShaderManager()",
             "Object [StateMachine] pointer not set.");
 
+    if (!system)
+        logErrorAndThrow(name_, "ShaderManager::ShaderManager()",
+            "Object [System] pointer not set.");
+
     state_machine_ = state_machine;
+    system_ = system;
+
+    GLint formats_count = 0;
+    if (GLEW_ARB_get_program_binary)
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats_count);
+
+    binary_cache_supported_ = formats_count > 0;
+    if (!binary_cache_supported_)
+        logInfo(name_, "ShaderManager::ShaderManager()",
+            "Shader program binaries not supported, cache disabled.");
+
+    // Driver compiles in background threads, status can be polled
+    if (GLEW_KHR_parallel_shader_compile)
+    {
+        glMaxShaderCompilerThreadsKHR(0xffffffff);
+        parallel_compile_supported_ = true;
+    }
+    else if (GLEW_ARB_parallel_shader_compile)
+    {
+        glMaxShaderCompilerThreadsARB(0xffffffff);
+        parallel_compile_supported_ = true;
+    }
 
     logDebug(name_, "ShaderManager::ShaderManager()",
         "Shader manager created.");
@@ -27,89 +53,386 @@ ShaderManager::~ShaderManager()
 }
 
 ShaderProgramPtr ShaderManager::createShaderProgram(std::string program_name,
-    std::string vs_path, std::string fs_path, std::string gs_path)
+    std::string vs_path, std::string fs_path, std::string gs_path,
+    const std::vector<std::string> &defines)
+{
+    auto shader_program = submitShaderProgram(program_name, vs_path, fs_path,
+        gs_path, defines);
+    finishShaderProgram(shader_program);
+
+    return shader_program;
+}
+
+ShaderProgramPtr ShaderManager::createShaderProgramAsync(
+    std::string program_name, std::string vs_path, std::string fs_path,
+    std::string gs_path, const std::vector<std::string> &defines)
+{
+    return submitShaderProgram(program_name, vs_path, fs_path, gs_path,
+        defines);
+}
+
+GLboolean ShaderManager::isShaderProgramReady(ShaderProgramPtr shader_program)
+{
+    if (!shader_program)
+        logErrorAndThrow(name_, "ShaderManager::isShaderProgramReady()",
+            "Object [ShaderProgram] pointer not set.");
+
+    if (!shader_program->pending_)
+        return true;
+
+    // Without parallel compile status query would block anyway
+    if (parallel_compile_supported_)
+    {
+        GLint completed = GL_FALSE;
+        glGetProgramiv(shader_program->handle_, GL_COMPLETION_STATUS_KHR,
+            &completed);
+        if (completed != GL_TRUE)
+            return false;
+    }
+
+    finishShaderProgram(shader_program);
+    return true;
+}
+
+void ShaderManager::finishShaderPrograms()
+{
+    // Finished program is removed from container
+    while (!pending_programs_.empty())
+        finishShaderProgram(pending_programs_.back());
+}
+
+ShaderProgramPtr ShaderManager::submitShaderProgram(std::string program_name,
+    std::string vs_path, std::string fs_path, std::string gs_path,
+    const std::vector<std::string> &defines)
 {
     if (program_name.empty())
-        logErrorAndThrow(name_, "ShaderManager::createShaderProgram()",
+        logErrorAndThrow(name_, "ShaderManager::submitShaderProgram()",
             "Empty shader program name.");
 
     if (vs_path.empty() || fs_path.empty())
-        logErrorAndThrow(name_, "ShaderManager::createShaderProgram()",
+        logErrorAndThrow(name_, "ShaderManager::submitShaderProgram()",
             "Empty shader file path.");
 
     ShaderProgramPtr shader_program(new ShaderProgram(gs_path.empty() ? false :
         true, program_name));
 
-    std::vector<GLint> shaders = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+    std::vector<std::string> files = {vs_path, fs_path};
     if (shader_program->handle_gs_)
-        shaders.push_back(GL_GEOMETRY_SHADER);
+        files.push_back(gs_path);
 
-    for (const auto &type : shaders)
+    std::vector<std::string> sources;
+    for (const auto &file : files)
     {
-        GLuint *handle_ptr = nullptr;
-        std::string *file_ptr = nullptr;
-        if (type == GL_VERTEX_SHADER)
-        {
-            handle_ptr = &shader_program->handle_vs_;
-            file_ptr = &vs_path;
-        }
-        else if (type == GL_FRAGMENT_SHADER)
-        {
-            handle_ptr = &shader_program->handle_fs_;
-            file_ptr = &fs_path;
-        }
-        else if (type == GL_GEOMETRY_SHADER)
+        std::string shader_data;
+        if (loadShaderCode(file, shader_data))
+            logErrorAndThrow(name_, "ShaderManager::submitShaderProgram()",
+                "Opening shader file [" + file + "] error.");
+
+        logInfo(name_, "ShaderManager::submitShaderProgram()",
+            "Shader file [" + file + "] loaded.");
+
+        sources.push_back(injectDefines(shader_data, defines));
+    }
+
+    shader_program_container_.push_back(shader_program);
+
+    std::string binary_path;
+    if (isBinaryCacheEnabled())
+    {
+        binary_path = getBinaryCachePath(program_name, sources);
+        if (!loadProgramBinary(shader_program, binary_path))
         {
-            handle_ptr = &shader_program->handle_gs_;
-            file_ptr = &gs_path;
+            logInfo(name_, "ShaderManager::submitShaderProgram()",
+                "Shader program [" + program_name + "] loaded from binary [" +
+                binary_path + "].");
+
+            releaseShaders(shader_program);
+            shader_program->fetchUniforms();
+            return shader_program;
         }
+    }
 
-        std::string shader_data;
-        if (loadShaderCode(*file_ptr, shader_data))
-            logErrorAndThrow(name_, "ShaderManager::createShaderProgram()",
-                "Opening shader file [" + *file_ptr + "] error.");
+    // Statuses are not queried here, so driver can compile many programs
+    // at once. They are checked when program is finished.
+    GLuint handles[] = {shader_program->handle_vs_,
+        shader_program->handle_fs_, shader_program->handle_gs_};
+    for (std::size_t i = 0; i < sources.size(); i++)
+    {
+        const GLchar *shader_code = sources[i].c_str();
+        glShaderSource(handles[i], 1, &shader_code, nullptr);
+        compileShader(handles[i]);
+    }
+
+    if (!binary_path.empty())
+    {
+        glProgramParameteri(shader_program->handle_,
+            GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
 
-        logInfo(name_, "ShaderManager::createShaderProgram()",
-            "Shader file [" + *file_ptr + "] loaded.");
+    linkProgram(shader_program);
 
-        const GLchar *shader_code = shader_data.c_str();
-        glShaderSource(*handle_ptr, 1, &shader_code, nullptr);
+    shader_program->pending_ = true;
+    shader_program->shader_files_ = files;
+    shader_program->binary_path_ = binary_path;
+    pending_programs_.push_back(shader_program);
 
-        GLint result = compileShader(*handle_ptr);
-        logInfo(name_, "ShaderManager::createShaderProgram()", "Shader file [" +
-            *file_ptr + "] compile message:\n" +
-            getShaderCompileMessage(*handle_ptr));
+    return shader_program;
+}
+
+void ShaderManager::finishShaderProgram(ShaderProgramPtr shader_program)
+{
+    if (!shader_program->pending_)
+        return;
 
-        if (result)
-            logError(name_, "ShaderManager::createShaderProgram()",
-                "Shader file [" + *file_ptr + "] compile error.");
+    if (shader_program->link_failed_)
+        logErrorAndThrow(name_, "ShaderManager::finishShaderProgram()",
+            "Shader program [" + shader_program->getName() + "] link error.");
 
-        logInfo(name_, "ShaderManager::createShaderProgram()",
-            "Shader file [" + *file_ptr + "] compile success.");
+    const auto &files = shader_program->shader_files_;
+    GLuint handles[] = {shader_program->handle_vs_,
+        shader_program->handle_fs_, shader_program->handle_gs_};
+    for (std::size_t i = 0; i < files.size(); i++)
+    {
+        logInfo(name_, "ShaderManager::finishShaderProgram()",
+            "Shader file [" + files[i] + "] compile message:\n" +
+            getShaderCompileMessage(handles[i]));
+
+        if (checkShaderCompileStatus(handles[i]))
+            logError(name_, "ShaderManager::finishShaderProgram()",
+                "Shader file [" + files[i] + "] compile error.");
+        else
+            logInfo(name_, "ShaderManager::finishShaderProgram()",
+                "Shader file [" + files[i] + "] compile success.");
     }
 
-    if (linkProgram(shader_program))
-        logErrorAndThrow(name_, "ShaderManager::createShaderProgram()",
-            "Shader program [" + program_name + "] link error.");
+    // Failed program leaves container too, so it does not block finishing
+    // other ones
+    GLboolean link_failed = checkProgramLinkStatus(shader_program) != 0;
+    shader_program->link_failed_ = link_failed;
+    shader_program->pending_ = link_failed;
+    pending_programs_.erase(std::remove(pending_programs_.begin(),
+        pending_programs_.end(), shader_program), pending_programs_.end());
+
+    if (link_failed)
+        logErrorAndThrow(name_, "ShaderManager::finishShaderProgram()",
+            "Shader program [" + shader_program->getName() + "] link "
+            "error:\n" + getProgramLinkMessage(shader_program));
+
+    logInfo(name_, "ShaderManager::finishShaderProgram()",
+        "Shader program [" + shader_program->getName() + "] link success.");
 
-    logInfo(name_, "ShaderManager::createShaderProgram()",
-        "Shader program [" + program_name + "] link success.");
+    if (!shader_program->binary_path_.empty())
+        saveProgramBinary(shader_program, shader_program->binary_path_);
 
     shader_program->fetchUniforms();
+}
+
+ShaderVariantsPtr ShaderManager::createShaderVariants(
+    std::string variants_name, std::string vs_path, std::string fs_path,
+    std::string gs_path, const std::vector<std::string> &features)
+{
+    if (variants_name.empty())
+        logErrorAndThrow(name_, "ShaderManager::createShaderVariants()",
+            "Empty shader variants name.");
+
+    if (vs_path.empty() || fs_path.empty())
+        logErrorAndThrow(name_, "ShaderManager::createShaderVariants()",
+            "Empty shader file path.");
+
+    ShaderVariantsPtr shader_variants(new ShaderVariants(variants_name,
+        vs_path, fs_path, gs_path, features));
+    return shader_variants;
+}
+
+ShaderProgramPtr ShaderManager::getShaderVariant(
+    ShaderVariantsPtr shader_variants, GLuint features_mask)
+{
+    // Variant is compiled on first use
+    auto shader_program = requestShaderVariant(shader_variants,
+        features_mask);
+    finishShaderProgram(shader_program);
 
-    shader_program_container_.push_back(shader_program);
     return shader_program;
 }
 
-GLint ShaderManager::compileShader(GLuint shader_handle) const
+ShaderProgramPtr ShaderManager::requestShaderVariant(
+    ShaderVariantsPtr shader_variants, GLuint features_mask)
 {
-    glCompileShader(shader_handle);
-    if (checkShaderCompileStatus(shader_handle))
+    if (!shader_variants)
+        logErrorAndThrow(name_, "ShaderManager::requestShaderVariant()",
+            "Object [ShaderVariants] pointer not set.");
+
+    auto shader_program = shader_variants->getProgram(features_mask);
+    if (shader_program)
+        return shader_program;
+
+    shader_program = createShaderProgramAsync(shader_variants->name_ + "_" +
+        std::to_string(features_mask), shader_variants->vs_path_,
+        shader_variants->fs_path_, shader_variants->gs_path_,
+        shader_variants->getDefines(features_mask));
+
+    shader_variants->programs_[features_mask] = shader_program;
+    return shader_program;
+}
+
+std::string ShaderManager::injectDefines(const std::string &shader_code,
+    const std::vector<std::string> &defines) const
+{
+    if (defines.empty())
+        return shader_code;
+
+    std::string defines_code;
+    for (const auto &define : defines)
+        defines_code += "#define " + define + "\n";
+
+    // #version has to be the first directive in shader
+    std::string result = shader_code;
+    std::size_t position = 0;
+    if (result.compare(0, 8, "#version") == 0)
+    {
+        position = result.find('\n');
+        if (position == std::string::npos)
+        {
+            result += "\n";
+            position = result.size() - 1;
+        }
+
+        position++;
+    }
+
+    result.insert(position, defines_code);
+    return result;
+}
+
+std::string ShaderManager::getBinaryCachePath(std::string program_name,
+    const std::vector<std::string> &sources) const
+{
+    // Driver may reject binaries built by other version, so its
+    // identification is a part of the key
+    std::vector<std::string> key_parts = sources;
+    key_parts.push_back(system_->getGpuVendor());
+    key_parts.push_back(system_->getGpuName());
+    key_parts.push_back(system_->getGlVersion());
+
+    // 64-bit FNV-1a
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const auto &part : key_parts)
+    {
+        for (const auto &c : part)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+
+        // Separator, so parts boundaries affect hash
+        hash ^= 0xff;
+        hash *= 1099511628211ULL;
+    }
+
+    std::stringstream path;
+    path << binary_cache_directory_ << "/" << program_name << "_" <<
+        std::hex << hash << ".bin";
+    return path.str();
+}
+
+GLint ShaderManager::loadProgramBinary(ShaderProgramPtr shader_program,
+    std::string file_path) const
+{
+    std::ifstream binary_file(file_path, std::ios::in | std::ios::binary);
+    if (!binary_file.is_open())
         return -1;
 
+    GLenum format = 0;
+    binary_file.read(reinterpret_cast<char*>(&format), sizeof(format));
+
+    std::vector<char> binary((std::istreambuf_iterator<char>(binary_file)),
+        std::istreambuf_iterator<char>());
+    binary_file.close();
+
+    if (binary.empty())
+        return -1;
+
+    glProgramBinary(shader_program->handle_, format, binary.data(),
+        static_cast<GLsizei>(binary.size()));
+
+    if (checkProgramLinkStatus(shader_program))
+    {
+        logInfo(name_, "ShaderManager::loadProgramBinary()",
+            "Shader program binary [" + file_path + "] rejected by driver. "
+            "Recompiling.");
+        return -1;
+    }
+
     return 0;
 }
 
+void ShaderManager::saveProgramBinary(ShaderProgramPtr shader_program,
+    std::string file_path) const
+{
+    GLint binary_size = 0;
+    glGetProgramiv(shader_program->handle_, GL_PROGRAM_BINARY_LENGTH,
+        &binary_size);
+    if (binary_size <= 0)
+        return;
+
+    GLenum format = 0;
+    std::vector<char> binary(binary_size);
+    glGetProgramBinary(shader_program->handle_, binary_size, nullptr, &format,
+        binary.data());
+
+    createBinaryCacheDirectory();
+
+    std::ofstream binary_file(file_path, std::ios::out | std::ios::binary |
+        std::ios::trunc);
+    if (binary_file.is_open())
+    {
+        binary_file.write(reinterpret_cast<const char*>(&format),
+            sizeof(format));
+        binary_file.write(binary.data(), binary.size());
+    }
+
+    if (!binary_file.is_open() || !binary_file.good())
+    {
+        logWarning(name_, "ShaderManager::saveProgramBinary()",
+            "Writing shader program binary [" + file_path + "] error.");
+        return;
+    }
+
+    logInfo(name_, "ShaderManager::saveProgramBinary()",
+        "Shader program binary [" + file_path + "] saved.");
+}
+
+void ShaderManager::createBinaryCacheDirectory() const
+{
+    // Failure is ignored, directory usually exists already. Write error is
+    // reported when binary is saved.
+#ifdef UNIX
+    mkdir(binary_cache_directory_.c_str(), 0755);
+#else
+    _mkdir(binary_cache_directory_.c_str());
+#endif // UNIX
+}
+
+void ShaderManager::releaseShaders(ShaderProgramPtr shader_program) const
+{
+    // Program loaded from binary does not use shader objects
+    GLuint *handles[] = {&shader_program->handle_vs_,
+        &shader_program->handle_fs_, &shader_program->handle_gs_};
+    for (auto handle : handles)
+    {
+        if (*handle)
+        {
+            glDeleteShader(*handle);
+            *handle = 0;
+        }
+    }
+}
+
+void ShaderManager::compileShader(GLuint shader_handle) const
+{
+    glCompileShader(shader_handle);
+}
+
 GLint ShaderManager::checkShaderCompileStatus(GLuint shader_handle) const
 {
     GLint shader_status = -1;
@@ -160,7 +483,7 @@ GLint ShaderManager::loadShaderCode(std::string file_path,
     return 0;
 }
 
-GLint ShaderManager::linkProgram(ShaderProgramPtr shader_program) const
+void ShaderManager::linkProgram(ShaderProgramPtr shader_program) const
 {
     glAttachShader(shader_program->handle_, shader_program->handle_vs_);
     glAttachShader(shader_program->handle_, shader_program->handle_fs_);
@@ -169,11 +492,6 @@ GLint ShaderManager::linkProgram(ShaderProgramPtr shader_program) const
         glAttachShader(shader_program->handle_, shader_program->handle_gs_);
 
     glLinkProgram(shader_program->handle_);
-
-    if (checkProgramLinkStatus(shader_program))
-        return -1;
-
-    return 0;
 }
 
 GLint ShaderManager::checkProgramLinkStatus(ShaderProgramPtr
@@ -185,4 +503,20 @@ GLint ShaderManager::checkProgramLinkStatus(ShaderProgramPtr
         return -1;
 
     return 0;
+}
+
+std::string ShaderManager::getProgramLinkMessage(
+    ShaderProgramPtr shader_program) const
+{
+    GLint log_size = 0;
+    glGetProgramiv(shader_program->handle_, GL_INFO_LOG_LENGTH, &log_size);
+
+    if (log_size <= 1)
+        return "[NO WARNINGS AND ERRORS]";
+
+    std::vector<GLchar> log_text(log_size);
+    glGetProgramInfoLog(shader_program->handle_, log_size, nullptr,
+        log_text.data());
+
+    return std::string(log_text.data());
 }
\ No newline at end of file
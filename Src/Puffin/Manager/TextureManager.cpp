@@ -42,6 +42,8 @@ void TextureManager::setDefaultTextureFilter()
         TextureFilter::BILINEAR;
     default_texture_filter_[TextureType::TEXTURE_CUBE] =
         TextureFilter::BILINEAR;
+    default_texture_filter_[TextureType::TEXTURE_2D_ARRAY] =
+        TextureFilter::BILINEAR;
 }
 
 TexturePtr TextureManager::loadTextureCube(std::array<std::string, 6> textures,
@@ -128,6 +130,32 @@ void TextureManager::setTextureWrap(TexturePtr texture,
             break;
         }
         break;
+    case TextureType::TEXTURE_2D_ARRAY:
+        switch (wrap_mode)
+        {
+        case TextureWrap::REPEAT:
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            break;
+        case TextureWrap::CLAMP_TO_BORDER:
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S,
+                GL_CLAMP_TO_BORDER);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T,
+                GL_CLAMP_TO_BORDER);
+            break;
+        case TextureWrap::CLAMP_TO_EDGE:
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S,
+                GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T,
+                GL_CLAMP_TO_EDGE);
+            break;
+        }
+        break;
+    case TextureType::TEXTURE_BUFFER:
+    case TextureType::TEXTURE_UNDEFINED:
+        logWarning(name_, "TextureManager::setTextureWrap()",
+            "Not supported texture wrap for this texture type.");
+        break;
     }
 }
 
@@ -171,10 +199,51 @@ void TextureManager::setTexture2DData(TexturePtr texture, GLubyte *data,
     texture->color_channels_ = channels;
 }
 
+void TextureManager::updateTexture2DData(TexturePtr texture,
+    const GLubyte *data, GLint x, GLint y, GLint width, GLint height)
+{
+    if (!texture || texture->getType() != TextureType::TEXTURE_2D)
+        logErrorAndThrow(name_, "TextureManager::updateTexture2DData()",
+            "Object [Texture] pointer not set or invalid texture type.");
+
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 ||
+        x + width > texture->getWidth() || y + height > texture->getHeight())
+        logErrorAndThrow(name_, "TextureManager::updateTexture2DData()",
+            "Texture region out of range.");
+
+    state_machine_->bindTexture(texture);
+
+    // Format was stored when texture data was set
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height,
+        texture->color_channels_, GL_UNSIGNED_BYTE, data);
+}
+
+void TextureManager::setTextureBufferData(TexturePtr texture,
+    const GLvoid *data, GLsizeiptr size)
+{
+    if (!texture || texture->getType() != TextureType::TEXTURE_BUFFER)
+        logErrorAndThrow(name_, "TextureManager::setTextureBufferData()",
+            "Object [Texture] pointer not set or invalid texture type.");
+
+    if (size < 0)
+        logErrorAndThrow(name_, "TextureManager::setTextureBufferData()",
+            "Buffer size value out of range: {0 <= VALUE}.");
+
+    // Buffer storage is reallocated, so driver does not wait for previous
+    // draws using old data
+    glBindBuffer(GL_TEXTURE_BUFFER, texture->buffer_handle_);
+    glBufferData(GL_TEXTURE_BUFFER, size, data, GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    texture->width_ = static_cast<GLint>(size / (texture->
+        getColorChannelsCount() * 4));
+}
+
 void TextureManager::setTexture2DBorderColor(TexturePtr texture,
     const glm::vec4 &color) const
 {
-    if (texture->getType() != TextureType::TEXTURE_2D)
+    if (texture->getType() != TextureType::TEXTURE_2D &&
+        texture->getType() != TextureType::TEXTURE_2D_ARRAY)
     {
         logWarning(name_, "TextureManager::setTexture2DBorderColor()",
             "Invalid texture type.");
@@ -188,7 +257,9 @@ void TextureManager::setTexture2DBorderColor(TexturePtr texture,
         glm::clamp(color.b, 0.0f, 1.0f),
         glm::clamp(color.a, 0.0f, 1.0f)};
 
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, border_color);
+    glTexParameterfv(texture->getType() == TextureType::TEXTURE_2D_ARRAY ?
+        GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR,
+        border_color);
 }
 
 void TextureManager::setTextureFilter(TexturePtr texture,
@@ -213,6 +284,27 @@ void TextureManager::setTextureFilter(TexturePtr texture,
         logWarning(name_, "TextureManager::setTextureFilter()",
             "Not supported texture filter for cube texture.");
         break;
+    case TextureType::TEXTURE_2D_ARRAY:
+        switch (texture_filter)
+        {
+        case TextureFilter::NEAREST:
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER,
+                GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER,
+                GL_NEAREST);
+            break;
+        case TextureFilter::BILINEAR:
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER,
+                GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER,
+                GL_LINEAR);
+            break;
+        default:
+            logWarning(name_, "TextureManager::setTextureFilter()",
+                "Not supported texture filter for texture array.");
+            break;
+        }
+        break;
     case TextureType::TEXTURE_2D:
     case TextureType::TEXTURE_2D_MULTISAMPLED:
         switch (texture_filter)
@@ -358,6 +450,34 @@ TexturePtr TextureManager::createTextureDepthBuffer(GLint width, GLint height,
     return texture;
 }
 
+TexturePtr TextureManager::createTextureDepthArray(GLint size, GLint layers,
+    std::string texture_name)
+{
+    if (size <= 0)
+        logErrorAndThrow(name_, "TextureManager::createTextureDepthArray()",
+            "Texture size value out of range: {0 < VALUE}.");
+
+    if (layers <= 0)
+        logErrorAndThrow(name_, "TextureManager::createTextureDepthArray()",
+            "Texture layers count value out of range: {0 < VALUE}.");
+
+    TexturePtr texture(new Texture(TextureType::TEXTURE_2D_ARRAY, size, size,
+        1, "", nullptr, texture_name));
+    texture->layers_ = layers;
+
+    state_machine_->bindTexture(texture);
+
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT, size, size,
+        layers, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+
+    setTextureFilter(texture, default_texture_filter_[texture->getType()]);
+    setTextureWrap(texture, TextureWrap::CLAMP_TO_BORDER);
+    setTexture2DBorderColor(texture, glm::vec4(1.0f, 0.0f, 0.0f, 0.0f));
+
+    texture_container_.push_back(texture);
+    return texture;
+}
+
 TexturePtr TextureManager::createTextureRgbBuffer(GLint width, GLint height,
     GLboolean multisample, std::string texture_name)
 {
@@ -388,13 +508,50 @@ TexturePtr TextureManager::createTextureRgbBuffer(GLint width, GLint height,
     return texture;
 }
 
+TexturePtr TextureManager::createTextureBuffer(TextureBufferFormat format,
+    std::string texture_name)
+{
+    GLenum internal_format = GL_R32UI;
+    GLint color_channels = 1;
+
+    switch (format)
+    {
+    case TextureBufferFormat::R32UI:
+        internal_format = GL_R32UI;
+        color_channels = 1;
+        break;
+    case TextureBufferFormat::RG32UI:
+        internal_format = GL_RG32UI;
+        color_channels = 2;
+        break;
+    case TextureBufferFormat::RGBA32F:
+        internal_format = GL_RGBA32F;
+        color_channels = 4;
+        break;
+    }
+
+    TexturePtr texture(new Texture(TextureType::TEXTURE_BUFFER, 0, 1,
+        color_channels, "", nullptr, texture_name));
+
+    glGenBuffers(1, &texture->buffer_handle_);
+    glBindBuffer(GL_TEXTURE_BUFFER, texture->buffer_handle_);
+    glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    state_machine_->bindTexture(texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, internal_format, texture->buffer_handle_);
+
+    texture_container_.push_back(texture);
+    return texture;
+}
+
 void TextureManager::setTextureSlot(GLint slot_index)
 {
     if (slot_index < 0)
         logErrorAndThrow(name_, "TextureManager::setTextureSlot()",
             "Texture slot value out of range: {0 < VALUE}.");
 
-    glActiveTexture(GL_TEXTURE0 + slot_index);
+    state_machine_->setActiveTextureUnit(slot_index);
 }
 
 void TextureManager::setUnpackPixelAlignment(GLint alignment)
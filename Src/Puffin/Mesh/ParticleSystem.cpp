@@ -91,7 +91,7 @@ void ParticleSystem::updateParticles(GLfloat time_delta, CameraPtr camera)
         else
         {
             // Calculate particle distance from camera
-            auto distance = glm::length(camera->getPosition() -
+            auto distance = glm::length(camera->getRenderPosition() -
                 (*it)->getPosition());
             (*it)->distance_ = distance;
             ++it;
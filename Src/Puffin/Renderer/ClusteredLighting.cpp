@@ -0,0 +1,287 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#include "Puffin/Renderer/ClusteredLighting.h"
+
+using namespace puffin;
+
+ClusteredLighting::ClusteredLighting(MasterManagerPtr master_manager,
+    StateMachinePtr state_machine)
+{
+    if (!master_manager)
+        logErrorAndThrow(name_, "ClusteredLighting::ClusteredLighting()",
+            "Object [MasterManager] pointer not set.");
+
+    if (!state_machine)
+        logErrorAndThrow(name_, "ClusteredLighting::ClusteredLighting()",
+            "Object [StateMachine] pointer not set.");
+
+    master_manager_ = master_manager;
+    state_machine_ = state_machine;
+
+    lights_texture_ = master_manager_->textureManager()->createTextureBuffer(
+        TextureBufferFormat::RGBA32F, "clustered_lighting_lights");
+    clusters_texture_ = master_manager_->textureManager()->
+        createTextureBuffer(TextureBufferFormat::RG32UI,
+            "clustered_lighting_clusters");
+    light_indices_texture_ = master_manager_->textureManager()->
+        createTextureBuffer(TextureBufferFormat::R32UI,
+            "clustered_lighting_light_indices");
+
+    logDebug(name_, "ClusteredLighting::ClusteredLighting()",
+        "Clustered lighting created.");
+}
+
+ClusteredLighting::~ClusteredLighting()
+{
+    logDebug(name_, "ClusteredLighting::~ClusteredLighting()",
+        "Clustered lighting destroyed.");
+}
+
+void ClusteredLighting::setGridSize(GLint size_x, GLint size_y, GLint size_z)
+{
+    if (size_x <= 0 || size_y <= 0 || size_z <= 0)
+        logErrorAndThrow(name_, "ClusteredLighting::setGridSize()",
+            "Grid size value out of range: {0 < VALUE}.");
+
+    grid_size_ = glm::ivec3(size_x, size_y, size_z);
+    bounds_outdated_ = true;
+}
+
+void ClusteredLighting::setMaxLightsPerCluster(GLint count)
+{
+    if (count <= 0)
+        logErrorAndThrow(name_, "ClusteredLighting::setMaxLightsPerCluster()",
+            "Lights count value out of range: {0 < VALUE}.");
+
+    max_lights_per_cluster_ = count;
+}
+
+void ClusteredLighting::update(CameraPtr camera,
+    const std::vector<glm::vec3> &shadow_tiles)
+{
+    if (!camera)
+        logErrorAndThrow(name_, "ClusteredLighting::update()",
+            "Object [Camera] pointer not set.");
+
+    // Clusters are built for currently rendered target
+    auto viewport = state_machine_->getViewport();
+    screen_size_ = glm::vec2(std::max(viewport.z, 1),
+        std::max(viewport.w, 1));
+
+    if (bounds_outdated_ || projection_matrix_ !=
+        camera->getProjectionMatrix())
+        calculateClustersBounds(camera);
+
+    auto light_manager = master_manager_->lightManager();
+    auto view_matrix = camera->getViewMatrix();
+    Frustum camera_frustum(projection_matrix_ * view_matrix);
+
+    // Lights outside of view frustum are skipped. Remaining ones are sorted
+    // from the nearest, so full clusters keep the most important lights.
+    std::vector<VisibleLight> visible_lights;
+    for (GLuint i = 0; i < light_manager->getRenderPointLightsCount(); i++)
+    {
+        auto pl = light_manager->getRenderPointLight(i);
+        if (!pl->isEnabled())
+            continue;
+
+        GLfloat range = pl->getRange();
+        if (!camera_frustum.containsSphere(pl->getPosition(), range))
+            continue;
+
+        VisibleLight light;
+        light.index = i;
+        light.position_VIEW = glm::vec3(view_matrix *
+            glm::vec4(pl->getPosition(), 1.0f));
+        light.range = range;
+        visible_lights.push_back(light);
+    }
+
+    std::sort(visible_lights.begin(), visible_lights.end(),
+        [](const VisibleLight &a, const VisibleLight &b)
+    {
+        return glm::length(a.position_VIEW) < glm::length(b.position_VIEW);
+    });
+
+    visible_lights_count_ = visible_lights.size();
+
+    // Every light uses three texels:
+    // (position, range), (color, linear factor), (quadratic factor, tile)
+    lights_data_.clear();
+    for (const auto &light : visible_lights)
+    {
+        auto pl = light_manager->getRenderPointLight(light.index);
+        auto position = pl->getPosition();
+        auto color = pl->getColor();
+
+        glm::vec3 tile(0.0f, 0.0f, 0.0f);
+        if (light.index < shadow_tiles.size())
+            tile = shadow_tiles[light.index];
+
+        GLfloat texels[] = {position.x, position.y, position.z, light.range,
+            color.r, color.g, color.b, pl->getLinearAttenuationFactor(),
+            pl->getQuadraticAttenuationFactor(), tile.x, tile.y, tile.z};
+        lights_data_.insert(lights_data_.end(), std::begin(texels),
+            std::end(texels));
+    }
+
+    for (auto &cluster_lights : clusters_lights_)
+        cluster_lights.clear();
+
+    for (GLuint i = 0; i < visible_lights.size(); i++)
+        assignLight(visible_lights[i], i, projection_matrix_);
+
+    // Cluster stores offset and count of its lights in indices list
+    clusters_data_.clear();
+    light_indices_data_.clear();
+    for (const auto &cluster_lights : clusters_lights_)
+    {
+        clusters_data_.push_back(light_indices_data_.size());
+        clusters_data_.push_back(cluster_lights.size());
+        light_indices_data_.insert(light_indices_data_.end(),
+            cluster_lights.begin(), cluster_lights.end());
+    }
+
+    master_manager_->textureManager()->setTextureBufferData(lights_texture_,
+        lights_data_.data(), lights_data_.size() * sizeof(GLfloat));
+    master_manager_->textureManager()->setTextureBufferData(clusters_texture_,
+        clusters_data_.data(), clusters_data_.size() * sizeof(GLuint));
+    master_manager_->textureManager()->setTextureBufferData(
+        light_indices_texture_, light_indices_data_.data(),
+        light_indices_data_.size() * sizeof(GLuint));
+}
+
+void ClusteredLighting::calculateClustersBounds(CameraPtr camera)
+{
+    projection_matrix_ = camera->getProjectionMatrix();
+    near_plane_ = camera->getNearPlane();
+    far_plane_ = camera->getFarPlane();
+    depth_scale_ = grid_size_.z / std::log(far_plane_ / near_plane_);
+
+    GLint clusters_count = grid_size_.x * grid_size_.y * grid_size_.z;
+    clusters_bounds_.resize(clusters_count);
+    clusters_lights_.resize(clusters_count);
+
+    // Bounds are calculated in view space as boxes enclosing cluster's
+    // frustum part
+    for (GLint z = 0; z < grid_size_.z; z++)
+    {
+        GLfloat depth_near = near_plane_ * std::pow(far_plane_ / near_plane_,
+            static_cast<GLfloat>(z) / grid_size_.z);
+        GLfloat depth_far = near_plane_ * std::pow(far_plane_ / near_plane_,
+            static_cast<GLfloat>(z + 1) / grid_size_.z);
+
+        for (GLint y = 0; y < grid_size_.y; y++)
+        {
+            GLfloat ndc_y[] = {2.0f * y / grid_size_.y - 1.0f,
+                2.0f * (y + 1) / grid_size_.y - 1.0f};
+
+            for (GLint x = 0; x < grid_size_.x; x++)
+            {
+                GLfloat ndc_x[] = {2.0f * x / grid_size_.x - 1.0f,
+                    2.0f * (x + 1) / grid_size_.x - 1.0f};
+
+                ClusterBounds bounds;
+                bounds.min = glm::vec3(std::numeric_limits<GLfloat>::max());
+                bounds.max = glm::vec3(-std::numeric_limits<GLfloat>::max());
+
+                for (const auto &depth : {depth_near, depth_far})
+                {
+                    for (const auto &corner_x : ndc_x)
+                    {
+                        for (const auto &corner_y : ndc_y)
+                        {
+                            glm::vec3 corner(corner_x * depth /
+                                projection_matrix_[0][0], corner_y * depth /
+                                projection_matrix_[1][1], -depth);
+
+                            bounds.min = glm::min(bounds.min, corner);
+                            bounds.max = glm::max(bounds.max, corner);
+                        }
+                    }
+                }
+
+                clusters_bounds_[getClusterIndex(x, y, z)] = bounds;
+            }
+        }
+    }
+
+    bounds_outdated_ = false;
+}
+
+void ClusteredLighting::assignLight(const VisibleLight &light,
+    GLuint light_index, const glm::mat4 &projection_matrix)
+{
+    const glm::vec3 &center = light.position_VIEW;
+    GLfloat radius = light.range;
+
+    // Depth slices covered by light's sphere
+    GLint slice_first = getSliceIndex(-center.z - radius);
+    GLint slice_last = getSliceIndex(-center.z + radius);
+
+    // Screen tiles covered by projection of sphere's bounding box. Corners
+    // behind near plane are moved onto it, so the result stays conservative.
+    glm::vec2 ndc_min(1.0f, 1.0f);
+    glm::vec2 ndc_max(-1.0f, -1.0f);
+    for (GLint i = 0; i < 8; i++)
+    {
+        glm::vec3 corner = center + radius * glm::vec3(i & 1 ? 1.0f : -1.0f,
+            i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f);
+        GLfloat depth = std::max(-corner.z, near_plane_);
+
+        glm::vec2 ndc(corner.x * projection_matrix[0][0] / depth,
+            corner.y * projection_matrix[1][1] / depth);
+        ndc_min = glm::min(ndc_min, ndc);
+        ndc_max = glm::max(ndc_max, ndc);
+    }
+
+    auto toTile = [](GLfloat ndc, GLint size)
+    {
+        return glm::clamp(static_cast<GLint>(std::floor((ndc * 0.5f + 0.5f) *
+            size)), 0, size - 1);
+    };
+
+    GLint x_first = toTile(ndc_min.x, grid_size_.x);
+    GLint x_last = toTile(ndc_max.x, grid_size_.x);
+    GLint y_first = toTile(ndc_min.y, grid_size_.y);
+    GLint y_last = toTile(ndc_max.y, grid_size_.y);
+
+    for (GLint z = slice_first; z <= slice_last; z++)
+    {
+        for (GLint y = y_first; y <= y_last; y++)
+        {
+            for (GLint x = x_first; x <= x_last; x++)
+            {
+                GLint index = getClusterIndex(x, y, z);
+                auto &cluster_lights = clusters_lights_[index];
+
+                if (static_cast<GLint>(cluster_lights.size()) >=
+                    max_lights_per_cluster_)
+                    continue;
+
+                // Exact sphere and box intersection test
+                const ClusterBounds &bounds = clusters_bounds_[index];
+                glm::vec3 closest = glm::clamp(center, bounds.min,
+                    bounds.max);
+                glm::vec3 offset = closest - center;
+                if (glm::dot(offset, offset) > radius * radius)
+                    continue;
+
+                cluster_lights.push_back(light_index);
+            }
+        }
+    }
+}
+
+GLint ClusteredLighting::getSliceIndex(GLfloat depth) const
+{
+    if (depth <= near_plane_)
+        return 0;
+
+    GLint slice = static_cast<GLint>(std::log(depth / near_plane_) *
+        depth_scale_);
+    return glm::clamp(slice, 0, grid_size_.z - 1);
+}
\ No newline at end of file
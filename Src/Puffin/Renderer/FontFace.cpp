@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#include "Puffin/Renderer/FontFace.h"
+
+using namespace puffin;
+
+FontFace::FontFace(FT_Library library, std::string path)
+{
+    FT_Error result = FT_New_Face(library, path.c_str(), 0, &face_);
+    if (result == FT_Err_Unknown_File_Format)
+        logErrorAndThrow(name_, "FontFace::FontFace()",
+            "Unknown font file format.");
+    else if (result)
+        logErrorAndThrow(name_, "FontFace::FontFace()",
+            "Opening font file [" + path + "] error.");
+
+    if (FT_Stroker_New(library, &stroker_))
+    {
+        FT_Done_Face(face_);
+        logErrorAndThrow(name_, "FontFace::FontFace()",
+            "FreeType stroker initialization error.");
+    }
+
+    path_ = path;
+
+    logDebug(name_, "FontFace::FontFace()", "Font face created.");
+}
+
+FontFace::~FontFace()
+{
+    FT_Stroker_Done(stroker_);
+    // Size objects are released together with face
+    FT_Done_Face(face_);
+
+    logDebug(name_, "FontFace::~FontFace()", "Font face destroyed.");
+}
+
+void FontFace::activateSize(GLint pixel_size)
+{
+    if (pixel_size <= 0)
+        logErrorAndThrow(name_, "FontFace::activateSize()",
+            "Pixel size value out of range: {0 < VALUE}.");
+
+    if (pixel_size == active_size_)
+        return;
+
+    auto size = sizes_.find(pixel_size);
+    if (size != sizes_.end())
+    {
+        FT_Activate_Size(size->second);
+        active_size_ = pixel_size;
+        return;
+    }
+
+    FT_Size new_size{};
+    if (FT_New_Size(face_, &new_size))
+        logErrorAndThrow(name_, "FontFace::activateSize()",
+            "Creating font size object error.");
+
+    FT_Size previous_size = face_->size;
+    FT_Activate_Size(new_size);
+    if (FT_Set_Pixel_Sizes(face_, 0, pixel_size))
+    {
+        // Size that matches active_size_ has to stay active
+        FT_Done_Size(new_size);
+        FT_Activate_Size(previous_size);
+
+        logErrorAndThrow(name_, "FontFace::activateSize()",
+            "Setting font pixel size error.");
+    }
+
+    sizes_[pixel_size] = new_size;
+    active_size_ = pixel_size;
+}
+
+FT_UInt FontFace::getGlyphIndex(wchar_t character)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+    return FT_Get_Char_Index(face_, character);
+}
+
+GLfloat FontFace::getKerning(FT_UInt previous_index, FT_UInt glyph_index,
+    GLint pixel_size)
+{
+    std::lock_guard<std::mutex> guard(mutex_);
+
+    if (!previous_index || !glyph_index || !FT_HAS_KERNING(face_) ||
+        face_->units_per_EM == 0)
+        return 0.0f;
+
+    // Unscaled kerning does not depend on active size
+    FT_Vector delta{};
+    if (FT_Get_Kerning(face_, previous_index, glyph_index,
+        FT_KERNING_UNSCALED, &delta))
+        return 0.0f;
+
+    return static_cast<GLfloat>(delta.x) * pixel_size /
+        static_cast<GLfloat>(face_->units_per_EM);
+}
\ No newline at end of file
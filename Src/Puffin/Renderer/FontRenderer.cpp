@@ -32,21 +32,17 @@ FontRenderer::FontRenderer(MasterManagerPtr master_manager,
         logErrorAndThrow(name_, "FontRenderer::FontRenderer()",
             "FreeType library initialization error.");
 
-    if (FT_Stroker_New(ft_library_, &stroker_))
-        logErrorAndThrow(name_, "FontRenderer::FontRenderer()",
-            "FreeType stroker initialization error.");
+    glyph_atlas_.reset(new GlyphAtlas(master_manager_));
 
     loadShaders();
-    createCharacterModel();
 
     logDebug(name_, "FontRenderer::FontRenderer()", "Font renderer created");
 }
 
 FontRenderer::~FontRenderer()
 {
-    for (auto &face : font_faces_)
-        FT_Done_Face(face.second);
-
+    // Faces have to be released before library
+    font_faces_.clear();
     FT_Done_FreeType(ft_library_);
 
     logDebug(name_, "FontRenderer::~FontRenderer()", "Font renderer destroyed");
@@ -55,113 +51,313 @@ FontRenderer::~FontRenderer()
 void FontRenderer::loadShaders()
 {
     shader_program_ = master_manager_->shaderManager()->
-        createShaderProgram("font_shader_program", "shaders/FontVs.glsl",
-            "shaders/FontFs.glsl");
+        createShaderProgramAsync("font_shader_program",
+            "shaders/FontVs.glsl", "shaders/FontFs.glsl");
+
+    distance_field_shader_program_ = master_manager_->shaderManager()->
+        createShaderProgramAsync("font_distance_field_shader_program",
+            "shaders/FontVs.glsl", "shaders/FontDistanceFieldFs.glsl");
 }
 
-void FontRenderer::createCharacterModel()
+void FontRenderer::setDistanceFieldSize(GLint size)
 {
-    character_texture_ = master_manager_->textureManager()->
-        createTexture2D("single_character_texture");
-    master_manager_->textureManager()->setTextureFilter(character_texture_,
-        TextureFilter::BILINEAR);
-
-    std::vector<GLfloat> texture_coords = {
-        0.0f, 0.0f,
-        0.0f, 1.0f,
-        1.0f, 0.0f,
-        1.0f, 0.0f,
-        0.0f, 1.0f,
-        1.0f, 1.0f
-    };
+    if (size <= 0)
+        logErrorAndThrow(name_, "FontRenderer::setDistanceFieldSize()",
+            "Distance field size value out of range: {0 < VALUE}.");
 
-    character_object_ = master_manager_->meshManager()->
-        createObject3D("single_character");
+    distance_field_size_ = size;
+    glyph_atlas_->clear();
+    text_layouts_.clear();
+}
 
-    Object3DEntityPtr entity(new Object3DEntity());
-    entity->setVerticesCount(6);
-    character_object_->addEntity(entity);
+void FontRenderer::setDistanceFieldSpread(GLint spread)
+{
+    if (spread <= 0)
+        logErrorAndThrow(name_, "FontRenderer::setDistanceFieldSpread()",
+            "Distance field spread value out of range: {0 < VALUE}.");
 
-    master_manager_->meshManager()->setMeshData(character_object_,
-        texture_coords, VertexDataType::TEXTURE_COORD, false);
+    distance_field_spread_ = spread;
+    glyph_atlas_->clear();
 }
 
-FT_Face FontRenderer::createFontFace(TextPtr text)
+glm::vec2 FontRenderer::measure(TextPtr text)
 {
-    for (const auto &font_face : font_faces_)
-    {
-        if (font_face.first == text->getFont())
-            return font_face.second;
-    }
+    if (!text)
+        logErrorAndThrow(name_, "FontRenderer::measure()",
+            "Object [Text] pointer not set.");
+
+    return getTextLayout(text).size;
+}
+
+FontFacePtr FontRenderer::createFontFace(TextPtr text)
+{
+    std::lock_guard<std::mutex> guard(font_faces_mutex_);
 
-    FT_Face font_face{};
-    FT_Error result = FT_New_Face(ft_library_, text->getFont().c_str(), 0,
-        &font_face);
+    auto font_face = font_faces_.find(text->getFont());
+    if (font_face != font_faces_.end())
+        return font_face->second;
 
-    if (result == FT_Err_Unknown_File_Format)
-        logErrorAndThrow(name_, "FontRenderer::createFontFace()",
-            "Unknown font file format.");
-    else if (result)
-        logErrorAndThrow(name_, "FontRenderer::createFontFace()",
-            "Opening font file [" + text->getFont() + "] error.");
+    FontFacePtr new_font_face(new FontFace(ft_library_, text->getFont()));
 
     logInfo(name_, "FontRenderer::createFontFace()",
         "Font face for font [" + text->getFont() + "] created.");
 
-    font_faces_[text->getFont()] = font_face;
-    return font_face;
+    font_faces_[text->getFont()] = new_font_face;
+    return new_font_face;
 }
 
-GLint FontRenderer::processWhitespaces(FT_Face font_face, wchar_t character,
-    TextPtr text, GLint &cur_pos_x, GLint &cur_pos_y) const
+GlyphAtlas::Glyph FontRenderer::getGlyph(FontFacePtr font_face,
+    TextPtr text, wchar_t character, GLint outline_size)
 {
-    if (character == ' ')
+    GlyphAtlas::GlyphKey key{text->getFont(), text->getFontSize(),
+        outline_size, static_cast<GLuint>(character), false};
+
+    GlyphAtlas::Glyph glyph;
+    if (glyph_atlas_->findGlyph(key, glyph))
+        return glyph;
+
+    // FreeType is used only when glyph is not cached yet
+    auto bitmap = rasterizeGlyph(font_face, text->getFontSize(), character,
+        outline_size);
+
+    glyph_atlas_->addGlyph(key, bitmap.data.empty() ? nullptr :
+        bitmap.data.data(), bitmap.size, bitmap.bearing, bitmap.advance,
+        glyph);
+
+    return glyph;
+}
+
+GlyphAtlas::Glyph FontRenderer::getTextGlyph(FontFacePtr font_face,
+    TextPtr text, wchar_t character)
+{
+    if (text->isDistanceFieldEnabled())
+        return getDistanceFieldGlyph(font_face, text, character);
+
+    return getGlyph(font_face, text, character, 0);
+}
+
+GlyphAtlas::Glyph FontRenderer::getDistanceFieldGlyph(FontFacePtr font_face,
+    TextPtr text, wchar_t character)
+{
+    GlyphAtlas::GlyphKey key{text->getFont(), distance_field_size_, 0,
+        static_cast<GLuint>(character), true};
+
+    GlyphAtlas::Glyph glyph;
+    if (glyph_atlas_->findGlyph(key, glyph))
+        return glyph;
+
+    auto bitmap = rasterizeGlyph(font_face, distance_field_size_, character,
+        0);
+
+    glm::ivec2 size(0, 0);
+    auto data = calculateDistanceField(bitmap, size);
+
+    // Field exceeds glyph's bitmap by spread on every side. Shadow tap is
+    // offset by up to spread, so border of that width stays empty too.
+    glyph_atlas_->addGlyph(key, data.empty() ? nullptr : data.data(), size,
+        bitmap.bearing + glm::ivec2(-distance_field_spread_,
+        distance_field_spread_), bitmap.advance, glyph,
+        distance_field_spread_);
+
+    return glyph;
+}
+
+FontRenderer::GlyphBitmap FontRenderer::rasterizeGlyph(
+    FontFacePtr font_face, GLint pixel_size, wchar_t character,
+    GLint outline_size) const
+{
+    // Face stays locked only while FreeType works, glyph is copied out
+    auto lock = font_face->lock();
+    font_face->activateSize(pixel_size);
+
+    FT_Face face = font_face->getFace();
+    FT_UInt glyph_index = FT_Get_Char_Index(face, character);
+    FT_Load_Glyph(face, glyph_index, FT_LOAD_DEFAULT);
+
+    FT_Glyph glyph;
+    FT_Get_Glyph(face->glyph, &glyph);
+
+    if (outline_size > 0)
     {
-        if (render_type_ == TextRenderType::NO_OUTLINE ||
-            render_type_ == TextRenderType::OUTLINE)
-            cur_pos_x += (font_face->glyph->advance.x >> 6) +
-            text->getHorizontalSpacing();
+        FT_Stroker_Set(font_face->getStroker(),
+            static_cast<FT_Fixed>(64 * outline_size),
+            FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
+        FT_Glyph_StrokeBorder(&glyph, font_face->getStroker(), false, true);
+    }
+
+    if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, nullptr, true))
+    {
+        FT_Done_Glyph(glyph);
+        logErrorAndThrow(name_, "FontRenderer::rasterizeGlyph()",
+            "Cannot get character bitmap glyph.");
+    }
 
-        return -1;
+    FT_BitmapGlyph bitmap_glyph = reinterpret_cast<FT_BitmapGlyph>(glyph);
+    const FT_Bitmap &bitmap = bitmap_glyph->bitmap;
+
+    GlyphBitmap glyph_bitmap;
+    glyph_bitmap.size = glm::ivec2(bitmap.width, bitmap.rows);
+    glyph_bitmap.bearing = glm::ivec2(bitmap_glyph->left, bitmap_glyph->top);
+    glyph_bitmap.advance = static_cast<GLint>(face->glyph->advance.x >> 6);
+
+    // Atlas expects rows without padding
+    glyph_bitmap.data.resize(glyph_bitmap.size.x * glyph_bitmap.size.y);
+    for (GLint row = 0; row < glyph_bitmap.size.y; row++)
+    {
+        std::memcpy(&glyph_bitmap.data[row * glyph_bitmap.size.x],
+            bitmap.buffer + row * bitmap.pitch, glyph_bitmap.size.x);
     }
 
-    if (character == '\n')
+    FT_Done_Glyph(glyph);
+    return glyph_bitmap;
+}
+
+std::vector<GLubyte> FontRenderer::calculateDistanceField(
+    const GlyphBitmap &bitmap, glm::ivec2 &size) const
+{
+    size = glm::ivec2(0, 0);
+    if (bitmap.size.x <= 0 || bitmap.size.y <= 0)
+        return std::vector<GLubyte>();
+
+    GLint spread = distance_field_spread_;
+    size = bitmap.size + 2 * spread;
+
+    // Squared distances to nearest texel inside (outer) and outside (inner)
+    // of glyph. Partially covered texels start with distance to edge
+    // estimated from coverage.
+    const GLfloat infinity = 1e20f;
+    std::vector<GLfloat> outer(size.x * size.y, infinity);
+    std::vector<GLfloat> inner(size.x * size.y, 0.0f);
+
+    for (GLint row = 0; row < bitmap.size.y; row++)
     {
-        if (render_type_ == TextRenderType::NO_OUTLINE ||
-            render_type_ == TextRenderType::OUTLINE)
+        for (GLint col = 0; col < bitmap.size.x; col++)
         {
-            cur_pos_x = text->getPosition().x;
-            cur_pos_y += text->getFontSize() + text->getVerticalSpacing();
+            GLfloat coverage = bitmap.data[row * bitmap.size.x + col] / 255.0f;
+            if (coverage <= 0.0f)
+                continue;
+
+            GLint index = (row + spread) * size.x + col + spread;
+            if (coverage >= 1.0f)
+            {
+                outer[index] = 0.0f;
+                inner[index] = infinity;
+                continue;
+            }
+
+            GLfloat edge_distance = 0.5f - coverage;
+            outer[index] = edge_distance > 0.0f ?
+                edge_distance * edge_distance : 0.0f;
+            inner[index] = edge_distance < 0.0f ?
+                edge_distance * edge_distance : 0.0f;
         }
+    }
+
+    calculateDistanceTransform(outer, size.x, size.y);
+    calculateDistanceTransform(inner, size.x, size.y);
 
-        return -1;
+    // Distance of spread maps to 0 outside and to 1 inside of glyph
+    std::vector<GLubyte> data(size.x * size.y);
+    for (GLuint i = 0; i < data.size(); i++)
+    {
+        GLfloat distance = std::sqrt(inner[i]) - std::sqrt(outer[i]);
+        GLfloat value = glm::clamp(0.5f + distance / (2.0f * spread), 0.0f,
+            1.0f);
+        data[i] = static_cast<GLubyte>(value * 255.0f + 0.5f);
     }
 
-    return 0;
+    return data;
 }
 
-FT_BitmapGlyph FontRenderer::getCharacterGlyph(FT_Face font_face,
-    wchar_t character, GLint outline_size) const
+void FontRenderer::calculateDistanceTransform(std::vector<GLfloat> &grid,
+    GLint width, GLint height) const
 {
-    FT_UInt glyph_index = FT_Get_Char_Index(font_face, character);
-    FT_Load_Glyph(font_face, glyph_index, FT_LOAD_DEFAULT);
+    GLint length = std::max(width, height);
+    std::vector<GLfloat> line(length);
+    std::vector<GLfloat> distances(length);
+    std::vector<GLint> parabolas(length);
+    std::vector<GLfloat> bounds(length + 1);
+
+    // Two dimensional transform is separable into columns and rows passes
+    for (GLint x = 0; x < width; x++)
+    {
+        for (GLint y = 0; y < height; y++)
+            line[y] = grid[y * width + x];
 
-    FT_Glyph glyph;
-    FT_Get_Glyph(font_face->glyph, &glyph);
+        calculateLineDistances(line, height, distances, parabolas, bounds);
 
-    if (render_type_ == TextRenderType::OUTLINE)
+        for (GLint y = 0; y < height; y++)
+            grid[y * width + x] = distances[y];
+    }
+
+    for (GLint y = 0; y < height; y++)
     {
-        FT_Stroker_Set(stroker_, static_cast<FT_Fixed>(64 * outline_size),
-            FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
-        FT_Glyph_StrokeBorder(&glyph, stroker_, false, true);
+        for (GLint x = 0; x < width; x++)
+            line[x] = grid[y * width + x];
+
+        calculateLineDistances(line, width, distances, parabolas, bounds);
+
+        for (GLint x = 0; x < width; x++)
+            grid[y * width + x] = distances[x];
     }
+}
 
-    if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, nullptr, true))
-        logErrorAndThrow(name_, "FontRenderer::getCharacterGlyph()",
-            "Cannot get character bitmap glyph.");
+// Squared euclidean distances along line as lower envelope of parabolas
+// (Felzenszwalb and Huttenlocher)
+void FontRenderer::calculateLineDistances(const std::vector<GLfloat> &line,
+    GLint count, std::vector<GLfloat> &distances,
+    std::vector<GLint> &parabolas, std::vector<GLfloat> &bounds) const
+{
+    auto intersection = [&line](GLint q, GLint r) {
+        return ((line[q] + q * q) - (line[r] + r * r)) /
+            static_cast<GLfloat>(2 * (q - r));
+    };
 
-    FT_BitmapGlyph bitmap_glyph = reinterpret_cast<FT_BitmapGlyph>(glyph);
-    return bitmap_glyph;
+    GLint k = 0;
+    parabolas[0] = 0;
+    bounds[0] = -1e20f;
+    bounds[1] = 1e20f;
+
+    for (GLint q = 1; q < count; q++)
+    {
+        GLfloat s = intersection(q, parabolas[k]);
+        while (s <= bounds[k])
+        {
+            k--;
+            s = intersection(q, parabolas[k]);
+        }
+
+        k++;
+        parabolas[k] = q;
+        bounds[k] = s;
+        bounds[k + 1] = 1e20f;
+    }
+
+    k = 0;
+    for (GLint q = 0; q < count; q++)
+    {
+        while (bounds[k + 1] < q)
+            k++;
+
+        GLint r = parabolas[k];
+        distances[q] = static_cast<GLfloat>((q - r) * (q - r)) + line[r];
+    }
+}
+
+std::vector<glm::vec3> FontRenderer::calculateVertices(GLfloat cursor_x,
+    GLfloat cursor_y, GLfloat scale, const GlyphAtlas::Glyph &glyph) const
+{
+    std::vector<glm::vec3> vertices(4);
+
+    vertices[0] = glm::vec3(cursor_x + glyph.bearing.x * scale, cursor_y -
+        glyph.bearing.y * scale, 0.0f);
+    vertices[1] = glm::vec3(vertices[0].x, vertices[0].y + glyph.size.y *
+        scale, 0.0f);
+    vertices[2] = glm::vec3(vertices[0].x + glyph.size.x * scale,
+        vertices[0].y, 0.0f);
+    vertices[3] = glm::vec3(vertices[2].x, vertices[1].y, 0.0f);
+
+    return vertices;
 }
 
 void FontRenderer::render(ScenePtr scene)
@@ -173,98 +369,293 @@ void FontRenderer::render(ScenePtr scene)
     if (!text_container.size())
         return;
 
-    state_machine_->activateShaderProgram(shader_program_);
-
-    master_manager_->textureManager()->setUnpackPixelAlignment(1);
     master_manager_->textureManager()->setTextureSlot(0);
     state_machine_->unbindAllTextures();
 
-    state_machine_->bindTexture(character_texture_);
-    state_machine_->bindMesh(character_object_);
-
     state_machine_->alphaBlend()->enable(true);
     state_machine_->depthTest()->enable(false);
     state_machine_->alphaBlend()->setBlendFunction(BlendFunction::NORMAL);
 
+    glyph_atlas_->beginFrame();
+    frame_index_++;
+
     for (const auto &text : text_container)
     {
-        auto font_face = createFontFace(text);
-        FT_Set_Pixel_Sizes(font_face, 0, text->getFontSize());
+        auto &text_mesh = text_meshes_[text];
+
+        // Evicted atlas page may contain glyphs used by cached mesh
+        if (!text_mesh.mesh || text_mesh.version != text->getVersion() ||
+            text_mesh.atlas_generation != glyph_atlas_->getGeneration())
+            buildTextMesh(text, text_mesh);
+
+        renderTextMesh(text, text_mesh);
+        text_mesh.last_use_frame = frame_index_;
+    }
+
+    // Meshes and layouts of texts removed from scene are released
+    for (auto text_mesh = text_meshes_.begin();
+        text_mesh != text_meshes_.end();)
+    {
+        if (text_mesh->second.last_use_frame != frame_index_)
+            text_mesh = text_meshes_.erase(text_mesh);
+        else
+            text_mesh++;
+    }
 
-        GLint cursor_pos_x = text->getPosition().x;
-        GLint cursor_pos_y = text->getPosition().y;
+    // Layout of text with cached mesh is not touched, but still in use
+    for (auto layout = text_layouts_.begin(); layout != text_layouts_.end();)
+    {
+        if (layout->second.last_use_frame != frame_index_ &&
+            !text_meshes_.count(layout->first))
+            layout = text_layouts_.erase(layout);
+        else
+            layout++;
+    }
+}
 
-        for (const auto &character : text->getText())
+const FontRenderer::TextLayout &FontRenderer::getTextLayout(TextPtr text)
+{
+    auto &layout = text_layouts_[text];
+    if (layout.version != text->getLayoutVersion())
+        layoutText(text, layout);
+
+    layout.last_use_frame = frame_index_;
+    return layout;
+}
+
+void FontRenderer::layoutText(TextPtr text, TextLayout &layout)
+{
+    layout.glyphs.clear();
+    layout.size = glm::vec2(0.0f, 0.0f);
+    layout.version = text->getLayoutVersion();
+
+    if (text->getText().empty())
+        return;
+
+    auto font_face = createFontFace(text);
+    GLfloat scale = text->isDistanceFieldEnabled() ?
+        getDistanceFieldScale(text) : 1.0f;
+    GLfloat wrap_width = static_cast<GLfloat>(text->getWrapWidth());
+    GLfloat line_height = static_cast<GLfloat>(text->getFontSize() +
+        text->getVerticalSpacing());
+
+    std::vector<LayoutLine> lines;
+    GLint line_start = 0;
+    GLint break_glyph = -1;
+    GLfloat pen_x = 0.0f;
+    GLfloat line_y = 0.0f;
+    FT_UInt previous_index = 0;
+
+    for (const auto &character : text->getText())
+    {
+        if (character == '\n')
         {
-            GLint cursor_x = cursor_pos_x;
-            GLint cursor_y = cursor_pos_y;
+            addLayoutLine(layout, line_start,
+                static_cast<GLint>(layout.glyphs.size()), lines);
+
+            line_start = static_cast<GLint>(layout.glyphs.size());
+            break_glyph = -1;
+            pen_x = 0.0f;
+            line_y += line_height;
+            previous_index = 0;
+            continue;
+        }
 
-            if (text->getOutlineSize() > 0)
+        FT_UInt glyph_index = font_face->getGlyphIndex(character);
+        auto glyph = getTextGlyph(font_face, text, character);
+
+        LayoutGlyph layout_glyph;
+        layout_glyph.character = character;
+        layout_glyph.advance = glyph.advance * scale;
+        layout_glyph.position = glm::vec2(pen_x + getKerning(font_face,
+            previous_index, glyph_index, text), line_y);
+
+        // Line is broken at its last space, or before current character when
+        // there is no space to break at
+        GLint glyphs_count = static_cast<GLint>(layout.glyphs.size());
+        if (wrap_width > 0.0f && character != ' ' &&
+            glyphs_count > line_start && layout_glyph.position.x +
+            layout_glyph.advance > wrap_width)
+        {
+            GLint next_start = glyphs_count;
+            if (break_glyph > line_start)
             {
-                render_type_ = TextRenderType::OUTLINE;
-                renderSingleCharacter(font_face, character, text, cursor_x,
-                    cursor_y);
-                render_type_ = TextRenderType::TEXT;
+                layout.glyphs.erase(layout.glyphs.begin() + break_glyph);
+                next_start = break_glyph;
             }
-            else
-                render_type_ = TextRenderType::NO_OUTLINE;
 
-            renderSingleCharacter(font_face, character, text, cursor_pos_x,
-                cursor_pos_y);
+            addLayoutLine(layout, line_start, next_start, lines);
 
-            if (render_type_ == TextRenderType::TEXT)
-            {
-                cursor_pos_x = cursor_x;
-                cursor_pos_y = cursor_y;
-            }
+            GLfloat shift = layout_glyph.position.x;
+            if (next_start < static_cast<GLint>(layout.glyphs.size()))
+                shift = layout.glyphs[next_start].position.x;
+
+            line_y += line_height;
+            for (GLuint i = next_start; i < layout.glyphs.size(); i++)
+                layout.glyphs[i].position = glm::vec2(
+                    layout.glyphs[i].position.x - shift, line_y);
+
+            layout_glyph.position = glm::vec2(layout_glyph.position.x - shift,
+                line_y);
+            line_start = next_start;
+            break_glyph = -1;
         }
+
+        if (character == ' ')
+            break_glyph = static_cast<GLint>(layout.glyphs.size());
+
+        layout.glyphs.push_back(layout_glyph);
+        pen_x = layout_glyph.position.x + layout_glyph.advance +
+            text->getHorizontalSpacing();
+        previous_index = glyph_index;
     }
 
-    master_manager_->textureManager()->setUnpackPixelAlignment(4);
+    addLayoutLine(layout, line_start,
+        static_cast<GLint>(layout.glyphs.size()), lines);
+    alignLayoutLines(text, lines, layout);
 }
 
-std::vector<glm::vec3> FontRenderer::calculateVertices(GLint cursor_x,
-    GLint cursor_y, FT_BitmapGlyph bitmap) const
+void FontRenderer::addLayoutLine(const TextLayout &layout, GLint first,
+    GLint last, std::vector<LayoutLine> &lines) const
 {
-    std::vector<glm::vec3> vertices(4);
+    LayoutLine line;
+    line.first = first;
+    line.count = last - first;
 
-    vertices[0] = glm::vec3(cursor_x + bitmap->left, cursor_y - bitmap->top,
-        0.0f);
-    vertices[1] = glm::vec3(vertices[0].x, vertices[0].y + bitmap->bitmap.rows,
-        0.0f);
-    vertices[2] = glm::vec3(vertices[0].x + bitmap->bitmap.width, vertices[0].y,
-        0.0f);
-    vertices[3] = glm::vec3(vertices[2].x, vertices[1].y, 0.0f);
+    // Trailing spaces do not widen line
+    for (GLint i = first; i < last; i++)
+    {
+        const auto &glyph = layout.glyphs[i];
+        if (glyph.character != ' ')
+            line.width = std::max(line.width, glyph.position.x +
+                glyph.advance);
+    }
 
-    return vertices;
+    lines.push_back(line);
 }
 
-void FontRenderer::setShaderUniforms(TextPtr text) const
+void FontRenderer::alignLayoutLines(TextPtr text,
+    const std::vector<LayoutLine> &lines, TextLayout &layout) const
 {
-    master_manager_->shaderManager()->setUniform(shader_program_,
-        "color.font_texture", static_cast<GLint>(0));
+    GLfloat box_width = static_cast<GLfloat>(text->getWrapWidth());
+    if (box_width <= 0.0f)
+    {
+        for (const auto &line : lines)
+            box_width = std::max(box_width, line.width);
+    }
 
-    if (render_type_ == TextRenderType::OUTLINE)
-        master_manager_->shaderManager()->setUniform(shader_program_,
-            "color.font_color", text->getOutlineColor());
-    else
-        master_manager_->shaderManager()->setUniform(shader_program_,
-            "color.font_color", text->getFontColor());
+    GLfloat factor = 0.0f;
+    if (text->getAlignment() == TextAlignment::CENTER)
+        factor = 0.5f;
+    else if (text->getAlignment() == TextAlignment::RIGHT)
+        factor = 1.0f;
+
+    for (const auto &line : lines)
+    {
+        // Whole pixels keep bitmap glyphs sharp
+        GLfloat offset = std::floor(std::max(box_width - line.width, 0.0f) *
+            factor);
+        for (GLint i = line.first; i < line.first + line.count; i++)
+            layout.glyphs[i].position.x += offset;
+    }
+
+    GLfloat lines_count = static_cast<GLfloat>(lines.size());
+    layout.size = glm::vec2(box_width, lines_count * text->getFontSize() +
+        (lines_count - 1.0f) * text->getVerticalSpacing());
 }
 
-void FontRenderer::renderSingleCharacter(FT_Face font_face, wchar_t character,
-    TextPtr text, GLint &cur_pos_x, GLint &cur_pos_y)
+GLfloat FontRenderer::getKerning(FontFacePtr font_face,
+    FT_UInt previous_index, FT_UInt glyph_index, TextPtr text) const
 {
-    if (processWhitespaces(font_face, character, text, cur_pos_x, cur_pos_y))
-        return;
+    GLfloat kerning = font_face->getKerning(previous_index, glyph_index,
+        text->getFontSize());
+
+    if (!text->isDistanceFieldEnabled())
+        kerning = std::round(kerning);
+
+    return kerning;
+}
+
+void FontRenderer::buildTextMesh(TextPtr text, TextMesh &text_mesh)
+{
+    if (!text_mesh.mesh)
+        text_mesh.mesh.reset(new Object3D(text->getName() + "_mesh"));
+
+    GLuint atlas_generation = glyph_atlas_->getGeneration();
 
-    FT_BitmapGlyph bitmap_glyph = getCharacterGlyph(font_face, character,
-        text->getOutlineSize());
-    master_manager_->textureManager()->setTexture2DData(character_texture_,
-        bitmap_glyph->bitmap.buffer, bitmap_glyph->bitmap.width,
-        bitmap_glyph->bitmap.rows, 1);
+    // Quads grouped by pass and atlas page. Outline pass goes first, so
+    // outlines never cover fill of neighbouring characters.
+    std::map<std::pair<GLint, GLint>, std::vector<GLfloat>> positions;
+    std::map<std::pair<GLint, GLint>, std::vector<GLfloat>> texture_coords;
 
-    auto vertices = calculateVertices(cur_pos_x, cur_pos_y, bitmap_glyph);
+    auto font_face = createFontFace(text);
+    GLboolean distance_field = text->isDistanceFieldEnabled();
+    GLfloat scale = distance_field ? getDistanceFieldScale(text) : 1.0f;
+    const auto &layout = getTextLayout(text);
+
+    for (const auto &layout_glyph : layout.glyphs)
+    {
+        auto character = layout_glyph.character;
+        GLfloat cursor_x = text->getPosition().x + layout_glyph.position.x;
+        GLfloat cursor_y = text->getPosition().y + layout_glyph.position.y;
+
+        // Distance field outline is drawn by shader from fill glyph
+        if (!distance_field && text->getOutlineSize() > 0 && character != ' ')
+        {
+            auto glyph = getGlyph(font_face, text, character,
+                text->getOutlineSize());
+            if (glyph.page >= 0)
+                addGlyphQuad(glyph, cursor_x, cursor_y, scale,
+                    positions[std::make_pair(0, glyph.page)],
+                    texture_coords[std::make_pair(0, glyph.page)]);
+        }
+
+        auto glyph = getTextGlyph(font_face, text, character);
+        if (glyph.page >= 0)
+            addGlyphQuad(glyph, cursor_x, cursor_y, scale,
+                positions[std::make_pair(1, glyph.page)],
+                texture_coords[std::make_pair(1, glyph.page)]);
+    }
+
+    std::vector<GLfloat> positions_buffer;
+    std::vector<GLfloat> texture_coords_buffer;
+
+    text_mesh.batches.clear();
+    for (const auto &range : positions)
+    {
+        TextBatch batch;
+        batch.outline = range.first.first == 0;
+        batch.page = range.first.second;
+        batch.first = static_cast<GLint>(positions_buffer.size() / 3);
+        batch.count = static_cast<GLint>(range.second.size() / 3);
+        text_mesh.batches.push_back(batch);
+
+        const auto &coords = texture_coords[range.first];
+        positions_buffer.insert(positions_buffer.end(), range.second.begin(),
+            range.second.end());
+        texture_coords_buffer.insert(texture_coords_buffer.end(),
+            coords.begin(), coords.end());
+    }
+
+    if (!positions_buffer.empty())
+    {
+        master_manager_->meshManager()->setMeshData(text_mesh.mesh,
+            positions_buffer, VertexDataType::POSITION, true);
+        master_manager_->meshManager()->setMeshData(text_mesh.mesh,
+            texture_coords_buffer, VertexDataType::TEXTURE_COORD, true);
+    }
+
+    // Page evicted while building could hold glyphs added earlier, then
+    // generation differs and mesh is built again in next frame
+    text_mesh.version = text->getVersion();
+    text_mesh.atlas_generation = atlas_generation;
+}
+
+void FontRenderer::addGlyphQuad(const GlyphAtlas::Glyph &glyph,
+    GLfloat cursor_x, GLfloat cursor_y, GLfloat scale,
+    std::vector<GLfloat> &positions, std::vector<GLfloat> &texture_coords)
+{
+    auto vertices = calculateVertices(cursor_x, cursor_y, scale, glyph);
 
     for (auto &vertex : vertices)
     {
@@ -272,23 +663,91 @@ void FontRenderer::renderSingleCharacter(FT_Face font_face, wchar_t character,
         vertex.y = calculateScreenCoordY(vertex.y);
     }
 
-    std::vector<GLfloat> vertices_buffer;
+    std::vector<glm::vec2> coords = {glyph.uv_min,
+        glm::vec2(glyph.uv_min.x, glyph.uv_max.y),
+        glm::vec2(glyph.uv_max.x, glyph.uv_min.y), glyph.uv_max};
 
     for (const auto &index : {0, 1, 2, 2, 1, 3})
     {
-        vertices_buffer.push_back(vertices[index].x);
-        vertices_buffer.push_back(vertices[index].y);
-        vertices_buffer.push_back(vertices[index].z);
+        positions.push_back(vertices[index].x);
+        positions.push_back(vertices[index].y);
+        positions.push_back(vertices[index].z);
+
+        texture_coords.push_back(coords[index].x);
+        texture_coords.push_back(coords[index].y);
     }
+}
 
-    master_manager_->meshManager()->setMeshData(character_object_,
-        vertices_buffer, VertexDataType::POSITION, true);
+void FontRenderer::renderTextMesh(TextPtr text, const TextMesh &text_mesh)
+{
+    if (text_mesh.batches.empty())
+        return;
 
-    setShaderUniforms(text);
-    character_object_->draw();
+    auto shader_program = text->isDistanceFieldEnabled() ?
+        distance_field_shader_program_ : shader_program_;
 
-    if (render_type_ == TextRenderType::NO_OUTLINE ||
-        render_type_ == TextRenderType::OUTLINE)
-        cur_pos_x += (font_face->glyph->advance.x >> 6) +
-        text->getHorizontalSpacing();
+    state_machine_->activateShaderProgram(shader_program);
+    state_machine_->bindMesh(text_mesh.mesh);
+
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "color.font_texture", static_cast<GLint>(0));
+
+    for (const auto &batch : text_mesh.batches)
+    {
+        glyph_atlas_->usePage(batch.page);
+        state_machine_->bindTexture(glyph_atlas_->getPageTexture(batch.page));
+
+        if (text->isDistanceFieldEnabled())
+            setDistanceFieldUniforms(text, batch.page);
+        else
+            master_manager_->shaderManager()->setUniform(shader_program,
+                "color.font_color", batch.outline ? text->getOutlineColor() :
+                text->getFontColor());
+
+        text_mesh.mesh->drawRange(batch.first, batch.count);
+    }
+}
+
+void FontRenderer::setDistanceFieldUniforms(TextPtr text, GLint page)
+{
+    auto shader_manager = master_manager_->shaderManager();
+    auto shader_program = distance_field_shader_program_;
+
+    // Effects cannot reach further than field's spread
+    GLfloat scale = getDistanceFieldScale(text);
+    GLfloat max_distance = distance_field_spread_ * scale;
+    GLfloat pixel_step = 0.5f / max_distance;
+
+    GLfloat outline_edge = 0.5f - std::min(static_cast<GLfloat>(
+        text->getOutlineSize()), max_distance) * pixel_step;
+    GLfloat glow_edge = std::max(outline_edge - text->getGlowSize() *
+        pixel_step, 0.0f);
+    GLfloat shadow_edge = std::max(outline_edge - text->getShadowSoftness() *
+        pixel_step, 0.0f);
+
+    GLfloat page_size = static_cast<GLfloat>(glyph_atlas_->getPageTexture(
+        page)->getWidth());
+    glm::vec2 shadow_offset = glm::clamp(glm::vec2(text->getShadowOffset()),
+        -max_distance, max_distance) / (scale * page_size);
+
+    shader_manager->setUniform(shader_program, "color.font_color",
+        text->getFontColor());
+    shader_manager->setUniform(shader_program, "color.outline_color",
+        text->getOutlineColor());
+    shader_manager->setUniform(shader_program, "color.glow_color",
+        text->getGlowColor());
+    shader_manager->setUniform(shader_program, "color.shadow_color",
+        text->getShadowColor());
+
+    shader_manager->setUniform(shader_program, "distance_field.outline_edge",
+        outline_edge);
+    shader_manager->setUniform(shader_program, "distance_field.glow_edge",
+        glow_edge);
+    shader_manager->setUniform(shader_program,
+        "distance_field.shadow_enabled",
+        static_cast<GLint>(text->isShadowEnabled()));
+    shader_manager->setUniform(shader_program, "distance_field.shadow_edge",
+        shadow_edge);
+    shader_manager->setUniform(shader_program,
+        "distance_field.shadow_offset", shadow_offset);
 }
\ No newline at end of file
@@ -0,0 +1,236 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#include "Puffin/Renderer/GlyphAtlas.h"
+
+using namespace puffin;
+
+GlyphAtlas::GlyphAtlas(MasterManagerPtr master_manager)
+{
+    if (!master_manager)
+        logErrorAndThrow(name_, "GlyphAtlas::GlyphAtlas()",
+            "Object [MasterManager] pointer not set.");
+
+    master_manager_ = master_manager;
+
+    logDebug(name_, "GlyphAtlas::GlyphAtlas()", "Glyph atlas created.");
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    logDebug(name_, "GlyphAtlas::~GlyphAtlas()", "Glyph atlas destroyed.");
+}
+
+void GlyphAtlas::setPageSize(GLint size)
+{
+    if (size <= 0)
+        logErrorAndThrow(name_, "GlyphAtlas::setPageSize()",
+            "Page size value out of range: {0 < VALUE}.");
+
+    page_size_ = size;
+}
+
+void GlyphAtlas::setMaxPagesCount(GLint count)
+{
+    if (count <= 0)
+        logErrorAndThrow(name_, "GlyphAtlas::setMaxPagesCount()",
+            "Pages count value out of range: {0 < VALUE}.");
+
+    max_pages_count_ = count;
+}
+
+void GlyphAtlas::clear()
+{
+    glyphs_.clear();
+    generation_++;
+
+    for (auto &page : pages_)
+    {
+        page.shelves.clear();
+        page.used_height = 0;
+    }
+}
+
+GLboolean GlyphAtlas::findGlyph(const GlyphKey &key, Glyph &glyph)
+{
+    auto result = glyphs_.find(key);
+    if (result == glyphs_.end())
+        return false;
+
+    glyph = result->second;
+    if (glyph.page >= 0)
+        pages_[glyph.page].last_use_frame = frame_index_;
+
+    return true;
+}
+
+GLboolean GlyphAtlas::addGlyph(const GlyphKey &key, const GLubyte *bitmap,
+    const glm::ivec2 &size, const glm::ivec2 &bearing, GLint advance,
+    Glyph &glyph, GLint extra_padding)
+{
+    glyph = Glyph();
+    glyph.size = size;
+    glyph.bearing = bearing;
+    glyph.advance = advance;
+
+    if (size.x <= 0 || size.y <= 0 || !bitmap)
+    {
+        glyphs_[key] = glyph;
+        return true;
+    }
+
+    if (extra_padding < 0)
+        logErrorAndThrow(name_, "GlyphAtlas::addGlyph()",
+            "Extra padding value out of range: {0 <= VALUE}.");
+
+    GLint padding = glyph_padding_ + extra_padding;
+    GLint width = size.x + 2 * padding;
+    GLint height = size.y + 2 * padding;
+
+    glm::ivec2 position(0, 0);
+    GLint page_index = getPageForGlyph(width, height, position);
+    if (page_index < 0)
+    {
+        logWarning(name_, "GlyphAtlas::addGlyph()",
+            "Glyph does not fit into atlas page.");
+        return false;
+    }
+
+    // Border is uploaded too, because page may contain evicted glyphs
+    std::vector<GLubyte> data(width * height, 0);
+    for (GLint row = 0; row < size.y; row++)
+    {
+        std::memcpy(&data[(row + padding) * width + padding],
+            bitmap + row * size.x, size.x);
+    }
+
+    auto &page = pages_[page_index];
+    master_manager_->textureManager()->setUnpackPixelAlignment(1);
+    master_manager_->textureManager()->updateTexture2DData(page.texture,
+        data.data(), position.x, position.y, width, height);
+    master_manager_->textureManager()->setUnpackPixelAlignment(4);
+
+    page.last_use_frame = frame_index_;
+
+    GLfloat page_size = static_cast<GLfloat>(page.texture->getWidth());
+    glyph.page = page_index;
+    glyph.uv_min = glm::vec2(position + padding) / page_size;
+    glyph.uv_max = glm::vec2(position + padding + size) / page_size;
+
+    glyphs_[key] = glyph;
+    return true;
+}
+
+GLint GlyphAtlas::createPage()
+{
+    Page page;
+    page.texture = master_manager_->textureManager()->createTexture2D(
+        "glyph_atlas_page_" + std::to_string(pages_.size()));
+
+    std::vector<GLubyte> data(page_size_ * page_size_, 0);
+    master_manager_->textureManager()->setUnpackPixelAlignment(1);
+    master_manager_->textureManager()->setTexture2DData(page.texture,
+        data.data(), page_size_, page_size_, 1);
+    master_manager_->textureManager()->setUnpackPixelAlignment(4);
+
+    master_manager_->textureManager()->setTextureFilter(page.texture,
+        TextureFilter::BILINEAR);
+    master_manager_->textureManager()->setTextureWrap(page.texture,
+        TextureWrap::CLAMP_TO_EDGE);
+
+    pages_.push_back(page);
+
+    logInfo(name_, "GlyphAtlas::createPage()", "Glyph atlas page [" +
+        std::to_string(pages_.size() - 1) + "] created.");
+
+    return static_cast<GLint>(pages_.size()) - 1;
+}
+
+GLint GlyphAtlas::getPageForGlyph(GLint width, GLint height,
+    glm::ivec2 &position)
+{
+    for (GLuint i = 0; i < pages_.size(); i++)
+    {
+        if (packGlyph(pages_[i], width, height, position))
+            return static_cast<GLint>(i);
+    }
+
+    GLint page_index = -1;
+    if (static_cast<GLint>(pages_.size()) < max_pages_count_)
+        page_index = createPage();
+    else
+        page_index = evictLeastRecentlyUsedPage();
+
+    if (!packGlyph(pages_[page_index], width, height, position))
+        return -1;
+
+    return page_index;
+}
+
+GLboolean GlyphAtlas::packGlyph(Page &page, GLint width, GLint height,
+    glm::ivec2 &position) const
+{
+    GLint page_size = page.texture->getWidth();
+    if (width > page_size || height > page_size)
+        return false;
+
+    // Lowest shelf, which is high enough, wastes the least space
+    Shelf *best_shelf = nullptr;
+    for (auto &shelf : page.shelves)
+    {
+        if (shelf.height >= height && page_size - shelf.used_width >= width &&
+            (!best_shelf || shelf.height < best_shelf->height))
+            best_shelf = &shelf;
+    }
+
+    if (!best_shelf)
+    {
+        if (page_size - page.used_height < height)
+            return false;
+
+        Shelf shelf;
+        shelf.y = page.used_height;
+        shelf.height = height;
+        page.used_height += height;
+        page.shelves.push_back(shelf);
+
+        best_shelf = &page.shelves.back();
+    }
+
+    position = glm::ivec2(best_shelf->used_width, best_shelf->y);
+    best_shelf->used_width += width;
+
+    return true;
+}
+
+GLint GlyphAtlas::evictLeastRecentlyUsedPage()
+{
+    GLint page_index = 0;
+    for (GLuint i = 1; i < pages_.size(); i++)
+    {
+        if (pages_[i].last_use_frame < pages_[page_index].last_use_frame)
+            page_index = static_cast<GLint>(i);
+    }
+
+    if (pages_[page_index].last_use_frame == frame_index_)
+        logWarning(name_, "GlyphAtlas::evictLeastRecentlyUsedPage()",
+            "Evicted glyph atlas page is used in current frame. Atlas is too "
+            "small.");
+
+    for (auto glyph = glyphs_.begin(); glyph != glyphs_.end();)
+    {
+        if (glyph->second.page == page_index)
+            glyph = glyphs_.erase(glyph);
+        else
+            glyph++;
+    }
+
+    auto &page = pages_[page_index];
+    page.shelves.clear();
+    page.used_height = 0;
+
+    generation_++;
+    return page_index;
+}
\ No newline at end of file
@@ -9,7 +9,7 @@ using namespace puffin;
 
 MasterRenderer::MasterRenderer(MasterManagerPtr master_manager,
     StateMachinePtr state_machine, DisplayPtr display,
-    DisplayConfigurationPtr display_configuration)
+    DisplayConfigurationPtr display_configuration, JobSystemPtr job_system)
 {
     if (!master_manager)
         logErrorAndThrow(name_, "MasterRenderer::MasterRenderer()",
@@ -27,14 +27,21 @@ MasterRenderer::MasterRenderer(MasterManagerPtr master_manager,
         logErrorAndThrow(name_, "MasterRenderer::MasterRenderer()",
             "Object [DisplayConfiguration] pointer not set.");
 
+    if (!job_system)
+        logErrorAndThrow(name_, "MasterRenderer::MasterRenderer()",
+            "Object [JobSystem] pointer not set.");
+
     master_manager_ = master_manager;
     state_machine_ = state_machine;
     target_display_ = display;
     display_configuration_ = display_configuration;
+    job_system_ = job_system;
 
+    dynamic_resolution_.reset(new DynamicResolution());
     fog_.reset(new Fog());
     polygon_mode_.reset(new PolygonMode());
     fps_counter_.reset(new FpsCounter());
+    fixed_timestep_.reset(new FixedTimestep());
     shadow_map_.reset(new ShadowMapConfiguration());
 
     // Create renderers
@@ -47,14 +54,17 @@ MasterRenderer::MasterRenderer(MasterManagerPtr master_manager,
         master_manager_->frameBufferManager()));
     model3d_renderer_.reset(new Object3DRenderer(master_manager_,
         state_machine_, display_configuration_, shadow_map_, fog_,
-        polygon_mode_));
+        polygon_mode_, job_system_));
     particle_renderer_.reset(new ParticleRenderer(master_manager_,
-        state_machine_, display_configuration_, fps_counter_));
+        state_machine_, display_configuration_));
     shadow_map_renderer_.reset(new ShadowMapRenderer(master_manager_,
         state_machine_, model3d_renderer_, shadow_map_));
     water_renderer_.reset(new WaterRenderer(master_manager_, state_machine_,
-        display_configuration_, fog_, fps_counter_, model3d_renderer_,
-        skybox_renderer_));
+        display_configuration_, fog_, model3d_renderer_, skybox_renderer_));
+
+    // Renderers only start compiling their shaders, so driver can process
+    // all of them together
+    master_manager_->shaderManager()->finishShaderPrograms();
 
     createScreenModel();
 
@@ -71,11 +81,26 @@ MasterRenderer::~MasterRenderer()
 void MasterRenderer::start()
 {
     rendering_enabled_ = true;
+    if (render_thread_enabled_)
+    {
+        startWithRenderThread();
+        return;
+    }
+
     while (rendering_enabled_)
     {
         fps_counter_->startDeltaMeasure();
 
         target_display_->pollEvents();
+        job_system_->runMainThreadJobs();
+
+        // Simulation advances in fixed steps regardless of frame rate,
+        // frame shows state between two last steps
+        GLint steps = fixed_timestep_->advance(fps_counter_->getDelta());
+        for (GLint i = 0; i < steps; i++)
+            simulate(fixed_timestep_->getStep());
+
+        interpolate(fixed_timestep_->getAlpha());
 
         if (rendering_function_ != nullptr)
             rendering_function_();
@@ -94,6 +119,316 @@ void MasterRenderer::stop()
     rendering_enabled_ = false;
 }
 
+void MasterRenderer::enableRenderThread(GLboolean state)
+{
+    if (rendering_enabled_)
+        logErrorAndThrow(name_, "MasterRenderer::enableRenderThread()",
+            "Render thread cannot be changed while rendering.");
+
+    render_thread_enabled_ = state;
+}
+
+void MasterRenderer::runOnRenderThread(std::function<void()> function)
+{
+    if (!function)
+        logErrorAndThrow(name_, "MasterRenderer::runOnRenderThread()",
+            "Specified empty function pointer.");
+
+    if (!render_thread_.joinable())
+    {
+        function();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    render_thread_jobs_.push_back(function);
+}
+
+void MasterRenderer::startWithRenderThread()
+{
+    if (!used_scene_)
+        logErrorAndThrow(name_, "MasterRenderer::startWithRenderThread()",
+            "Object [Scene] pointer not set.");
+
+    if (!active_camera_)
+        logErrorAndThrow(name_, "MasterRenderer::startWithRenderThread()",
+            "Object [Camera] pointer not set.");
+
+    simulated_scene_ = used_scene_;
+
+    free_snapshots_.clear();
+    free_snapshots_.push_back(FrameSnapshotPtr(new FrameSnapshot()));
+    free_snapshots_.push_back(FrameSnapshotPtr(new FrameSnapshot()));
+    ready_snapshot_ = nullptr;
+    render_thread_exception_ = nullptr;
+    render_thread_running_ = true;
+
+    target_display_->releaseContext();
+    render_thread_ = std::thread(&MasterRenderer::renderThreadLoop, this);
+
+    logDebug(name_, "MasterRenderer::startWithRenderThread()",
+        "Render thread started.");
+
+    {
+        // Render thread is joined also when simulation throws
+        struct RenderThreadGuard
+        {
+            ~RenderThreadGuard()
+            {
+                renderer->stopRenderThread();
+            }
+
+            MasterRenderer *renderer;
+        } guard{this};
+
+        while (rendering_enabled_)
+        {
+            fps_counter_->startDeltaMeasure();
+
+            target_display_->pollEvents();
+            job_system_->runMainThreadJobs();
+
+            GLint steps = fixed_timestep_->advance(fps_counter_->
+                getDelta());
+            for (GLint i = 0; i < steps; i++)
+                simulate(fixed_timestep_->getStep());
+
+            interpolate(fixed_timestep_->getAlpha());
+
+            // Waits while render thread is busy with both snapshots, so
+            // simulation is at most one frame ahead of rendering
+            if (!submitSnapshot(steps * fixed_timestep_->getStep()))
+                stop();
+
+            fps_counter_->update();
+            fps_counter_->endDeltaMeasure();
+
+            if (target_display_->isClosing())
+                stop();
+        }
+    }
+
+    if (render_thread_exception_)
+        std::rethrow_exception(render_thread_exception_);
+}
+
+void MasterRenderer::stopRenderThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        render_thread_running_ = false;
+    }
+
+    snapshot_condition_.notify_all();
+    render_thread_.join();
+
+    target_display_->makeContextCurrent();
+
+    // Renderers use live state again
+    master_manager_->lightManager()->useRenderLights(false, nullptr,
+        nullptr);
+    useRenderCamera(active_camera_);
+    free_snapshots_.clear();
+    ready_snapshot_ = nullptr;
+
+    logDebug(name_, "MasterRenderer::stopRenderThread()",
+        "Render thread stopped.");
+}
+
+void MasterRenderer::renderThreadLoop()
+{
+    target_display_->makeContextCurrent();
+
+    try
+    {
+        while (true)
+        {
+            FrameSnapshotPtr snapshot = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(snapshot_mutex_);
+                snapshot_condition_.wait(lock, [this]()
+                {
+                    return ready_snapshot_ != nullptr ||
+                        !render_thread_running_;
+                });
+
+                if (!render_thread_running_)
+                    break;
+
+                snapshot = ready_snapshot_;
+                ready_snapshot_ = nullptr;
+            }
+
+            snapshot_condition_.notify_all();
+
+            // Work queued before snapshot was submitted is done first
+            runRenderThreadJobs();
+
+            renderSnapshot(snapshot);
+            target_display_->swapBuffers();
+
+            {
+                std::lock_guard<std::mutex> lock(snapshot_mutex_);
+                free_snapshots_.push_back(snapshot);
+            }
+
+            snapshot_condition_.notify_all();
+        }
+
+        runRenderThreadJobs();
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard<std::mutex> lock(snapshot_mutex_);
+            render_thread_exception_ = std::current_exception();
+            render_thread_running_ = false;
+        }
+
+        snapshot_condition_.notify_all();
+    }
+
+    target_display_->releaseContext();
+}
+
+void MasterRenderer::runRenderThreadJobs()
+{
+    std::vector<std::function<void()>> jobs;
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        jobs.swap(render_thread_jobs_);
+    }
+
+    for (const auto &job : jobs)
+        job();
+}
+
+GLboolean MasterRenderer::submitSnapshot(GLdouble delta)
+{
+    FrameSnapshotPtr snapshot = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(snapshot_mutex_);
+        snapshot_condition_.wait(lock, [this]()
+        {
+            return !free_snapshots_.empty() || !render_thread_running_;
+        });
+
+        // Render thread has failed
+        if (!render_thread_running_)
+            return false;
+
+        snapshot = free_snapshots_.back();
+        free_snapshots_.pop_back();
+    }
+
+    // Filled without lock, render thread works on other snapshot
+    captureSnapshot(snapshot, delta);
+
+    {
+        std::unique_lock<std::mutex> lock(snapshot_mutex_);
+        snapshot_condition_.wait(lock, [this]()
+        {
+            return ready_snapshot_ == nullptr || !render_thread_running_;
+        });
+
+        if (!render_thread_running_)
+            return false;
+
+        ready_snapshot_ = snapshot;
+    }
+
+    snapshot_condition_.notify_all();
+    return true;
+}
+
+void MasterRenderer::captureSnapshot(FrameSnapshotPtr snapshot,
+    GLdouble delta)
+{
+    snapshot->frame_index_ = snapshots_count_++;
+    snapshot->delta_ = delta;
+
+    // Copy keeps its own box, renderers change it while drawing
+    auto camera_box = snapshot->camera_->camera_box_;
+    *snapshot->camera_ = *active_camera_;
+    *camera_box = *active_camera_->camera_box_;
+    snapshot->camera_->camera_box_ = camera_box;
+
+    *snapshot->scene_ = *simulated_scene_;
+
+    const auto &objects = simulated_scene_->object3d_container_;
+    snapshot->objects_.resize(objects.size());
+    job_system_->parallelFor(objects.size(), [&](GLuint begin, GLuint end)
+    {
+        for (GLuint i = begin; i < end; i++)
+        {
+            auto &state = snapshot->objects_[i];
+            state.object = objects[i];
+            state.model_matrix = objects[i]->calculateRenderModelMatrix();
+            state.bounding_sphere_radius = objects[i]->
+                getBoundingSphereRadius();
+        }
+    });
+
+    // Water tiles are drawn live. Their cached matrices are computed here,
+    // so render thread only reads them.
+    for (const auto &tile : simulated_scene_->getWaterTileContainer())
+        tile->getModelMatrix();
+
+    // Texts are edited freely by simulation, so snapshot draws their copies.
+    // Copies live as long as original is in scene, so their meshes are
+    // cached by font renderer.
+    std::map<TextPtr, TextPtr> texts;
+    snapshot->scene_->text_container_.clear();
+    for (const auto &text : simulated_scene_->text_container_)
+    {
+        auto text_copy = snapshot->texts_[text];
+        if (text_copy)
+            *text_copy = *text;
+        else
+            text_copy.reset(new Text(*text));
+
+        texts[text] = text_copy;
+        snapshot->scene_->text_container_.push_back(text_copy);
+    }
+
+    snapshot->texts_.swap(texts);
+
+    auto light_manager = master_manager_->lightManager();
+    snapshot->lighting_enabled_ = light_manager->isLightingEnabled();
+    *snapshot->directional_light_ = *light_manager->directionalLight();
+
+    const auto &point_lights = light_manager->getPointLightContainer();
+    snapshot->point_lights_.resize(point_lights.size());
+    for (std::size_t i = 0; i < point_lights.size(); i++)
+    {
+        if (snapshot->point_lights_[i])
+            *snapshot->point_lights_[i] = *point_lights[i];
+        else
+            snapshot->point_lights_[i].reset(new PointLight(
+                *point_lights[i]));
+    }
+}
+
+void MasterRenderer::renderSnapshot(FrameSnapshotPtr snapshot)
+{
+    for (const auto &state : snapshot->objects_)
+    {
+        state.object->setRenderTransform(state.model_matrix,
+            state.bounding_sphere_radius);
+    }
+
+    master_manager_->lightManager()->useRenderLights(
+        snapshot->lighting_enabled_, snapshot->directional_light_,
+        &snapshot->point_lights_);
+    useRenderCamera(snapshot->camera_);
+
+    // Visual effects are advanced by simulation time covered by snapshot
+    particle_renderer_->update(snapshot->scene_, snapshot->delta_);
+    water_renderer_->update(snapshot->scene_, snapshot->delta_);
+
+    renderScene(snapshot->scene_);
+}
+
 void MasterRenderer::assignRenderingFunction(std::function<void()> function)
 {
     if (!function)
@@ -106,6 +441,63 @@ void MasterRenderer::assignRenderingFunction(std::function<void()> function)
         "Rendering function set.");
 }
 
+void MasterRenderer::assignSimulationFunction(
+    std::function<void(GLdouble)> function)
+{
+    if (!function)
+        logErrorAndThrow(name_, "MasterRenderer::assignSimulationFunction()",
+            "Specified empty simulation function pointer.");
+
+    simulation_function_ = function;
+
+    logDebug(name_, "MasterRenderer::assignSimulationFunction()",
+        "Simulation function set.");
+}
+
+void MasterRenderer::simulate(GLdouble delta)
+{
+    // State before step is kept, so rendering can blend it with new one.
+    // Camera and objects are blended only if they are moved by simulation
+    // function, otherwise they are moved by rendering function between steps.
+    if (active_camera_ && simulation_function_ != nullptr)
+        active_camera_->storePreviousPosition();
+
+    if (simulated_scene_ && simulation_function_ != nullptr)
+    {
+        for (const auto &object : simulated_scene_->getObject3DContainer())
+            object->storePreviousTransform();
+    }
+
+    if (simulation_function_ != nullptr)
+        simulation_function_(delta);
+
+    if (active_camera_)
+        active_camera_->update(delta);
+
+    // Render thread updates them with snapshot's time
+    if (simulated_scene_ && !render_thread_.joinable())
+    {
+        particle_renderer_->update(simulated_scene_, delta);
+        water_renderer_->update(simulated_scene_, delta);
+    }
+}
+
+void MasterRenderer::interpolate(GLfloat alpha)
+{
+    // There is no previous state before first step
+    if (fixed_timestep_->getTicksCount() == 0)
+        return;
+
+    if (active_camera_ && simulation_function_ != nullptr)
+        active_camera_->setInterpolationAlpha(alpha);
+
+    if (simulated_scene_ && simulation_function_ != nullptr)
+    {
+        for (const auto &object : simulated_scene_->getObject3DContainer())
+            object->setInterpolationAlpha(alpha);
+    }
+}
+
 void MasterRenderer::createScreenModel()
 {
     screen_ = master_manager_->meshManager()->createObject3D("screen");
@@ -143,29 +535,62 @@ void MasterRenderer::drawScene(ScenePtr scene)
     if (!scene)
         return;
 
+    simulated_scene_ = scene;
+
+    updateRenderTransforms(scene);
+    renderScene(scene);
+
+    // Counted by main thread, render thread does not touch counter
+    fps_counter_->update();
+}
+
+void MasterRenderer::updateRenderTransforms(ScenePtr scene)
+{
+    // Objects are independent, so they are updated in parallel
+    auto objects = scene->getObject3DContainer();
+    job_system_->parallelFor(objects.size(), [&](GLuint begin, GLuint end)
+    {
+        for (GLuint i = begin; i < end; i++)
+            objects[i]->updateRenderTransform();
+    });
+}
+
+void MasterRenderer::renderScene(ScenePtr scene)
+{
+    dynamic_resolution_->beginFrame();
+    postprocess_renderer_->setRenderScale(dynamic_resolution_->
+        getRenderScale());
+
     state_machine_->depthTest()->enableDepthMask(true);
     state_machine_->depthTest()->enable(true);
     state_machine_->faceCulling()->enable(true);
 
     // Render shadow map
     if (!polygon_mode_->isEnabled() && shadow_map_->isShadowsEnabled() &&
-        master_manager_->lightManager()->isLightingEnabled())
+        master_manager_->lightManager()->isRenderLightingEnabled())
         shadow_map_renderer_->render(scene);
 
     // Render water tiles reflection and refraction
-    active_camera_->update_camera_box_ = false;
+    render_camera_->update_camera_box_ = false;
     model3d_renderer_->enableFullRender(false);
     water_renderer_->renderToFrameBuffers(scene);
-    active_camera_->update_camera_box_ = true;
+    render_camera_->update_camera_box_ = true;
 
     state_machine_->unbindFrameBuffer();
     clear();
 
-    if (!polygonMode()->isEnabled())
+    GLboolean use_postprocess = !polygonMode()->isEnabled() &&
+        !postprocess_renderer_->canRenderDirectly();
+
+    if (use_postprocess)
     {
         state_machine_->bindFrameBuffer(postprocess_renderer_->
             frame_buffer_multisample_);
         clear();
+
+        // Postprocess pass stretches scaled scene to the window
+        state_machine_->setViewport(0, 0, postprocess_renderer_->
+            getRenderWidth(), postprocess_renderer_->getRenderHeight());
     }
 
     if (!polygonMode()->isEnabled())
@@ -176,27 +601,21 @@ void MasterRenderer::drawScene(ScenePtr scene)
     water_renderer_->render(scene);
     particle_renderer_->render(scene);
 
-    if (!polygonMode()->isEnabled())
+    if (use_postprocess)
     {
         state_machine_->alphaBlend()->enable(false);
-        state_machine_->activateShaderProgram(postprocess_renderer_->
-            shader_program_);
-        postprocess_renderer_->setShaderUniforms();
-
-        state_machine_->bindMesh(screen_);
-
-        master_manager_->textureManager()->setTextureSlot(0);
-        state_machine_->bindTexture(postprocess_renderer_->
-            getFrameBufferToRender()->getRgbTextureBuffer());
         state_machine_->unbindFrameBuffer();
         clear();
 
-        screen_->draw();
+        postprocess_renderer_->render(screen_);
+    }
 
+    if (!polygonMode()->isEnabled())
+    {
         // GUI
         font_renderer_->render(scene);
     }
 
-    active_camera_->update(fps_counter_->getDelta());
-    fps_counter_->update();
+    dynamic_resolution_->endFrame();
+    state_machine_->endFrame();
 }
\ No newline at end of file
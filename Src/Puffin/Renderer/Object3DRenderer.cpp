@@ -11,7 +11,8 @@ Object3DRenderer::Object3DRenderer(MasterManagerPtr master_manager,
     StateMachinePtr state_machine,
     DisplayConfigurationPtr display_configuration,
     ShadowMapConfigurationPtr shadow_map_configuration, FogPtr fog,
-    PolygonModePtr polygon_mode) : BaseRenderer("core_object3d_renderer")
+    PolygonModePtr polygon_mode, JobSystemPtr job_system) :
+    BaseRenderer("core_object3d_renderer")
 {
     if (!master_manager)
         logErrorAndThrow(name_, "Object3DRenderer::Object3DRenderer()",
@@ -37,16 +38,25 @@ Object3DRenderer::Object3DRenderer(MasterManagerPtr master_manager,
         logErrorAndThrow(name_, "Object3DRenderer::Object3DRenderer()",
             "Object [PolygonMode] pointer not set.");
 
+    if (!job_system)
+        logErrorAndThrow(name_, "Object3DRenderer::Object3DRenderer()",
+            "Object [JobSystem] pointer not set.");
+
     master_manager_ = master_manager;
     state_machine_ = state_machine;
     display_configuration_ = display_configuration;
     shadow_map_ = shadow_map_configuration;
     fog_ = fog;
     polygon_mode_ = polygon_mode;
+    job_system_ = job_system;
 
-    stencil_buffer_.reset(new StencilBuffer());
+    stencil_buffer_ = state_machine_->stencilBuffer();
     stencil_buffer_->enable(true);
 
+    clustered_lighting_.reset(new ClusteredLighting(master_manager_,
+        state_machine_));
+    render_timer_.reset(new GpuTimer("core_object3d_render_timer"));
+
     loadShaders();
 
     logDebug(name_, "Object3DRenderer::Object3DRenderer()",
@@ -61,18 +71,24 @@ Object3DRenderer::~Object3DRenderer()
 
 void Object3DRenderer::loadShaders()
 {
-    basic_shader_ = master_manager_->shaderManager()->
-        createShaderProgram("object3d_basic_shader",
-            "shaders/Object3DBasicVs.glsl", "shaders/Object3DBasicFs.glsl",
-            "shaders/Object3DBasicGs.glsl");
+    // Variants are compiled when they are used for the first time
+    basic_shader_variants_ = master_manager_->shaderManager()->
+        createShaderVariants("object3d_basic_shader",
+            "shaders/Object3DBasicVs.glsl", "shaders/Object3DBasicFs.glsl", "",
+            {"LIGHTING", "SHADOWS", "FOG", "DIFFUSE_TEXTURE",
+            "NORMALMAP_TEXTURE"});
+
+    // Variant without features is used while other ones are compiling
+    master_manager_->shaderManager()->requestShaderVariant(
+        basic_shader_variants_, 0);
 
     outline_shader_ = master_manager_->shaderManager()->
-        createShaderProgram("object3d_outline_shader",
+        createShaderProgramAsync("object3d_outline_shader",
             "shaders/Object3DOutlineVs.glsl",
             "shaders/Object3DOutlineFs.glsl");
 
     polygon_mode_shader_ = master_manager_->shaderManager()->
-        createShaderProgram("object3d_polygon_mode_shader",
+        createShaderProgramAsync("object3d_polygon_mode_shader",
             "shaders/Object3DPolygonVs.glsl", "shaders/Object3DPolygonFs.glsl");
 }
 
@@ -81,26 +97,223 @@ void Object3DRenderer::render(ScenePtr scene)
     if (!scene)
         return;
 
-    auto objects_3d = scene->getObject3DContainer();
-    if (objects_3d.empty())
+    render_timer_->begin();
+    render(scene, scene->getObject3DContainer());
+    render_timer_->end();
+}
+
+void Object3DRenderer::render(ScenePtr scene,
+    const std::vector<Object3DPtr> &objects_3d)
+{
+    if (!scene || objects_3d.empty())
         return;
 
     active_skybox_ = scene->getActiveSkybox();
 
-    for (const auto &object_3d : objects_3d)
-        renderObject3D(object_3d);
+    // Clusters depend on camera, so they are rebuilt for every pass
+    if (master_manager_->lightManager()->isRenderLightingEnabled())
+        clustered_lighting_->update(active_camera_, point_shadow_tiles_);
+
+    // Debug polygon mode draws every object with one shader
+    if (polygon_mode_->isEnabled() && !polygon_mode_->isUsingPipeline())
+    {
+        for (const auto &object_3d : objects_3d)
+            renderPolygonMode(object_3d);
+
+        return;
+    }
+
+    buildCommands(objects_3d);
+    executeCommands(objects_3d);
+}
+
+void Object3DRenderer::buildCommands(
+    const std::vector<Object3DPtr> &objects_3d)
+{
+    GLuint frame_features = getFrameFeatures();
+    auto camera_position = active_camera_->getRenderPosition();
+
+    GLuint batches_count = (objects_3d.size() + commands_batch_size_ - 1) /
+        commands_batch_size_;
+    if (batch_command_buffers_.size() < batches_count)
+        batch_command_buffers_.resize(batches_count);
+
+    // Building does not touch OpenGL, so batches run on any thread
+    job_system_->parallelFor(objects_3d.size(), [&](GLuint begin, GLuint end)
+    {
+        auto &batch_buffer = batch_command_buffers_[begin /
+            commands_batch_size_];
+        batch_buffer.clear();
+
+        for (GLuint i = begin; i < end; i++)
+        {
+            addObjectCommands(batch_buffer, objects_3d[i], i, frame_features,
+                camera_position);
+        }
+    }, commands_batch_size_);
+
+    command_buffer_.clear();
+    for (GLuint i = 0; i < batches_count; i++)
+        command_buffer_.append(batch_command_buffers_[i]);
+
+    command_buffer_.sort();
+}
+
+void Object3DRenderer::addObjectCommands(RenderCommandBuffer &command_buffer,
+    Object3DPtr object3d, GLuint object_index, GLuint frame_features,
+    const glm::vec3 &camera_position) const
+{
+    if (!object3d)
+        return;
+
+    OutlinePtr outline = std::static_pointer_cast<Outline>
+        (object3d->getModifier(Object3DModifierType::OUTLINE));
+
+    GLboolean render_outline = full_render_ && !polygon_mode_->isEnabled() &&
+        outline != nullptr && outline->isEnabled();
+
+    // Within same shader and material near objects are drawn first, so
+    // they hide pixels of further ones
+    GLfloat depth = glm::length(object3d->getRenderBoundingSphereCenter() -
+        camera_position) / active_camera_->getFarPlane();
+
+    GLuint pass = render_outline ? COMMAND_PASS_OUTLINED :
+        COMMAND_PASS_OPAQUE;
+
+    for (GLuint i = 0; i < object3d->getEntitiesCount(); i++)
+    {
+        auto material = object3d->getEntity(i)->getMaterial();
+
+        // Materials have no identifiers, address is used for grouping
+        GLuint material_id = static_cast<GLuint>(reinterpret_cast<
+            std::uintptr_t>(material.get()) >> 4);
+
+        RenderCommand command;
+        command.object_index = object_index;
+        command.entity_index = i;
+        command.features = frame_features | getMaterialFeatures(material,
+            frame_features);
+        command.key = RenderCommandBuffer::makeKey(pass, command.features,
+            material_id, depth, object_index);
+        command_buffer.add(command);
+    }
+
+    if (render_outline)
+    {
+        RenderCommand command;
+        command.object_index = object_index;
+        command.key = RenderCommandBuffer::makeKey(COMMAND_PASS_OUTLINE, 0, 0,
+            depth, object_index);
+        command_buffer.add(command);
+    }
+}
+
+void Object3DRenderer::executeCommands(
+    const std::vector<Object3DPtr> &objects_3d)
+{
+    prepareRendering();
+
+    // State is changed only when command needs different one
+    GLuint active_pass = COMMAND_PASS_OPAQUE;
+    ShaderProgramPtr active_variant = nullptr;
+    Object3DPtr active_object = nullptr;
+    MaterialPtr active_material = nullptr;
+
+    for (const auto &command : command_buffer_.getCommands())
+    {
+        GLuint pass = RenderCommandBuffer::getPass(command.key);
+        if (pass != active_pass)
+        {
+            beginCommandPass(pass);
+            active_pass = pass;
+            active_variant = nullptr;
+        }
+
+        const auto &object3d = objects_3d[command.object_index];
+        if (pass == COMMAND_PASS_OUTLINE)
+        {
+            renderOutline(object3d, active_variant == nullptr);
+            active_variant = outline_shader_;
+            continue;
+        }
+
+        GLuint features = command.features;
+        auto shader_program = master_manager_->shaderManager()->
+            requestShaderVariant(basic_shader_variants_, features);
+
+        // Variant without features is used while requested one is compiling
+        if (!master_manager_->shaderManager()->isShaderProgramReady(
+            shader_program))
+        {
+            features = 0;
+            shader_program = master_manager_->shaderManager()->
+                getShaderVariant(basic_shader_variants_, features);
+        }
+
+        if (shader_program != active_variant)
+        {
+            state_machine_->activateShaderProgram(shader_program);
+            setBasicShaderUniforms(shader_program, features);
+            active_variant = shader_program;
+            active_object = nullptr;
+            active_material = nullptr;
+        }
+
+        if (object3d != active_object)
+        {
+            state_machine_->bindMesh(object3d);
+            master_manager_->shaderManager()->setUniform(shader_program,
+                "matrices.model_matrix", object3d->getRenderModelMatrix());
+            active_object = object3d;
+        }
+
+        auto material = object3d->getEntity(command.entity_index)->
+            getMaterial();
+        if (material != active_material)
+        {
+            setMaterials(object3d, command.entity_index, shader_program,
+                features);
+            active_material = material;
+        }
+
+        object3d->draw(command.entity_index);
+    }
+
+    if (active_pass != COMMAND_PASS_OPAQUE)
+        endCommandPasses();
+}
+
+void Object3DRenderer::beginCommandPass(GLuint pass)
+{
+    switch (pass)
+    {
+    case COMMAND_PASS_OUTLINED:
+        stencil_buffer_->enableDrawing(true);
+        stencil_buffer_->setAction(StencilBufferAction::REPLACE);
+        stencil_buffer_->passesAlways(1);
+        break;
+    case COMMAND_PASS_OUTLINE:
+        stencil_buffer_->passesNotEqual(1);
+        stencil_buffer_->enableDrawing(false);
+        break;
+    }
+}
+
+void Object3DRenderer::endCommandPasses()
+{
+    stencil_buffer_->enableDrawing(true);
+    stencil_buffer_->setAction(StencilBufferAction::KEEP);
+    state_machine_->depthTest()->enable(true);
 }
 
 void Object3DRenderer::setCameraMatricesUniforms(
-    ShaderProgramPtr shader_program, Object3DPtr object3d)
+    ShaderProgramPtr shader_program)
 {
     master_manager_->shaderManager()->setUniform(shader_program,
         "matrices.view_matrix", active_camera_->getViewMatrix());
     master_manager_->shaderManager()->setUniform(shader_program,
         "matrices.projection_matrix", active_camera_->
         getProjectionMatrix());
-    master_manager_->shaderManager()->setUniform(shader_program,
-        "matrices.model_matrix", object3d->getModelMatrix());
 }
 
 void Object3DRenderer::setPolygonModeUniforms(ShaderProgramPtr shader_program)
@@ -109,30 +322,77 @@ void Object3DRenderer::setPolygonModeUniforms(ShaderProgramPtr shader_program)
         "lines_color", polygon_mode_->getLinesColor());
 }
 
-void Object3DRenderer::renderObject3DEntities(Object3DPtr object3d,
-    ShaderProgramPtr shader_program, GLboolean use_materials)
+void Object3DRenderer::renderObject3DEntities(Object3DPtr object3d)
 {
     for (GLuint i = 0; i < object3d->getEntitiesCount(); i++)
+        object3d->draw(i);
+}
+
+GLuint Object3DRenderer::getFrameFeatures() const
+{
+    GLuint features = 0;
+
+    if (master_manager_->lightManager()->isRenderLightingEnabled())
     {
-        if (use_materials)
-            setMaterials(object3d, i, shader_program);
+        features |= FEATURE_LIGHTING;
 
-        object3d->draw(i);
+        if (shadow_map_->isShadowsEnabled())
+            features |= FEATURE_SHADOWS;
     }
+
+    if (fog_->isEnabled())
+        features |= FEATURE_FOG;
+
+    return features;
 }
 
-void Object3DRenderer::setFogUniforms(ShaderProgramPtr shader_program)
+GLuint Object3DRenderer::getMaterialFeatures(MaterialPtr material,
+    GLuint frame_features) const
 {
-    master_manager_->shaderManager()->setUniform(shader_program, "fog.enabled",
-        fog_->isEnabled() ? 1 : 0);
+    GLuint features = 0;
+    if (!material)
+        return features;
 
-    if (fog_->isEnabled())
-    {
-        master_manager_->shaderManager()->setUniform(shader_program,
-            "fog.color", fog_->getColor());
+    if (material->getDiffuseTexture())
+        features |= FEATURE_DIFFUSE_TEXTURE;
+
+    // Normal map is used only by lighting
+    if (material->getNormalMapTexture() && (frame_features &
+        FEATURE_LIGHTING))
+        features |= FEATURE_NORMALMAP_TEXTURE;
+
+    return features;
+}
+
+void Object3DRenderer::setBasicShaderUniforms(ShaderProgramPtr shader_program,
+    GLuint features)
+{
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "clip_plane", clip_plane_);
+
+    if (features & (FEATURE_DIFFUSE_TEXTURE | FEATURE_NORMALMAP_TEXTURE))
         master_manager_->shaderManager()->setUniform(shader_program,
-            "fog.density", fog_->getDensity());
-    }
+            "texture_lod_bias", texture_lod_bias_);
+
+    if (features & FEATURE_FOG)
+        setFogUniforms(shader_program);
+
+    if (features & FEATURE_LIGHTING)
+        setLightsUniforms(shader_program);
+
+    setCameraMatricesUniforms(shader_program);
+    setEnvironmentMapUniforms(shader_program);
+
+    if (features & FEATURE_SHADOWS)
+        setShadowMapUniforms(shader_program);
+}
+
+void Object3DRenderer::setFogUniforms(ShaderProgramPtr shader_program)
+{
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "fog.color", fog_->getColor());
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "fog.density", fog_->getDensity());
 }
 
 void Object3DRenderer::setOutlineUniforms(ShaderProgramPtr shader_program,
@@ -144,61 +404,49 @@ void Object3DRenderer::setOutlineUniforms(ShaderProgramPtr shader_program,
 
 void Object3DRenderer::setLightsUniforms(ShaderProgramPtr shader_program)
 {
-    auto light_manager = master_manager_->lightManager();
-
-    master_manager_->shaderManager()->setUniform(shader_program,
-        "lighting_enabled", light_manager->isLightingEnabled());
+    auto dir_light = master_manager_->lightManager()->renderDirectionalLight();
 
     // Directional
-    if (shadow_map_->isShadowsEnabled() && light_manager->directionalLight()->
-        isEnabled())
-    {
-        master_manager_->shaderManager()->setUniform(shader_program,
-            "matrices.dir_light_pv_matrix", master_manager_->lightManager()->
-            directionalLight()->getProjectionViewMatrix());
-    }
-
     master_manager_->shaderManager()->setUniform(shader_program,
-        "directional_light.enabled", light_manager->directionalLight()->
-        isEnabled() ? 1 : 0);
+        "directional_light.enabled", dir_light->isEnabled() ? 1 : 0);
 
-    if (light_manager->directionalLight()->isEnabled())
+    if (dir_light->isEnabled())
     {
         master_manager_->shaderManager()->setUniform(shader_program,
-            "directional_light.direction", light_manager->directionalLight()->
-            getDirection());
+            "directional_light.direction", dir_light->getDirection());
         master_manager_->shaderManager()->setUniform(shader_program,
-            "directional_light.color", light_manager->directionalLight()->
-            getColor());
+            "directional_light.color", dir_light->getColor());
     }
 
-    // Point lights
-    if (light_manager->getPointLightsCount())
-    {
-        master_manager_->shaderManager()->setUniform(shader_program,
-            "used_point_lights_count", static_cast<GLint>(light_manager->
-                getPointLightsCount()));
+    // Point lights are read from clusters built for current pass
+    constexpr GLint lights_texture_index = 5;
+    constexpr GLint clusters_texture_index = 6;
+    constexpr GLint light_indices_texture_index = 7;
 
-        for (GLuint i = 0; i < light_manager->getPointLightsCount(); i++)
-        {
-            std::string uniform_name = "point_lights[" + std::to_string(i)
-                + "]";
-            auto p_light = light_manager->getPointLight(i);
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "clusters.grid_size", clustered_lighting_->getGridSize());
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "clusters.screen_size", clustered_lighting_->getScreenSize());
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "clusters.near_plane", clustered_lighting_->getNearPlane());
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "clusters.depth_scale", clustered_lighting_->getDepthScale());
 
-            master_manager_->shaderManager()->setUniform(shader_program,
-                uniform_name + ".enabled", p_light->isEnabled());
-            master_manager_->shaderManager()->setUniform(shader_program,
-                uniform_name + ".linear_factor", p_light->
-                getLinearAttenuationFactor());
-            master_manager_->shaderManager()->setUniform(shader_program,
-                uniform_name + ".quadratic_factor", p_light->
-                getQuadraticAttenuationFactor());
-            master_manager_->shaderManager()->setUniform(shader_program,
-                uniform_name + ".position", p_light->getPosition());
-            master_manager_->shaderManager()->setUniform(shader_program,
-                uniform_name + ".color", p_light->getColor());
-        }
-    }
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "point_lights_data", lights_texture_index);
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "clusters_data", clusters_texture_index);
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "light_indices", light_indices_texture_index);
+
+    master_manager_->textureManager()->setTextureSlot(lights_texture_index);
+    state_machine_->bindTexture(clustered_lighting_->getLightsTexture());
+    master_manager_->textureManager()->setTextureSlot(clusters_texture_index);
+    state_machine_->bindTexture(clustered_lighting_->getClustersTexture());
+    master_manager_->textureManager()->setTextureSlot(
+        light_indices_texture_index);
+    state_machine_->bindTexture(clustered_lighting_->
+        getLightIndicesTexture());
 }
 
 void Object3DRenderer::prepareRendering()
@@ -225,21 +473,31 @@ void Object3DRenderer::setEnvironmentMapUniforms(
 }
 
 void Object3DRenderer::setMaterials(Object3DPtr object3d, GLuint entity_index,
-    ShaderProgramPtr shader_program)
+    ShaderProgramPtr shader_program, GLuint features)
 {
     auto material = object3d->getEntity(entity_index)->getMaterial();
     if (!material)
         return;
 
+    // Uniforms of disabled features are not compiled into variant
+    GLboolean lighting = (features & FEATURE_LIGHTING) != 0;
+    GLboolean diffuse_texture = (features & FEATURE_DIFFUSE_TEXTURE) != 0;
+
     // Setup material parameters
-    master_manager_->shaderManager()->setUniform(shader_program,
-        "object_material.ka", material->getKa());
-    master_manager_->shaderManager()->setUniform(shader_program,
-        "object_material.kd", material->getKd());
-    master_manager_->shaderManager()->setUniform(shader_program,
-        "object_material.ks", material->getKs());
-    master_manager_->shaderManager()->setUniform(shader_program,
-        "object_material.shininess", material->getShininess());
+    if (lighting)
+    {
+        master_manager_->shaderManager()->setUniform(shader_program,
+            "object_material.ka", material->getKa());
+        master_manager_->shaderManager()->setUniform(shader_program,
+            "object_material.ks", material->getKs());
+        master_manager_->shaderManager()->setUniform(shader_program,
+            "object_material.shininess", material->getShininess());
+    }
+
+    if (lighting || !diffuse_texture)
+        master_manager_->shaderManager()->setUniform(shader_program,
+            "object_material.kd", material->getKd());
+
     master_manager_->shaderManager()->setUniform(shader_program,
         "object_material.reflectivity", material->getReflectivity());
 
@@ -250,66 +508,49 @@ void Object3DRenderer::setMaterials(Object3DPtr object3d, GLuint entity_index,
     constexpr GLint shadow_map_point_texture_index = 4;
 
     // Diffuse texture
-    master_manager_->textureManager()->setTextureSlot(diffuse_texture_index);
-    master_manager_->shaderManager()->setUniform(shader_program,
-        "object_material.has_diffuse_texture", material->getDiffuseTexture() ?
-        1 : 0);
-
-    if (material->getDiffuseTexture())
+    if (diffuse_texture)
     {
+        master_manager_->textureManager()->setTextureSlot(
+            diffuse_texture_index);
         master_manager_->shaderManager()->setUniform(shader_program,
             "object_material.diffuse_texture", diffuse_texture_index);
         state_machine_->bindTexture(material->getDiffuseTexture());
     }
-    else
-        state_machine_->unbindTexture(TextureType::TEXTURE_2D);
 
     // Normal map texture
-    master_manager_->textureManager()->setTextureSlot(normalmap_texture_index);
-    master_manager_->shaderManager()->setUniform(shader_program,
-        "object_material.has_normalmap_texture",
-        material->getNormalMapTexture() ? 1 : 0);
-
-    if (material->getNormalMapTexture())
+    if (features & FEATURE_NORMALMAP_TEXTURE)
     {
+        master_manager_->textureManager()->setTextureSlot(
+            normalmap_texture_index);
         master_manager_->shaderManager()->setUniform(shader_program,
             "object_material.normalmap_texture", normalmap_texture_index);
         state_machine_->bindTexture(material->getNormalMapTexture());
     }
-    else
-        state_machine_->unbindTexture(TextureType::TEXTURE_2D);
+
+    if (!(features & FEATURE_SHADOWS))
+        return;
 
     // Shadow map directional light
     master_manager_->textureManager()->setTextureSlot(shadow_map_texture_index);
     master_manager_->shaderManager()->setUniform(shader_program,
         "shadow_map_texture", shadow_map_texture_index);
 
-    if (master_manager_->lightManager()->isLightingEnabled() &&
-        master_manager_->lightManager()->directionalLight()->isEnabled() &&
-        shadow_map_->isShadowsEnabled() && !polygon_mode_->isEnabled())
+    if (master_manager_->lightManager()->renderDirectionalLight()->
+        isEnabled() && !polygon_mode_->isEnabled())
         state_machine_->bindTexture(shadow_map_texture_);
     else
-        state_machine_->unbindTexture(TextureType::TEXTURE_2D);
-
-    // Shadow map point light
-    for (GLuint i = 0; i < master_manager_->lightManager()->
-        getPointLightsCount(); i++)
-    {
-        auto pl = master_manager_->lightManager()->getPointLight(i);
+        state_machine_->unbindTexture(TextureType::TEXTURE_2D_ARRAY);
 
-        master_manager_->textureManager()->setTextureSlot(
-            shadow_map_point_texture_index + i);
-        master_manager_->shaderManager()->setUniform(shader_program,
-            "point_shadow_map_" + std::to_string(i + 1),
-            static_cast<GLint>(shadow_map_point_texture_index + i));
+    // Shadow atlas of point lights
+    master_manager_->textureManager()->setTextureSlot(
+        shadow_map_point_texture_index);
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "point_shadow_atlas", shadow_map_point_texture_index);
 
-        if (master_manager_->lightManager()->isLightingEnabled() &&
-            shadow_map_->isShadowsEnabled() && !polygon_mode_->isEnabled() &&
-            pl->isEnabled())
-            state_machine_->bindTexture(point_light_shadow_maps_[i]);
-        else
-            state_machine_->unbindTexture(TextureType::TEXTURE_CUBE);
-    }
+    if (!polygon_mode_->isEnabled() && point_shadow_atlas_texture_)
+        state_machine_->bindTexture(point_shadow_atlas_texture_);
+    else
+        state_machine_->unbindTexture(TextureType::TEXTURE_2D);
 }
 
 void Object3DRenderer::setShadowMapUniforms(ShaderProgramPtr shader_program)
@@ -319,90 +560,78 @@ void Object3DRenderer::setShadowMapUniforms(ShaderProgramPtr shader_program)
     master_manager_->shaderManager()->setUniform(shader_program,
         "shadow.transition_distance", shadow_map_->
         getShadowTransitionDistance());
-    master_manager_->shaderManager()->setUniform(shader_program,
-        "shadow.enabled", shadow_map_->isShadowsEnabled());
-    master_manager_->shaderManager()->setUniform(shader_program,
-        "shadow.map_size", shadow_map_->getShadowMapSizeDirectionalLight());
     master_manager_->shaderManager()->setUniform(shader_program,
         "shadow.pcf_filter_count", shadow_map_->getPcfSamplesCount());
-}
-
-void Object3DRenderer::renderObject3D(Object3DPtr object3d)
-{
-    if (!object3d)
-        return;
 
-    prepareRendering();
-    state_machine_->bindMesh(object3d);
-
-    // Check object's modifiers    
-    OutlinePtr outline = std::static_pointer_cast<Outline>
-        (object3d->getModifier(Object3DModifierType::OUTLINE));
-
-    GLboolean render_outline = false;
-    if (outline != nullptr && outline->isEnabled())
-        render_outline = true;
+    // Cascades of directional light
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "shadow.cascades_count", static_cast<GLint>(
+        shadow_cascade_matrices_.size()));
 
-    GLboolean polygon_mode = polygon_mode_->isEnabled();
+    if (shadow_map_texture_)
+        master_manager_->shaderManager()->setUniform(shader_program,
+            "shadow.map_size", shadow_map_texture_->getWidth());
 
-    if (full_render_ && render_outline && !polygon_mode)
-    {
-        stencil_buffer_->enableDrawing(true);
-        stencil_buffer_->setAction(StencilBufferAction::REPLACE);
-        stencil_buffer_->passesAlways(1);
-    }
+    // Point lights atlas. Tiles are stored with lights data.
+    if (point_shadow_atlas_texture_)
+        master_manager_->shaderManager()->setUniform(shader_program,
+            "shadow.point_atlas_size", point_shadow_atlas_texture_->
+            getWidth());
 
-    if (polygon_mode && !polygon_mode_->isUsingPipeline())
+    for (GLuint i = 0; i < shadow_cascade_matrices_.size(); i++)
     {
-        state_machine_->activateShaderProgram(polygon_mode_shader_);
+        std::string index = "[" + std::to_string(i) + "]";
 
-        setCameraMatricesUniforms(polygon_mode_shader_, object3d);
-        setPolygonModeUniforms(polygon_mode_shader_);
-
-        renderObject3DEntities(object3d, polygon_mode_shader_, false);
+        master_manager_->shaderManager()->setUniform(shader_program,
+            "shadow.cascade_matrices" + index, shadow_cascade_matrices_[i]);
+        master_manager_->shaderManager()->setUniform(shader_program,
+            "shadow.cascade_distances" + index, shadow_cascade_distances_[i]);
+        master_manager_->shaderManager()->setUniform(shader_program,
+            "shadow.cascade_scales" + index, shadow_cascade_scales_[i]);
     }
-    else
-    {
-        state_machine_->activateShaderProgram(basic_shader_);
-        master_manager_->shaderManager()->setUniform(basic_shader_,
-            "clip_plane", clip_plane_);
-
-        setFogUniforms(basic_shader_);
-        setLightsUniforms(basic_shader_);
-        setCameraMatricesUniforms(basic_shader_, object3d);
-        setEnvironmentMapUniforms(basic_shader_);
+}
 
-        if (shadow_map_->isShadowsEnabled())
-            setShadowMapUniforms(basic_shader_);
+void Object3DRenderer::renderPolygonMode(Object3DPtr object3d)
+{
+    if (!object3d)
+        return;
 
-        renderObject3DEntities(object3d, basic_shader_, true);
-    }
+    prepareRendering();
+    state_machine_->bindMesh(object3d);
+    state_machine_->activateShaderProgram(polygon_mode_shader_);
 
-    // Second draw for outlining
-    if (full_render_ && render_outline && !polygon_mode)
-    {
-        stencil_buffer_->passesNotEqual(1);
-        stencil_buffer_->enableDrawing(false);
+    setCameraMatricesUniforms(polygon_mode_shader_);
+    master_manager_->shaderManager()->setUniform(polygon_mode_shader_,
+        "matrices.model_matrix", object3d->getRenderModelMatrix());
+    setPolygonModeUniforms(polygon_mode_shader_);
 
-        // Disable depth testing if outline should be always visible
-        if (outline->isAlwaysVisible())
-            state_machine_->depthTest()->enable(false);
+    renderObject3DEntities(object3d);
+}
 
-        // Scale object's outline
-        auto prev_scale = object3d->getScale();
-        object3d->setScale(prev_scale * outline->getScale());
+void Object3DRenderer::renderOutline(Object3DPtr object3d,
+    GLboolean activate_shader)
+{
+    OutlinePtr outline = std::static_pointer_cast<Outline>
+        (object3d->getModifier(Object3DModifierType::OUTLINE));
 
+    if (activate_shader)
+    {
         state_machine_->activateShaderProgram(outline_shader_);
-        setCameraMatricesUniforms(outline_shader_, object3d);
-        setOutlineUniforms(outline_shader_, outline);
+        setCameraMatricesUniforms(outline_shader_);
+    }
 
-        renderObject3DEntities(object3d, outline_shader_, false);
+    // Disable depth testing if outline should be always visible
+    state_machine_->depthTest()->enable(!outline->isAlwaysVisible());
+    setOutlineUniforms(outline_shader_, outline);
 
-        object3d->setScale(prev_scale);
+    // Scale object's outline. Object itself is not modified, because it
+    // can be simulated during rendering.
+    master_manager_->shaderManager()->setUniform(outline_shader_,
+        "matrices.model_matrix", object3d->getRenderModelMatrix() *
+        glm::scale(glm::mat4(1.0f), glm::vec3(outline->getScale())));
 
-        stencil_buffer_->enableDrawing(true);
-        stencil_buffer_->setAction(StencilBufferAction::KEEP);
-    }
+    state_machine_->bindMesh(object3d);
+    renderObject3DEntities(object3d);
 }
 
 void Object3DRenderer::render(ScenePtr scene, ShaderProgramPtr shader_program)
@@ -410,19 +639,33 @@ void Object3DRenderer::render(ScenePtr scene, ShaderProgramPtr shader_program)
     if (!scene || !shader_program)
         return;
 
-    auto objects_3d = scene->getObject3DContainer();
-    if (objects_3d.empty())
+    render(scene->getObject3DContainer(), shader_program);
+}
+
+void Object3DRenderer::render(const std::vector<Object3DPtr> &objects,
+    ShaderProgramPtr shader_program)
+{
+    if (objects.empty() || !shader_program)
         return;
 
     prepareRendering();
 
-    for (const auto &object : objects_3d)
-    {
-        state_machine_->bindMesh(object);
-        master_manager_->shaderManager()->setUniform(shader_program,
-            "matrices.model_matrix", object->getModelMatrix());
+    for (const auto &object : objects)
+        renderDepth(object, shader_program);
+}
 
-        for (GLuint i = 0; i < object->getEntitiesCount(); i++)
+void Object3DRenderer::renderDepth(Object3DPtr object,
+    ShaderProgramPtr shader_program, GLint instances_count)
+{
+    state_machine_->bindMesh(object);
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "matrices.model_matrix", object->getRenderModelMatrix());
+
+    for (GLuint i = 0; i < object->getEntitiesCount(); i++)
+    {
+        if (instances_count > 1)
+            object->drawInstanced(i, instances_count);
+        else
             object->draw(i);
     }
 }
\ No newline at end of file
@@ -8,8 +8,9 @@
 using namespace puffin;
 
 ParticleRenderer::ParticleRenderer(MasterManagerPtr master_manager,
-    StateMachinePtr state_machine, DisplayConfigurationPtr display_configuration,
-    FpsCounterPtr fps_counter) : BaseRenderer("core_particle_renderer")
+    StateMachinePtr state_machine,
+    DisplayConfigurationPtr display_configuration) :
+    BaseRenderer("core_particle_renderer")
 {
     if (!master_manager)
         logErrorAndThrow(name_, "ParticleRenderer::ParticleRenderer()",
@@ -23,14 +24,9 @@ ParticleRenderer::ParticleRenderer(MasterManagerPtr master_manager,
         logErrorAndThrow(name_, "ParticleRenderer::ParticleRenderer()",
             "Object [DisplayConfiguration] pointer not set.");
 
-    if (!fps_counter)
-        logErrorAndThrow(name_, "ParticleRenderer::ParticleRenderer()",
-            "Object [FpsCounter] pointer not set.");
-
     master_manager_ = master_manager;
     state_machine_ = state_machine;
     display_configuration_ = display_configuration;
-    fps_counter_ = fps_counter;
 
     loadShaderProgram();
     createParticleModel();
@@ -48,7 +44,7 @@ ParticleRenderer::~ParticleRenderer()
 void ParticleRenderer::loadShaderProgram()
 {
     shader_program_ = master_manager_->shaderManager()->
-        createShaderProgram("particle_shader_program",
+        createShaderProgramAsync("particle_shader_program",
             "shaders/ParticleVs.glsl", "shaders/ParticleFs.glsl");
 }
 
@@ -166,8 +162,16 @@ void ParticleRenderer::render(ScenePtr scene)
 
             particle_model_->draw();
         }
+    }
+}
 
-        particle_system->updateParticles(fps_counter_->getDelta(),
+void ParticleRenderer::update(ScenePtr scene, GLdouble delta)
+{
+    // Particles are sorted by distance from camera
+    if (!active_camera_)
+        return;
+
+    for (const auto &particle_system : scene->getParticleSystemContainer())
+        particle_system->updateParticles(static_cast<GLfloat>(delta),
             active_camera_);
-    }
 }
\ No newline at end of file
@@ -48,21 +48,213 @@ PostprocessRenderer::~PostprocessRenderer()
 
 void PostprocessRenderer::loadShaders()
 {
-    shader_program_ = master_manager_->shaderManager()->
-        createShaderProgram("postprocess_shader", "shaders/PostprocessVs.glsl",
-            "shaders/PostprocessFs.glsl");
+    auto shader_manager = master_manager_->shaderManager();
+
+    copy_shader_ = shader_manager->createShaderProgramAsync(
+        "postprocess_copy_shader", "shaders/PostprocessVs.glsl",
+        "shaders/PostprocessCopyFs.glsl");
+    fxaa_shader_ = shader_manager->createShaderProgramAsync(
+        "postprocess_fxaa_shader", "shaders/PostprocessVs.glsl",
+        "shaders/PostprocessFxaaFs.glsl");
+    blur_shader_ = shader_manager->createShaderProgramAsync(
+        "postprocess_blur_shader", "shaders/PostprocessVs.glsl",
+        "shaders/PostprocessBlurFs.glsl");
+    auto convolution_shader = shader_manager->createShaderProgramAsync(
+        "postprocess_convolution_shader", "shaders/PostprocessVs.glsl",
+        "shaders/PostprocessConvolutionFs.glsl");
+
+    effect_shaders_[PostprocessEffect::NEGATIVE] = shader_manager->
+        createShaderProgramAsync("postprocess_negative_shader",
+            "shaders/PostprocessVs.glsl", "shaders/PostprocessNegativeFs.glsl");
+    effect_shaders_[PostprocessEffect::GRAYSCALE] = shader_manager->
+        createShaderProgramAsync("postprocess_grayscale_shader",
+            "shaders/PostprocessVs.glsl",
+            "shaders/PostprocessGrayscaleFs.glsl");
+    effect_shaders_[PostprocessEffect::TINT] = shader_manager->
+        createShaderProgramAsync("postprocess_tint_shader",
+            "shaders/PostprocessVs.glsl", "shaders/PostprocessTintFs.glsl");
+    effect_shaders_[PostprocessEffect::SHARPEN] = convolution_shader;
+    effect_shaders_[PostprocessEffect::EDGE] = convolution_shader;
+    effect_shaders_[PostprocessEffect::BLUR] = blur_shader_;
+}
+
+void PostprocessRenderer::setEffectUniforms(ShaderProgramPtr shader_program,
+    PostprocessEffect effect)
+{
+    auto shader_manager = master_manager_->shaderManager();
+
+    switch (effect)
+    {
+    case PostprocessEffect::SHARPEN:
+    case PostprocessEffect::EDGE:
+    {
+        GLfloat center = effect == PostprocessEffect::SHARPEN ? 9.0f : -8.0f;
+        GLfloat side = effect == PostprocessEffect::SHARPEN ? -1.0f : 1.0f;
+
+        for (GLint i = 0; i < 9; i++)
+        {
+            shader_manager->setUniform(shader_program,
+                "kernel[" + std::to_string(i) + "]", i == 4 ? center : side);
+        }
+
+        shader_manager->setUniform(shader_program, "kernel_size",
+            kernel_size_);
+        break;
+    }
+    case PostprocessEffect::BLUR:
+        shader_manager->setUniform(shader_program, "kernel_size",
+            kernel_size_);
+        break;
+    case PostprocessEffect::TINT:
+        shader_manager->setUniform(shader_program, "tint_color", tint_color_);
+        break;
+    default:
+        break;
+    }
 }
 
-void PostprocessRenderer::setShaderUniforms()
+void PostprocessRenderer::render(Object3DPtr screen)
 {
-    master_manager_->shaderManager()->setUniform(shader_program_,
-        "color.screen_texture", static_cast<GLint>(0));
-    master_manager_->shaderManager()->setUniform(shader_program_,
-        "color.kernel_size", kernel_size_);
-    master_manager_->shaderManager()->setUniform(shader_program_,
-        "color.effect", static_cast<GLint>(effect_));
-    master_manager_->shaderManager()->setUniform(shader_program_,
-        "color.tint_color", tint_color_);
+    state_machine_->bindMesh(screen);
+
+    PostprocessImage input{getFrameBufferToRender(), false};
+    const PostprocessImage window{nullptr, false};
+
+    // Antialiasing is applied to scene before any other effect
+    if (display_configuration_->getAntialiasingMode() ==
+        AntialiasingMode::FXAA)
+    {
+        auto output = effects_.empty() ? window : acquireTarget(false, input);
+        master_manager_->shaderManager()->setUniform(fxaa_shader_,
+            "texel_size", glm::vec2(1.0f / display_configuration_->getWidth(),
+            1.0f / display_configuration_->getHeight()));
+        renderPass(fxaa_shader_, input, output, screen);
+        input = output;
+    }
+
+    for (std::size_t i = 0; i < effects_.size(); i++)
+    {
+        const auto &pass = effects_[i];
+        auto shader_program = effect_shaders_[pass.effect];
+        setEffectUniforms(shader_program, pass.effect);
+
+        // Separable blur runs as horizontal pass followed by vertical one
+        if (pass.effect == PostprocessEffect::BLUR)
+        {
+            auto horizontal = acquireTarget(pass.half_resolution, input);
+            master_manager_->shaderManager()->setUniform(shader_program,
+                "direction", glm::vec2(1.0f, 0.0f));
+            renderPass(shader_program, input, horizontal, screen);
+            input = horizontal;
+
+            master_manager_->shaderManager()->setUniform(shader_program,
+                "direction", glm::vec2(0.0f, 1.0f));
+        }
+
+        // Last full resolution pass writes directly to the window
+        GLboolean to_window = i + 1 == effects_.size() &&
+            !pass.half_resolution;
+        auto output = to_window ? window : acquireTarget(
+            pass.half_resolution, input);
+
+        renderPass(shader_program, input, output, screen);
+        input = output;
+    }
+
+    // Copy unchanged scene or upscale result of half resolution pass
+    if (input.frame_buffer)
+        renderPass(copy_shader_, input, window, screen);
+}
+
+void PostprocessRenderer::renderPass(ShaderProgramPtr shader_program,
+    const PostprocessImage &input, const PostprocessImage &output,
+    Object3DPtr screen)
+{
+    if (output.frame_buffer)
+        state_machine_->bindFrameBuffer(output.frame_buffer);
+    else
+        state_machine_->unbindFrameBuffer();
+
+    auto output_size = getImageSize(output);
+    state_machine_->setViewport(0, 0, output_size.x, output_size.y);
+
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "screen_texture", static_cast<GLint>(0));
+    master_manager_->shaderManager()->setUniform(shader_program, "uv_scale",
+        getImageUvScale(input));
+    // Taps stop at centre of last used texel, so filtering does not reach
+    // cleared part of texture when resolution scale is below 1
+    master_manager_->shaderManager()->setUniform(shader_program, "uv_max",
+        getImageUvScale(input) - glm::vec2(0.5f) /
+        glm::vec2(getImageTextureSize(input)));
+
+    master_manager_->textureManager()->setTextureSlot(0);
+    state_machine_->bindTexture(input.frame_buffer->getRgbTextureBuffer());
+
+    screen->draw();
+}
+
+PostprocessRenderer::PostprocessImage PostprocessRenderer::acquireTarget(
+    GLboolean half_resolution, const PostprocessImage &input)
+{
+    for (const auto &target : targets_pool_)
+    {
+        if (target.half_resolution == half_resolution &&
+            target.frame_buffer != input.frame_buffer)
+            return target;
+    }
+
+    auto width = display_configuration_->getWidth();
+    auto height = display_configuration_->getHeight();
+    if (half_resolution)
+    {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+
+    PostprocessImage target{frame_buffer_manager_->createFrameBuffer(
+        "postprocess_frame_buffer_" + std::to_string(targets_pool_.size())),
+        half_resolution};
+    frame_buffer_manager_->addTextureBuffer(target.frame_buffer,
+        TextureBufferType::RGB_BUFFER, width, height, false);
+    master_manager_->textureManager()->setTextureWrap(target.frame_buffer->
+        getRgbTextureBuffer(), TextureWrap::CLAMP_TO_EDGE);
+
+    targets_pool_.push_back(target);
+    return target;
+}
+
+glm::ivec2 PostprocessRenderer::getImageSize(
+    const PostprocessImage &image) const
+{
+    if (!image.frame_buffer)
+        return glm::ivec2(display_configuration_->getWidth(),
+            display_configuration_->getHeight());
+
+    glm::ivec2 size(getRenderWidth(), getRenderHeight());
+    if (image.half_resolution)
+        size = glm::ivec2(std::max(1, size.x / 2), std::max(1, size.y / 2));
+
+    return size;
+}
+
+glm::ivec2 PostprocessRenderer::getImageTextureSize(
+    const PostprocessImage &image) const
+{
+    glm::ivec2 texture_size(display_configuration_->getWidth(),
+        display_configuration_->getHeight());
+    if (image.half_resolution)
+        texture_size = glm::ivec2(std::max(1, texture_size.x / 2),
+            std::max(1, texture_size.y / 2));
+
+    return texture_size;
+}
+
+glm::vec2 PostprocessRenderer::getImageUvScale(
+    const PostprocessImage &image) const
+{
+    return glm::vec2(getImageSize(image)) /
+        glm::vec2(getImageTextureSize(image));
 }
 
 void PostprocessRenderer::createFrameBuffers()
@@ -72,26 +264,45 @@ void PostprocessRenderer::createFrameBuffers()
 
     frame_buffer_multisample_ = frame_buffer_manager_->
         createFrameBuffer("postprocess_frame_buffer_multisample");
+    auto multisampled = display_configuration_->isMultisamplingEnabled();
     frame_buffer_manager_->addTextureBuffer(frame_buffer_multisample_,
-        TextureBufferType::RGB_BUFFER, v_width, v_height, true);
+        TextureBufferType::RGB_BUFFER, v_width, v_height, multisampled);
     frame_buffer_manager_->addRenderBuffer(frame_buffer_multisample_,
-        RenderBufferType::DEPTH_STENCIL_BUFFER, v_width, v_height, true);
+        RenderBufferType::DEPTH_STENCIL_BUFFER, v_width, v_height,
+        multisampled);
+
+    // Single sampled scene is read directly by postprocess passes, so
+    // taps outside of screen must not wrap around
+    if (!multisampled)
+    {
+        master_manager_->textureManager()->setTextureWrap(
+            frame_buffer_multisample_->getRgbTextureBuffer(),
+            TextureWrap::CLAMP_TO_EDGE);
+        return;
+    }
 
+    // Needed only to resolve multisampled scene
     frame_buffer_simple_ = frame_buffer_manager_->
         createFrameBuffer("postprocess_frame_buffer_simple");
     frame_buffer_manager_->addTextureBuffer(frame_buffer_simple_,
         TextureBufferType::RGB_BUFFER, v_width, v_height, false);
+    master_manager_->textureManager()->setTextureWrap(frame_buffer_simple_->
+        getRgbTextureBuffer(), TextureWrap::CLAMP_TO_EDGE);
 }
 
 FrameBufferPtr PostprocessRenderer::getFrameBufferToRender() const
 {
+    // Single sampled scene does not need resolving
+    if (!display_configuration_->isMultisamplingEnabled())
+        return frame_buffer_multisample_;
+
     state_machine_->bindFrameBuffer(frame_buffer_multisample_,
         FrameBufferBindType::ONLY_READ);
     state_machine_->bindFrameBuffer(frame_buffer_simple_,
         FrameBufferBindType::ONLY_WRITE);
 
-    auto v_width = display_configuration_->getWidth();
-    auto v_height = display_configuration_->getHeight();
+    auto v_width = getRenderWidth();
+    auto v_height = getRenderHeight();
 
     glBlitFramebuffer(0, 0, v_width, v_height, 0, 0, v_width, v_height,
         GL_COLOR_BUFFER_BIT, GL_LINEAR);
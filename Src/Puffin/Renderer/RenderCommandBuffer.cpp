@@ -0,0 +1,49 @@
+//------------------------------------------------------------------------------
+// Puffin OpenGL Engine
+// Version: 0.3.1
+// Author: Sebastian 'qbranchmaster' Tabaka
+//------------------------------------------------------------------------------
+#include "Puffin/Renderer/RenderCommandBuffer.h"
+
+using namespace puffin;
+
+void RenderCommandBuffer::sort()
+{
+    if (commands_.size() < 2)
+        return;
+
+    // Radix sort by bytes of key, starting from the least significant one.
+    // It is stable, so commands with equal keys keep order of adding.
+    constexpr GLuint radix_bits = 8;
+    constexpr GLuint buckets_count = 1 << radix_bits;
+
+    sorted_commands_.resize(commands_.size());
+
+    for (GLuint shift = 0; shift < 64; shift += radix_bits)
+    {
+        std::array<GLuint, buckets_count> offsets{};
+        for (const auto &command : commands_)
+            offsets[(command.key >> shift) & (buckets_count - 1)]++;
+
+        // Byte shared by all keys does not change order
+        if (offsets[(commands_.front().key >> shift) &
+            (buckets_count - 1)] == commands_.size())
+            continue;
+
+        GLuint offset = 0;
+        for (auto &bucket_offset : offsets)
+        {
+            GLuint count = bucket_offset;
+            bucket_offset = offset;
+            offset += count;
+        }
+
+        for (const auto &command : commands_)
+        {
+            sorted_commands_[offsets[(command.key >> shift) &
+                (buckets_count - 1)]++] = command;
+        }
+
+        commands_.swap(sorted_commands_);
+    }
+}
\ No newline at end of file
@@ -35,6 +35,8 @@ ShadowMapRenderer::ShadowMapRenderer(MasterManagerPtr master_manager,
 
     loadShaders();
 
+    point_lights_timer_.reset(new GpuTimer("core_point_shadows_timer"));
+
     pl_projection_matrix_ = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f,
         shadow_map_configuration_->getShadowDistance());
 
@@ -51,20 +53,37 @@ ShadowMapRenderer::~ShadowMapRenderer()
 void ShadowMapRenderer::loadShaders()
 {
     depth_map_directional_shader_ = master_manager_->shaderManager()->
-        createShaderProgram("depth_map_directional_shader",
+        createShaderProgramAsync("depth_map_directional_shader",
             "shaders/DepthMapDirectionalVs.glsl",
             "shaders/DepthMapDirectionalFs.glsl");
 
-    depth_map_point_shader_ = master_manager_->shaderManager()->
-        createShaderProgram("depth_map_point_shader",
-            "shaders/DepthMapPointVs.glsl",
-            "shaders/DepthMapPointFs.glsl",
-            "shaders/DepthMapPointGs.glsl");
+    depth_map_point_face_shader_ = master_manager_->shaderManager()->
+        createShaderProgramAsync("depth_map_point_face_shader",
+            "shaders/DepthMapPointFaceVs.glsl",
+            "shaders/DepthMapPointFs.glsl");
+
+    // Shaders selecting viewport do not compile without extensions
+    if (isViewportArraySupported())
+    {
+        depth_map_point_shader_ = master_manager_->shaderManager()->
+            createShaderProgramAsync("depth_map_point_shader",
+                "shaders/DepthMapPointVs.glsl",
+                "shaders/DepthMapPointFs.glsl",
+                "shaders/DepthMapPointGs.glsl");
+    }
+
+    if (isVertexViewportSupported())
+    {
+        depth_map_point_viewport_shader_ = master_manager_->shaderManager()->
+            createShaderProgramAsync("depth_map_point_viewport_shader",
+                "shaders/DepthMapPointViewportVs.glsl",
+                "shaders/DepthMapPointFs.glsl");
+    }
 }
 
-void ShadowMapRenderer::renderDirectionalLight(ScenePtr scene)
+void ShadowMapRenderer::renderDirectionalLight()
 {
-    auto dir_light = master_manager_->lightManager()->directionalLight();
+    auto dir_light = master_manager_->lightManager()->renderDirectionalLight();
 
     if (!dir_light->isEnabled())
         return;
@@ -72,72 +91,279 @@ void ShadowMapRenderer::renderDirectionalLight(ScenePtr scene)
     if (!dir_light_frame_buffer_)
         createFrameBufferDirectionalLight();
 
-    // TODO: Check that code
-    active_camera_->cameraBox()->update(shadow_map_configuration_->
-        getShadowDistance());
-    dir_light->calculateViewMatrix(active_camera_->cameraBox()->getCenter());
-    active_camera_->cameraBox()->recalculateSpace(dir_light->getViewMatrix());
+    calculateCascadeSplits();
+
+    auto depth_array = dir_light_frame_buffer_->getDepthArrayTextureBuffer();
+    auto static_objects = getCasterObjects(static_casters_);
+    auto dynamic_objects = getCasterObjects(dynamic_casters_);
 
-    glm::vec3 projection_vector(active_camera_->cameraBox()->getWidth(),
-        active_camera_->cameraBox()->getHeight(),
-        active_camera_->cameraBox()->getLength());
+    cascade_cache_.resize(shadow_map_configuration_->getMaxCascadesCount());
 
-    dir_light->calculateProjectionMatrix(projection_vector);
-    dir_light->calculateViewMatrix(active_camera_->getPosition());
-    //---
+    object3d_renderer_->shadow_cascade_matrices_.clear();
+    object3d_renderer_->shadow_cascade_distances_.clear();
+    object3d_renderer_->shadow_cascade_scales_.clear();
 
     state_machine_->activateShaderProgram(depth_map_directional_shader_);
-    master_manager_->shaderManager()->setUniform(depth_map_directional_shader_,
-        "matrices.light_space_matrix", dir_light->getProjectionViewMatrix());
+
+    GLfloat distance_near = active_camera_->getNearPlane();
+    for (GLint i = 0; i < shadow_map_configuration_->getCascadesCount(); i++)
+    {
+        // Cascades smaller than texture array use only part of its layer
+        GLint map_size = std::min(shadow_map_configuration_->
+            getCascadeMapSize(i), depth_array->getWidth());
+
+        CascadeCache &cache = cascade_cache_[i];
+        GLboolean cascade_moved = updateCascadeRegion(cache,
+            dir_light->getDirection(), distance_near, cascade_distances_[i],
+            map_size);
+        glm::mat4 cascade_matrix = cache.matrix;
+
+        object3d_renderer_->shadow_cascade_matrices_.push_back(cascade_matrix);
+        object3d_renderer_->shadow_cascade_distances_.push_back(
+            cascade_distances_[i]);
+        object3d_renderer_->shadow_cascade_scales_.push_back(
+            static_cast<GLfloat>(map_size) / depth_array->getWidth());
+
+        distance_near = cascade_distances_[i];
+
+        if (!cascade_moved && !static_casters_changed_ &&
+            !dynamic_casters_changed_)
+            continue;
+
+        master_manager_->shaderManager()->setUniform(
+            depth_map_directional_shader_, "matrices.light_space_matrix",
+            cascade_matrix);
+
+        // Static casters are drawn into cache layer only when they or
+        // cascade change. Otherwise the cache is copied.
+        if (!static_objects.empty() && (cascade_moved ||
+            static_casters_changed_))
+        {
+            master_manager_->frameBufferManager()->setDepthArrayBufferLayer(
+                dir_light_cache_frame_buffer_, i);
+
+            state_machine_->setViewport(0, 0, map_size, map_size);
+            glClear(GL_DEPTH_BUFFER_BIT);
+
+            object3d_renderer_->render(static_objects,
+                depth_map_directional_shader_);
+        }
+
+        if (static_objects.empty())
+        {
+            master_manager_->frameBufferManager()->setDepthArrayBufferLayer(
+                dir_light_frame_buffer_, i);
+            glClear(GL_DEPTH_BUFFER_BIT);
+        }
+        else
+            copyCascadeFromCache(i);
+
+        state_machine_->setViewport(0, 0, map_size, map_size);
+        object3d_renderer_->render(dynamic_objects,
+            depth_map_directional_shader_);
+    }
+
+    object3d_renderer_->shadow_map_texture_ = depth_array;
+}
+
+void ShadowMapRenderer::copyCascadeFromCache(GLint cascade_index)
+{
+    master_manager_->frameBufferManager()->setDepthArrayBufferLayer(
+        dir_light_cache_frame_buffer_, cascade_index);
+    master_manager_->frameBufferManager()->setDepthArrayBufferLayer(
+        dir_light_frame_buffer_, cascade_index);
+
+    state_machine_->bindFrameBuffer(dir_light_cache_frame_buffer_,
+        FrameBufferBindType::ONLY_READ);
+    state_machine_->bindFrameBuffer(dir_light_frame_buffer_,
+        FrameBufferBindType::ONLY_WRITE);
+
+    // Whole layer is copied, so area outside of cascade stays cleared
+    GLint layer_size = dir_light_frame_buffer_->getDepthArrayTextureBuffer()->
+        getWidth();
+    glBlitFramebuffer(0, 0, layer_size, layer_size, 0, 0, layer_size,
+        layer_size, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
 
     state_machine_->bindFrameBuffer(dir_light_frame_buffer_);
+}
+
+void ShadowMapRenderer::collectCasters(ScenePtr scene)
+{
+    std::vector<CasterState> static_casters;
+    std::vector<CasterState> dynamic_casters;
+
+    for (const auto &object : scene->getObject3DContainer())
+    {
+        CasterState state;
+        state.object = object;
+        state.model_matrix = object->getRenderModelMatrix();
+        state.center = object->getRenderBoundingSphereCenter();
+        state.radius = object->getRenderBoundingSphereRadius();
+
+        if (object->isStatic())
+            static_casters.push_back(state);
+        else
+            dynamic_casters.push_back(state);
+    }
 
-    auto map_size = shadow_map_configuration_->
-        getShadowMapSizeDirectionalLight();
-    glViewport(0, 0, map_size, map_size);
-    glClear(GL_DEPTH_BUFFER_BIT);
+    static_casters_changed_ = static_casters != static_casters_;
+    dynamic_casters_changed_ = dynamic_casters != dynamic_casters_;
 
-    object3d_renderer_->render(scene, depth_map_directional_shader_);
-    object3d_renderer_->shadow_map_texture_ = dir_light_frame_buffer_->
-        getDepthTextureBuffer();
+    static_casters_ = static_casters;
+    dynamic_casters_ = dynamic_casters;
 }
 
-void ShadowMapRenderer::createFrameBufferDirectionalLight()
+std::vector<Object3DPtr> ShadowMapRenderer::getCasterObjects(
+    const std::vector<CasterState> &casters) const
 {
-    auto map_size = shadow_map_configuration_->
-        getShadowMapSizeDirectionalLight();
+    std::vector<Object3DPtr> objects;
+    for (const auto &caster : casters)
+        objects.push_back(caster.object);
 
-    dir_light_frame_buffer_ = master_manager_->frameBufferManager()->
-        createFrameBuffer("depth_map_dir_light");
-    master_manager_->frameBufferManager()->addTextureBuffer(
-        dir_light_frame_buffer_, TextureBufferType::DEPTH_BUFFER,
-        map_size, map_size, true);
+    return objects;
+}
 
-    master_manager_->frameBufferManager()->disableDrawBuffer(
-        dir_light_frame_buffer_);
-    master_manager_->frameBufferManager()->disableReadBuffer(
-        dir_light_frame_buffer_);
+void ShadowMapRenderer::calculateCascadeSplits()
+{
+    GLint cascades_count = shadow_map_configuration_->getCascadesCount();
+    GLfloat distance_near = active_camera_->getNearPlane();
+    GLfloat distance_far = shadow_map_configuration_->getShadowDistance();
+
+    cascade_distances_.clear();
+
+    auto splits = shadow_map_configuration_->getCascadeSplits();
+    if (!splits.empty())
+    {
+        for (const auto &split : splits)
+            cascade_distances_.push_back(std::max(split * distance_far,
+                distance_near + 0.01f));
+
+        return;
+    }
+
+    // Practical split scheme - mix of logarithmic and uniform splits
+    GLfloat lambda = shadow_map_configuration_->getCascadeSplitLambda();
+    GLfloat ratio = distance_far / distance_near;
+
+    for (GLint i = 1; i <= cascades_count; i++)
+    {
+        GLfloat part = static_cast<GLfloat>(i) / cascades_count;
+        GLfloat log_split = distance_near * std::pow(ratio, part);
+        GLfloat uniform_split = distance_near + (distance_far - distance_near) *
+            part;
+
+        cascade_distances_.push_back(lambda * log_split + (1.0f - lambda) *
+            uniform_split);
+    }
 }
 
-void ShadowMapRenderer::createFrameBufferPointLights()
+GLboolean ShadowMapRenderer::updateCascadeRegion(CascadeCache &cache,
+    const glm::vec3 &light_direction, GLfloat distance_near,
+    GLfloat distance_far, GLint map_size) const
+{
+    auto corners = active_camera_->cameraBox()->calculateSliceCorners(
+        distance_near, distance_far);
+
+    // Bounding sphere of frustum slice does not change with camera rotation,
+    // so shadow map resolution stays constant
+    glm::vec3 center(0.0f, 0.0f, 0.0f);
+    for (const auto &corner : corners)
+        center += corner;
+    center /= static_cast<GLfloat>(corners.size());
+
+    GLfloat radius = 0.0f;
+    for (const auto &corner : corners)
+        radius = std::max(radius, glm::length(corner - center));
+
+    glm::vec3 direction = glm::normalize(light_direction);
+    glm::vec3 up = std::abs(direction.y) > 0.99f ?
+        glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+
+    glm::mat4 view_matrix = glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f),
+        direction, up);
+    glm::vec3 center_LIGHT = glm::vec3(view_matrix * glm::vec4(center, 1.0f));
+
+    // Casters placed between light and cascade have to be included too
+    GLfloat casters_distance = shadow_map_configuration_->getShadowDistance();
+
+    // Region is kept while slice stays inside of it, so static casters
+    // cached for it are valid also when camera moves
+    glm::vec3 offset = glm::abs(center_LIGHT - cache.center);
+    GLfloat max_offset = std::max(offset.x, std::max(offset.y, offset.z));
+    if (cache.valid && cache.map_size == map_size &&
+        cache.direction == direction &&
+        cache.casters_distance == casters_distance &&
+        max_offset + radius <= cache.radius)
+        return false;
+
+    GLfloat region_radius = radius * shadow_map_configuration_->
+        getCascadeCacheMargin();
+    region_radius = std::ceil(region_radius * 16.0f) / 16.0f;
+
+    // Snap cascade center to shadow map texels to avoid shimmering when
+    // region moves
+    GLfloat texel_size = (2.0f * region_radius) / map_size;
+    center_LIGHT.x = std::floor(center_LIGHT.x / texel_size) * texel_size;
+    center_LIGHT.y = std::floor(center_LIGHT.y / texel_size) * texel_size;
+
+    glm::mat4 projection_matrix = glm::ortho(center_LIGHT.x - region_radius,
+        center_LIGHT.x + region_radius, center_LIGHT.y - region_radius,
+        center_LIGHT.y + region_radius,
+        -(center_LIGHT.z + region_radius + casters_distance),
+        -(center_LIGHT.z - region_radius));
+
+    cache.valid = true;
+    cache.map_size = map_size;
+    cache.direction = direction;
+    cache.casters_distance = casters_distance;
+    cache.center = center_LIGHT;
+    cache.radius = region_radius;
+    cache.matrix = projection_matrix * view_matrix;
+
+    return true;
+}
+
+void ShadowMapRenderer::createFrameBufferDirectionalLight()
 {
-    auto map_size = shadow_map_configuration_->getShadowMapSizePointLight();
+    // All cascades share one texture array with size of the biggest cascade
+    GLint map_size = 0;
+    for (GLint i = 0; i < shadow_map_configuration_->getMaxCascadesCount(); i++)
+        map_size = std::max(map_size, shadow_map_configuration_->
+            getCascadeMapSize(i));
 
-    for (int i = 0; i < master_manager_->lightManager()->
-        getMaxPointLightsCount(); i++)
+    dir_light_frame_buffer_ = master_manager_->frameBufferManager()->
+        createFrameBuffer("depth_map_dir_light");
+    dir_light_cache_frame_buffer_ = master_manager_->frameBufferManager()->
+        createFrameBuffer("depth_map_dir_light_cache");
+
+    for (const auto &frame_buffer : {dir_light_frame_buffer_,
+        dir_light_cache_frame_buffer_})
     {
-        FrameBufferPtr frame_buffer = master_manager_->frameBufferManager()->
-            createFrameBuffer("depth_map_point_lights_" + std::to_string(i));
-        master_manager_->frameBufferManager()->addCubeMapDepthBuffer(
-            frame_buffer, map_size);
+        master_manager_->frameBufferManager()->addDepthArrayBuffer(
+            frame_buffer, map_size, shadow_map_configuration_->
+            getMaxCascadesCount());
 
         master_manager_->frameBufferManager()->disableDrawBuffer(frame_buffer);
         master_manager_->frameBufferManager()->disableReadBuffer(frame_buffer);
-
-        point_light_frame_buffer_container_.push_back(frame_buffer);
     }
 }
 
+void ShadowMapRenderer::createFrameBufferPointLights()
+{
+    auto atlas_size = shadow_map_configuration_->getPointLightsAtlasSize();
+
+    point_light_frame_buffer_ = master_manager_->frameBufferManager()->
+        createFrameBuffer("depth_map_point_lights");
+    master_manager_->frameBufferManager()->addTextureBuffer(
+        point_light_frame_buffer_, TextureBufferType::DEPTH_BUFFER,
+        atlas_size, atlas_size, false);
+
+    master_manager_->frameBufferManager()->disableDrawBuffer(
+        point_light_frame_buffer_);
+    master_manager_->frameBufferManager()->disableReadBuffer(
+        point_light_frame_buffer_);
+}
+
 void ShadowMapRenderer::render(ScenePtr scene)
 {
     if (!scene)
@@ -154,28 +380,62 @@ void ShadowMapRenderer::render(ScenePtr scene)
     state_machine_->alphaBlend()->enable(false);
     state_machine_->faceCulling()->enable(true);
 
-    renderDirectionalLight(scene);
-    renderPointLights(scene);
+    collectCasters(scene);
+
+    renderDirectionalLight();
+    renderPointLights();
 }
 
-void ShadowMapRenderer::renderPointLights(ScenePtr scene)
+void ShadowMapRenderer::renderPointLights()
 {
-    if (!point_light_frame_buffer_container_.size())
+    if (!point_light_frame_buffer_)
         createFrameBufferPointLights();
 
-    state_machine_->activateShaderProgram(depth_map_point_shader_);
-    master_manager_->shaderManager()->setUniform(depth_map_point_shader_,
-        "shadow_distance", shadow_map_configuration_->getShadowDistance());
+    resolvePointShadowRenderMode();
 
-    object3d_renderer_->point_light_shadow_maps_.clear();
+    std::vector<CasterState> casters = static_casters_;
+    casters.insert(casters.end(), dynamic_casters_.begin(),
+        dynamic_casters_.end());
 
-    for (GLuint i = 0; i < master_manager_->lightManager()->
-        getPointLightsCount(); i++)
+    auto light_manager = master_manager_->lightManager();
+    auto atlas_texture = point_light_frame_buffer_->getDepthTextureBuffer();
+
+    // Tiles are assigned every frame, so distant and invisible lights do not
+    // waste atlas space
+    Frustum camera_frustum(active_camera_->getProjectionMatrix() *
+        active_camera_->getViewMatrix());
+
+    std::vector<GLint> tile_sizes;
+    for (GLuint i = 0; i < light_manager->getRenderPointLightsCount(); i++)
+    {
+        auto pl = light_manager->getRenderPointLight(i);
+        tile_sizes.push_back(pl->isEnabled() ? calculatePointLightTileSize(
+            pl->getPosition(), camera_frustum) : 0);
+    }
+
+    auto tiles = packPointLightTiles(tile_sizes, atlas_texture->getWidth());
+    point_light_cache_.resize(tiles.size());
+
+    object3d_renderer_->point_shadow_atlas_texture_ = atlas_texture;
+    object3d_renderer_->point_shadow_tiles_.clear();
+
+    point_lights_timer_->begin();
+
+    for (GLuint i = 0; i < light_manager->getRenderPointLightsCount(); i++)
     {
-        auto pl = master_manager_->lightManager()->getPointLight(i);
+        auto pl = light_manager->getRenderPointLight(i);
+        const PointLightTile &tile = tiles[i];
+        PointLightCache &cache = point_light_cache_[i];
 
-        if (!pl->isEnabled())
+        // Tiles are indexed the same way as lights
+        object3d_renderer_->point_shadow_tiles_.push_back(glm::vec3(tile.x,
+            tile.y, tile.size));
+
+        if (tile.size == 0)
+        {
+            cache.valid = false;
             continue;
+        }
 
         std::vector<glm::mat4> shadow_transforms;
         auto light_pos = pl->getPosition();
@@ -199,21 +459,415 @@ void ShadowMapRenderer::renderPointLights(ScenePtr scene)
             glm::lookAt(light_pos, light_pos + glm::vec3(0.0f, 0.0f, -1.0f),
                 glm::vec3(0.0f, -1.0f, 0.0f)));
 
+        // Find faces whose casters changed since last render. Moved tile
+        // has to be redrawn completely.
+        GLfloat shadow_distance = shadow_map_configuration_->
+            getShadowDistance();
+        GLboolean light_moved = !cache.valid || cache.position != light_pos ||
+            cache.shadow_distance != shadow_distance || cache.tile != tile;
+
+        GLint faces_mask = 0;
+        std::array<Frustum, 6> face_frustums;
+        for (GLint face = 0; face < 6; face++)
+        {
+            face_frustums[face].setMatrix(shadow_transforms[face]);
+
+            std::vector<CasterState> face_casters;
+            for (const auto &caster : casters)
+            {
+                if (face_frustums[face].containsSphere(caster.center,
+                    caster.radius))
+                    face_casters.push_back(caster);
+            }
+
+            if (light_moved || face_casters != cache.face_casters[face])
+            {
+                faces_mask |= (1 << face);
+                cache.face_casters[face] = face_casters;
+            }
+        }
+
+        cache.valid = true;
+        cache.position = light_pos;
+        cache.shadow_distance = shadow_distance;
+        cache.tile = tile;
+
+        if (faces_mask == 0)
+            continue;
+
+        // Casters are culled per face, so each one is drawn only to changed
+        // faces it is visible from
+        std::vector<Object3DPtr> objects;
+        std::vector<GLint> objects_faces;
+        for (const auto &caster : casters)
+        {
+            GLint caster_faces = 0;
+            for (GLint face = 0; face < 6; face++)
+            {
+                if ((faces_mask & (1 << face)) && face_frustums[face].
+                    containsSphere(caster.center, caster.radius))
+                    caster_faces |= (1 << face);
+            }
+
+            if (caster_faces == 0)
+                continue;
+
+            objects.push_back(caster.object);
+            objects_faces.push_back(caster_faces);
+        }
+
+        clearPointLightFaces(tile, faces_mask);
+
+        switch (active_point_shadow_render_mode_)
+        {
+        case PointShadowRenderMode::GEOMETRY_SHADER:
+            renderPointLightGeometryShader(tile, light_pos, shadow_transforms,
+                objects, objects_faces);
+            break;
+        case PointShadowRenderMode::VERTEX_VIEWPORT:
+            renderPointLightVertexViewport(tile, light_pos, shadow_transforms,
+                objects, objects_faces);
+            break;
+        default:
+            renderPointLightSingleFace(tile, light_pos, shadow_transforms,
+                objects, objects_faces);
+            break;
+        }
+    }
+
+    point_lights_timer_->end();
+}
+
+GLint ShadowMapRenderer::calculatePointLightTileSize(
+    const glm::vec3 &light_position, const Frustum &camera_frustum) const
+{
+    // Shadows are cast only inside of shadow distance
+    GLfloat radius = shadow_map_configuration_->getShadowDistance();
+    if (!camera_frustum.containsSphere(light_position, radius))
+        return 0;
+
+    // Part of screen height covered by light's shadow sphere
+    GLfloat distance = glm::length(light_position - active_camera_->
+        getPosition());
+    GLfloat coverage = 1.0f;
+    if (distance > radius)
+        coverage = std::min(radius / (distance * std::tan(active_camera_->
+            getFov() * 0.5f)), 1.0f);
+
+    GLint max_size = shadow_map_configuration_->getShadowMapSizePointLight();
+    GLint min_size = std::min(shadow_map_configuration_->
+        getShadowMapMinSizePointLight(), max_size);
+
+    GLint size = min_size;
+    while (size * 2 <= max_size * coverage)
+        size *= 2;
+
+    return size;
+}
+
+std::vector<ShadowMapRenderer::PointLightTile>
+    ShadowMapRenderer::packPointLightTiles(std::vector<GLint> tile_sizes,
+    GLint atlas_size) const
+{
+    std::vector<PointLightTile> tiles(tile_sizes.size());
+
+    // Lights are packed starting from the biggest, so shelves are filled
+    // without gaps
+    std::vector<GLuint> order(tile_sizes.size());
+    for (GLuint i = 0; i < order.size(); i++)
+        order[i] = i;
+
+    std::stable_sort(order.begin(), order.end(),
+        [&tile_sizes](GLuint a, GLuint b)
+    {
+        return tile_sizes[a] > tile_sizes[b];
+    });
+
+    GLint min_size = shadow_map_configuration_->
+        getShadowMapMinSizePointLight();
+
+    while (true)
+    {
+        GLint shelf_x = 0;
+        GLint shelf_y = 0;
+        GLint shelf_height = 0;
+        GLboolean packed = true;
+
+        for (const auto &index : order)
+        {
+            GLint size = tile_sizes[index];
+            tiles[index] = PointLightTile();
+
+            if (size == 0)
+                continue;
+
+            // Light's six faces are placed in 3x2 block
+            if (shelf_x + 3 * size > atlas_size)
+            {
+                shelf_x = 0;
+                shelf_y += shelf_height;
+                shelf_height = 0;
+            }
+
+            if (3 * size > atlas_size || shelf_y + 2 * size > atlas_size)
+            {
+                packed = false;
+                break;
+            }
+
+            tiles[index].x = shelf_x;
+            tiles[index].y = shelf_y;
+            tiles[index].size = size;
+
+            shelf_x += 3 * size;
+            shelf_height = std::max(shelf_height, 2 * size);
+        }
+
+        if (packed)
+            return tiles;
+
+        // Atlas is full - all tiles are halved. Lights which cannot shrink
+        // anymore lose shadows starting from the smallest one.
+        GLboolean shrunk = false;
+        for (auto &size : tile_sizes)
+        {
+            if (size / 2 >= min_size)
+            {
+                size /= 2;
+                shrunk = true;
+            }
+        }
+
+        if (shrunk)
+            continue;
+
+        for (auto it = order.rbegin(); it != order.rend(); it++)
+        {
+            if (tile_sizes[*it] != 0)
+            {
+                tile_sizes[*it] = 0;
+                break;
+            }
+        }
+    }
+}
+
+glm::ivec2 ShadowMapRenderer::getPointLightFaceOrigin(
+    const PointLightTile &tile, GLint face) const
+{
+    return glm::ivec2(tile.x + (face % 3) * tile.size,
+        tile.y + (face / 3) * tile.size);
+}
+
+void ShadowMapRenderer::resolvePointShadowRenderMode()
+{
+    auto mode = shadow_map_configuration_->getPointShadowRenderMode();
+
+    if (mode == PointShadowRenderMode::AUTOMATIC)
+    {
+        mode = isVertexViewportSupported() ?
+            PointShadowRenderMode::VERTEX_VIEWPORT :
+            PointShadowRenderMode::SINGLE_FACE;
+    }
+
+    GLboolean supported = true;
+    if (mode == PointShadowRenderMode::GEOMETRY_SHADER)
+        supported = isViewportArraySupported();
+    else if (mode == PointShadowRenderMode::VERTEX_VIEWPORT)
+        supported = isVertexViewportSupported();
+
+    if (!supported)
+    {
+        if (active_point_shadow_render_mode_ !=
+            PointShadowRenderMode::SINGLE_FACE)
+            logWarning(name_,
+                "ShadowMapRenderer::resolvePointShadowRenderMode()",
+                "Point light shadows rendering mode is not supported. "
+                "Falling back to single face rendering.");
+
+        mode = PointShadowRenderMode::SINGLE_FACE;
+    }
+
+    if (mode == active_point_shadow_render_mode_)
+        return;
+
+    active_point_shadow_render_mode_ = mode;
+
+    std::string mode_name = "single face";
+    if (mode == PointShadowRenderMode::GEOMETRY_SHADER)
+        mode_name = "geometry shader";
+    else if (mode == PointShadowRenderMode::VERTEX_VIEWPORT)
+        mode_name = "vertex viewport";
+
+    logInfo(name_, "ShadowMapRenderer::resolvePointShadowRenderMode()",
+        "Point light shadows rendering mode: " + mode_name + ".");
+}
+
+GLboolean ShadowMapRenderer::isViewportArraySupported() const
+{
+    return GLEW_ARB_viewport_array;
+}
+
+GLboolean ShadowMapRenderer::isVertexViewportSupported() const
+{
+    return GLEW_ARB_viewport_array && (GLEW_ARB_shader_viewport_layer_array ||
+        GLEW_AMD_vertex_shader_viewport_index);
+}
+
+void ShadowMapRenderer::setPointLightViewports(const PointLightTile &tile)
+{
+    for (GLint face = 0; face < 6; face++)
+    {
+        auto origin = getPointLightFaceOrigin(tile, face);
+        glViewportIndexedf(face, static_cast<GLfloat>(origin.x),
+            static_cast<GLfloat>(origin.y), static_cast<GLfloat>(tile.size),
+            static_cast<GLfloat>(tile.size));
+    }
+
+    // First indexed viewport is the one set by glViewport()
+    state_machine_->invalidateViewport();
+}
+
+void ShadowMapRenderer::renderPointLightGeometryShader(
+    const PointLightTile &tile, const glm::vec3 &light_position,
+    const std::vector<glm::mat4> &shadow_transforms,
+    const std::vector<Object3DPtr> &objects,
+    const std::vector<GLint> &objects_faces)
+{
+    state_machine_->activateShaderProgram(depth_map_point_shader_);
+    setPointLightUniforms(depth_map_point_shader_, light_position);
+
+    for (GLint face = 0; face < 6; face++)
+        master_manager_->shaderManager()->setUniform(depth_map_point_shader_,
+            "shadow_matrices[" + std::to_string(face) + "].mat",
+            shadow_transforms[face]);
+
+    state_machine_->bindFrameBuffer(point_light_frame_buffer_);
+    setPointLightViewports(tile);
+
+    object3d_renderer_->prepareRendering();
+
+    // Geometry shader skips faces the object is not visible from
+    for (GLuint i = 0; i < objects.size(); i++)
+    {
         master_manager_->shaderManager()->setUniform(depth_map_point_shader_,
-            "light_position", pl->getPosition());
+            "faces_mask", objects_faces[i]);
+        object3d_renderer_->renderDepth(objects[i], depth_map_point_shader_);
+    }
+}
+
+void ShadowMapRenderer::renderPointLightVertexViewport(
+    const PointLightTile &tile, const glm::vec3 &light_position,
+    const std::vector<glm::mat4> &shadow_transforms,
+    const std::vector<Object3DPtr> &objects,
+    const std::vector<GLint> &objects_faces)
+{
+    state_machine_->activateShaderProgram(depth_map_point_viewport_shader_);
+    setPointLightUniforms(depth_map_point_viewport_shader_, light_position);
+
+    for (GLint face = 0; face < 6; face++)
+        master_manager_->shaderManager()->setUniform(
+            depth_map_point_viewport_shader_, "shadow_matrices[" +
+            std::to_string(face) + "].mat", shadow_transforms[face]);
+
+    state_machine_->bindFrameBuffer(point_light_frame_buffer_);
+    setPointLightViewports(tile);
+
+    object3d_renderer_->prepareRendering();
+
+    // Every instance of object is drawn to one face selected by vertex
+    // shader
+    for (GLuint i = 0; i < objects.size(); i++)
+    {
+        GLint instances_count = 0;
+        for (GLint face = 0; face < 6; face++)
+        {
+            if (!(objects_faces[i] & (1 << face)))
+                continue;
 
-        for (GLint i = 0; i < 6; i++)
             master_manager_->shaderManager()->setUniform(
-                depth_map_point_shader_, "shadow_matrices[" +
-                std::to_string(i) + "].mat", shadow_transforms[i]);
+                depth_map_point_viewport_shader_, "instance_faces[" +
+                std::to_string(instances_count) + "]", face);
+            instances_count++;
+        }
 
-        state_machine_->bindFrameBuffer(point_light_frame_buffer_container_[i]);
-        auto map_size = shadow_map_configuration_->getShadowMapSizePointLight();
-        glViewport(0, 0, map_size, map_size);
-        glClear(GL_DEPTH_BUFFER_BIT);
+        object3d_renderer_->renderDepth(objects[i],
+            depth_map_point_viewport_shader_, instances_count);
+    }
+}
+
+void ShadowMapRenderer::renderPointLightSingleFace(const PointLightTile &tile,
+    const glm::vec3 &light_position,
+    const std::vector<glm::mat4> &shadow_transforms,
+    const std::vector<Object3DPtr> &objects,
+    const std::vector<GLint> &objects_faces)
+{
+    state_machine_->activateShaderProgram(depth_map_point_face_shader_);
+    setPointLightUniforms(depth_map_point_face_shader_, light_position);
+
+    state_machine_->bindFrameBuffer(point_light_frame_buffer_);
+    object3d_renderer_->prepareRendering();
 
-        object3d_renderer_->render(scene, depth_map_point_shader_);
-        object3d_renderer_->point_light_shadow_maps_.push_back(
-            point_light_frame_buffer_container_[i]->getCubeTextureBuffer());
+    for (GLint face = 0; face < 6; face++)
+    {
+        std::vector<Object3DPtr> face_objects;
+        for (GLuint i = 0; i < objects.size(); i++)
+        {
+            if (objects_faces[i] & (1 << face))
+                face_objects.push_back(objects[i]);
+        }
+
+        if (face_objects.empty())
+            continue;
+
+        auto origin = getPointLightFaceOrigin(tile, face);
+        state_machine_->setViewport(origin.x, origin.y, tile.size,
+            tile.size);
+
+        master_manager_->shaderManager()->setUniform(
+            depth_map_point_face_shader_, "face_matrix",
+            shadow_transforms[face]);
+
+        for (const auto &object : face_objects)
+            object3d_renderer_->renderDepth(object,
+                depth_map_point_face_shader_);
+    }
+}
+
+void ShadowMapRenderer::setPointLightUniforms(ShaderProgramPtr shader_program,
+    const glm::vec3 &light_position)
+{
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "light_position", light_position);
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "shadow_distance", shadow_map_configuration_->getShadowDistance());
+}
+
+void ShadowMapRenderer::clearPointLightFaces(const PointLightTile &tile,
+    GLint faces_mask)
+{
+    state_machine_->bindFrameBuffer(point_light_frame_buffer_);
+
+    // Scissor keeps tiles of other lights untouched
+    glEnable(GL_SCISSOR_TEST);
+
+    if (faces_mask == 0x3F)
+    {
+        glScissor(tile.x, tile.y, 3 * tile.size, 2 * tile.size);
+        glClear(GL_DEPTH_BUFFER_BIT);
     }
+    else
+    {
+        for (GLint face = 0; face < 6; face++)
+        {
+            if (!(faces_mask & (1 << face)))
+                continue;
+
+            auto origin = getPointLightFaceOrigin(tile, face);
+            glScissor(origin.x, origin.y, tile.size, tile.size);
+            glClear(GL_DEPTH_BUFFER_BIT);
+        }
+    }
+
+    glDisable(GL_SCISSOR_TEST);
 }
\ No newline at end of file
@@ -42,8 +42,8 @@ SkyboxRenderer::~SkyboxRenderer()
 void SkyboxRenderer::loadShaders()
 {
     shader_program_ = master_manager_->shaderManager()->
-        createShaderProgram("skybox_shader_program", "shaders/SkyboxVS.glsl",
-            "shaders/SkyboxFS.glsl");
+        createShaderProgramAsync("skybox_shader_program",
+            "shaders/SkyboxVS.glsl", "shaders/SkyboxFS.glsl");
 }
 
 void SkyboxRenderer::render(ScenePtr scene)
@@ -92,7 +92,7 @@ void SkyboxRenderer::setShaderUniforms(SkyboxPtr skybox) const
         "color.cube_texture", static_cast<GLint>(0));
     master_manager_->shaderManager()->setUniform(shader_program_,
         "color.light_color", master_manager_->lightManager()->
-        directionalLight()->getColor());
+        renderDirectionalLight()->getColor());
 
     // Fog parameters
     master_manager_->shaderManager()->setUniform(shader_program_,
@@ -9,9 +9,9 @@ using namespace puffin;
 
 WaterRenderer::WaterRenderer(MasterManagerPtr master_manager,
     StateMachinePtr state_machine,
-    DisplayConfigurationPtr display_configuration, FogPtr fog, 
-    FpsCounterPtr fps_counter, Object3DRendererPtr model3d_renderer, 
-    SkyboxRendererPtr skybox_renderer) : BaseRenderer("core_water_renderer")
+    DisplayConfigurationPtr display_configuration, FogPtr fog,
+    Object3DRendererPtr model3d_renderer, SkyboxRendererPtr skybox_renderer) :
+    BaseRenderer("core_water_renderer")
 {
     if (!master_manager)
         logErrorAndThrow(name_, "WaterRenderer::WaterRenderer()",
@@ -25,10 +25,6 @@ WaterRenderer::WaterRenderer(MasterManagerPtr master_manager,
         logErrorAndThrow(name_, "WaterRenderer::WaterRenderer()",
             "Object [DisplayConfiguration] pointer not set.");
 
-    if (!fps_counter)
-        logErrorAndThrow(name_, "WaterRenderer::WaterRenderer()",
-            "Object [FpsCounter] pointer not set.");
-
     if (!fog)
         logErrorAndThrow(name_, "WaterRenderer::WaterRenderer()",
             "Object [Fog] pointer not set.");
@@ -44,7 +40,6 @@ WaterRenderer::WaterRenderer(MasterManagerPtr master_manager,
     master_manager_ = master_manager;
     state_machine_ = state_machine;
     display_configuration_ = display_configuration;
-    fps_counter_ = fps_counter;
     fog_ = fog;
     model3d_renderer_ = model3d_renderer;
     skybox_renderer_ = skybox_renderer;
@@ -64,29 +59,34 @@ WaterRenderer::~WaterRenderer()
 void WaterRenderer::loadShaders()
 {
     shader_program_ = master_manager_->shaderManager()->
-        createShaderProgram("water_shader_program", "shaders/WaterVs.glsl",
-            "shaders/WaterFs.glsl");
+        createShaderProgramAsync("water_shader_program",
+            "shaders/WaterVs.glsl", "shaders/WaterFs.glsl");
 }
 
-void WaterRenderer::createFrameBuffers()
+WaterRenderer::WaterFrameBuffers WaterRenderer::createFrameBuffers(
+    GLuint index)
 {
-    reflection_frame_buffer_ = master_manager_->frameBufferManager()->
-        createFrameBuffer("reflection_frame_buffer");
+    WaterFrameBuffers frame_buffers;
+
+    frame_buffers.reflection = master_manager_->frameBufferManager()->
+        createFrameBuffer("reflection_frame_buffer_" + std::to_string(index));
     master_manager_->frameBufferManager()->addTextureBuffer(
-        reflection_frame_buffer_, TextureBufferType::RGB_BUFFER,
+        frame_buffers.reflection, TextureBufferType::RGB_BUFFER,
         reflection_width_, reflection_height_, false);
     master_manager_->frameBufferManager()->addRenderBuffer(
-        reflection_frame_buffer_, RenderBufferType::DEPTH_STENCIL_BUFFER,
+        frame_buffers.reflection, RenderBufferType::DEPTH_STENCIL_BUFFER,
         reflection_width_, reflection_height_, false);
 
-    refraction_frame_buffer_ = master_manager_->frameBufferManager()->
-        createFrameBuffer("refraction_frame_buffer");
+    frame_buffers.refraction = master_manager_->frameBufferManager()->
+        createFrameBuffer("refraction_frame_buffer_" + std::to_string(index));
     master_manager_->frameBufferManager()->addTextureBuffer(
-        refraction_frame_buffer_, TextureBufferType::RGB_BUFFER,
+        frame_buffers.refraction, TextureBufferType::RGB_BUFFER,
         refraction_width_, refraction_height_, false);
     master_manager_->frameBufferManager()->addTextureBuffer(
-        refraction_frame_buffer_, TextureBufferType::DEPTH_BUFFER,
+        frame_buffers.refraction, TextureBufferType::DEPTH_BUFFER,
         refraction_width_, refraction_height_, false);
+
+    return frame_buffers;
 }
 
 void WaterRenderer::setReflectionResolution(GLint width, GLint height)
@@ -95,7 +95,7 @@ void WaterRenderer::setReflectionResolution(GLint width, GLint height)
         logErrorAndThrow(name_, "WaterRenderer::setReflectionResolution()",
             "Reflection resolution value out of range: {0 < VALUE}.");
 
-    if (reflection_frame_buffer_)
+    if (!frame_buffers_.empty())
     {
         logWarning(name_, "WaterRenderer::setReflectionResolution()",
             "Cannot change reflection resolution during rendering.");
@@ -112,7 +112,7 @@ void WaterRenderer::setRefractionResolution(GLint width, GLint height)
         logErrorAndThrow(name_, "WaterRenderer::setRefractionResolution()",
             "Refraction resolution value out of range: {0 < VALUE}.");
 
-    if (refraction_frame_buffer_)
+    if (!frame_buffers_.empty())
     {
         logWarning(name_, "WaterRenderer::setRefractionResolution()",
             "Cannot change refraction resolution during rendering.");
@@ -123,8 +123,37 @@ void WaterRenderer::setRefractionResolution(GLint width, GLint height)
     refraction_height_ = height;
 }
 
+void WaterRenderer::setReflectionUpdateInterval(GLint frames)
+{
+    if (frames < 1)
+        logErrorAndThrow(name_, "WaterRenderer::setReflectionUpdateInterval()",
+            "Update interval value out of range: {1 <= VALUE}.");
+
+    reflection_update_interval_ = frames;
+}
+
+void WaterRenderer::setRefractionUpdateInterval(GLint frames)
+{
+    if (frames < 1)
+        logErrorAndThrow(name_, "WaterRenderer::setRefractionUpdateInterval()",
+            "Update interval value out of range: {1 <= VALUE}.");
+
+    refraction_update_interval_ = frames;
+}
+
+void WaterRenderer::setReflectionLodBias(GLfloat bias)
+{
+    if (bias < 0.0f)
+        logErrorAndThrow(name_, "WaterRenderer::setReflectionLodBias()",
+            "LOD bias value out of range: {0.0 <= VALUE}.");
+
+    reflection_lod_bias_ = bias;
+}
+
 void WaterRenderer::renderToFrameBuffers(ScenePtr scene)
 {
+    water_groups_.clear();
+
     if (!scene)
         return;
 
@@ -132,150 +161,300 @@ void WaterRenderer::renderToFrameBuffers(ScenePtr scene)
     if (water_tiles.empty())
         return;
 
-    if (!reflection_frame_buffer_ && !refraction_frame_buffer_)
-        createFrameBuffers();
+    // Reflection and refraction are rendered only for water levels with at
+    // least one visible tile
+    groupWaterTiles(water_tiles);
+    if (water_groups_.empty())
+        return;
 
     state_machine_->depthTest()->enableDepthMask(true);
     state_machine_->depthTest()->enable(true);
     state_machine_->alphaBlend()->enable(false);
     state_machine_->faceCulling()->enable(true);
 
-    // TODO: Render all water tiles - common framebuffer for each tile
-    auto tile = water_tiles[0];
-    renderReflectionTexture(tile, scene);
-    renderRefractionTexture(tile, scene);
+    for (GLuint i = 0; i < water_groups_.size(); i++)
+    {
+        if (i >= frame_buffers_.size())
+            frame_buffers_.push_back(createFrameBuffers(i));
+
+        auto &frame_buffers = frame_buffers_[i];
+        auto water_level = water_groups_[i].water_level;
+
+        // Textures of other water level cannot be reused
+        if (!frame_buffers.valid || std::abs(frame_buffers.water_level -
+            water_level) >= water_level_epsilon_)
+        {
+            frame_buffers.valid = true;
+            frame_buffers.water_level = water_level;
+            frame_buffers.reflection_age = reflection_update_interval_;
+            frame_buffers.refraction_age = refraction_update_interval_;
+        }
+
+        if (frame_buffers.reflection_age >= reflection_update_interval_)
+        {
+            renderReflectionTexture(water_level, frame_buffers, scene);
+            frame_buffers.reflection_age = 0;
+        }
+
+        if (frame_buffers.refraction_age >= refraction_update_interval_)
+        {
+            renderRefractionTexture(water_level, frame_buffers, scene);
+            frame_buffers.refraction_age = 0;
+        }
+
+        frame_buffers.reflection_age++;
+        frame_buffers.refraction_age++;
+    }
+}
+
+void WaterRenderer::groupWaterTiles(
+    const std::vector<WaterTilePtr> &water_tiles)
+{
+    Frustum camera_frustum(active_camera_->getProjectionMatrix() *
+        active_camera_->getViewMatrix());
+
+    for (const auto &tile : water_tiles)
+    {
+        if (!camera_frustum.containsSphere(tile->getBoundingSphereCenter(),
+            tile->getBoundingSphereRadius()))
+            continue;
+
+        auto water_level = tile->getPosition().y;
+        auto group = std::find_if(water_groups_.begin(), water_groups_.end(),
+            [water_level](const WaterGroup &water_group)
+        {
+            return std::abs(water_group.water_level - water_level) <
+                water_level_epsilon_;
+        });
+
+        if (group != water_groups_.end())
+        {
+            group->visible_tiles.push_back(tile);
+            continue;
+        }
+
+        WaterGroup new_group;
+        new_group.water_level = water_level;
+        new_group.visible_tiles.push_back(tile);
+        water_groups_.push_back(new_group);
+    }
 }
 
 void WaterRenderer::clearFrameBuffer(GLint width, GLint height) const
 {
-    glViewport(0, 0, width, height);
+    state_machine_->setViewport(0, 0, width, height);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
-void WaterRenderer::renderReflectionTexture(WaterTilePtr water_tile,
-    ScenePtr scene)
+void WaterRenderer::renderReflectionTexture(GLfloat water_level,
+    WaterFrameBuffers &frame_buffers, ScenePtr scene)
 {
-    auto water_level = water_tile->getPosition().y;
-
-    // Setup camera position and orientation for rendering reflection
-    auto camera_pos = active_camera_->getPosition();
+    // Setup camera position and orientation for rendering reflection.
+    // Whole camera is restored afterwards, so its blending is not reset.
+    Camera camera_state = *active_camera_;
+    auto camera_pos = active_camera_->getRenderPosition();
     GLfloat offset = 2.0f * (camera_pos.y - water_level);
 
     glm::vec3 new_camera_pos(camera_pos.x, camera_pos.y - offset, camera_pos.z);
     active_camera_->setPosition(new_camera_pos);
     active_camera_->flipPitch();
 
+    frame_buffers.reflection_matrix = active_camera_->getProjectionMatrix() *
+        active_camera_->getViewMatrix();
+
     // Render reflection
-    state_machine_->bindFrameBuffer(reflection_frame_buffer_);
+    state_machine_->bindFrameBuffer(frame_buffers.reflection);
     clearFrameBuffer(reflection_width_, reflection_height_);
     glEnable(GL_CLIP_DISTANCE0);
 
     // Set clipping plane. Add small offset to water level, because when
     // DUDV map is utlised no offset causes glitches on water edges.
     // Too big value may cause wrong objects to reflect in water.
-    model3d_renderer_->setClippingDistance(glm::vec4(0.0f, 1.0f, 0.0f,
-        -water_level + 0.02f));
+    glm::vec4 clip_plane(0.0f, 1.0f, 0.0f, -water_level + 0.02f);
+    model3d_renderer_->setClippingDistance(clip_plane);
 
     skybox_renderer_->render(scene);
 
     state_machine_->depthTest()->enableDepthMask(true);
-    model3d_renderer_->render(scene);
+    model3d_renderer_->setTextureLodBias(reflection_lod_bias_);
+    model3d_renderer_->render(scene, getClippedObjects(scene, clip_plane));
+    model3d_renderer_->setTextureLodBias(0.0f);
 
     glDisable(GL_CLIP_DISTANCE0);
 
     // Restore previous camera position and orientation
-    active_camera_->setPosition(camera_pos);
-    active_camera_->flipPitch();
+    *active_camera_ = camera_state;
 }
 
-void WaterRenderer::renderRefractionTexture(WaterTilePtr water_tile,
-    ScenePtr scene)
+void WaterRenderer::renderRefractionTexture(GLfloat water_level,
+    WaterFrameBuffers &frame_buffers, ScenePtr scene)
 {
-    auto water_level = water_tile->getPosition().y;
+    frame_buffers.refraction_matrix = active_camera_->getProjectionMatrix() *
+        active_camera_->getViewMatrix();
 
-    state_machine_->bindFrameBuffer(refraction_frame_buffer_);
+    state_machine_->bindFrameBuffer(frame_buffers.refraction);
     clearFrameBuffer(refraction_width_, refraction_height_);
 
     glEnable(GL_CLIP_DISTANCE0);
-    model3d_renderer_->setClippingDistance(glm::vec4(0.0f, -1.0f, 0.0f,
-        water_level));
+    glm::vec4 clip_plane(0.0f, -1.0f, 0.0f, water_level);
+    model3d_renderer_->setClippingDistance(clip_plane);
 
     skybox_renderer_->render(scene);
 
     state_machine_->depthTest()->enableDepthMask(true);
-    model3d_renderer_->render(scene);
+    model3d_renderer_->render(scene, getClippedObjects(scene, clip_plane));
 
     glDisable(GL_CLIP_DISTANCE0);
 }
 
-void WaterRenderer::setCameraMatricesUniforms(ShaderProgramPtr shader_program,
-    WaterTilePtr water_tile)
+std::vector<Object3DPtr> WaterRenderer::getClippedObjects(ScenePtr scene,
+    const glm::vec4 &clip_plane) const
 {
-    master_manager_->shaderManager()->setUniform(shader_program_,
+    // Objects placed entirely on the clipped side of water or outside of
+    // frustum of the camera used for this pass are skipped
+    Frustum camera_frustum(active_camera_->getProjectionMatrix() *
+        active_camera_->getViewMatrix());
+
+    std::vector<Object3DPtr> objects;
+    for (const auto &object : scene->getObject3DContainer())
+    {
+        auto center = object->getRenderBoundingSphereCenter();
+        auto radius = object->getRenderBoundingSphereRadius();
+
+        if (glm::dot(glm::vec3(clip_plane), center) + clip_plane.w < -radius)
+            continue;
+
+        if (!camera_frustum.containsSphere(center, radius))
+            continue;
+
+        objects.push_back(object);
+    }
+
+    return objects;
+}
+
+void WaterRenderer::setCameraMatricesUniforms(ShaderProgramPtr shader_program)
+{
+    master_manager_->shaderManager()->setUniform(shader_program,
         "matrices.view_matrix", active_camera_->getViewMatrix());
-    master_manager_->shaderManager()->setUniform(shader_program_,
+    master_manager_->shaderManager()->setUniform(shader_program,
         "matrices.projection_matrix", active_camera_->getProjectionMatrix());
-    master_manager_->shaderManager()->setUniform(shader_program_,
-        "matrices.model_matrix", water_tile->getModelMatrix());
 
-    master_manager_->shaderManager()->setUniform(shader_program_,
-        "camera_position", active_camera_->getPosition());
-    master_manager_->shaderManager()->setUniform(shader_program_,
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "camera_position", active_camera_->getRenderPosition());
+    master_manager_->shaderManager()->setUniform(shader_program,
         "clip_near", active_camera_->getNearPlane());
-    master_manager_->shaderManager()->setUniform(shader_program_,
+    master_manager_->shaderManager()->setUniform(shader_program,
         "clip_far", active_camera_->getFarPlane());
 }
 
-void WaterRenderer::setTextureUniforms(ShaderProgramPtr shader_program,
-    WaterTilePtr water_tile)
+void WaterRenderer::setTextureUniforms(ShaderProgramPtr shader_program)
 {
-    constexpr GLint reflection_texture_slot = 0;
-    constexpr GLint refraction_texture_slot = 1;
-    constexpr GLint dudv_texture_slot = 2;
-    constexpr GLint normal_map_texture_slot = 3;
-    constexpr GLint depth_map_texture_slot = 4;
-
-    master_manager_->shaderManager()->setUniform(shader_program_,
-        "reflection_texture", reflection_texture_slot);
-    master_manager_->shaderManager()->setUniform(shader_program_,
-        "refraction_texture", refraction_texture_slot);
-    master_manager_->shaderManager()->setUniform(shader_program_,
-        "dudv_map", dudv_texture_slot);
-    master_manager_->shaderManager()->setUniform(shader_program_, "normal_map",
-        normal_map_texture_slot);
-    master_manager_->shaderManager()->setUniform(shader_program_, "depth_map",
-        depth_map_texture_slot);
-
-    master_manager_->textureManager()->setTextureSlot(reflection_texture_slot);
-    state_machine_->bindTexture(reflection_frame_buffer_->getRgbTextureBuffer());
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "reflection_texture", reflection_texture_slot_);
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "refraction_texture", refraction_texture_slot_);
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "dudv_map", dudv_texture_slot_);
+    master_manager_->shaderManager()->setUniform(shader_program, "normal_map",
+        normal_map_texture_slot_);
+    master_manager_->shaderManager()->setUniform(shader_program, "depth_map",
+        depth_map_texture_slot_);
+}
 
-    master_manager_->textureManager()->setTextureSlot(refraction_texture_slot);
-    state_machine_->bindTexture(refraction_frame_buffer_->getRgbTextureBuffer());
+void WaterRenderer::setFrameBufferUniforms(ShaderProgramPtr shader_program,
+    const WaterFrameBuffers &frame_buffers)
+{
+    // Textures may come from previous frames, so they are sampled using
+    // matrices they were rendered with
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "reflection_matrix", frame_buffers.reflection_matrix);
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "refraction_matrix", frame_buffers.refraction_matrix);
+
+    master_manager_->textureManager()->setTextureSlot(
+        reflection_texture_slot_);
+    state_machine_->bindTexture(frame_buffers.reflection->
+        getRgbTextureBuffer());
+
+    master_manager_->textureManager()->setTextureSlot(
+        refraction_texture_slot_);
+    state_machine_->bindTexture(frame_buffers.refraction->
+        getRgbTextureBuffer());
+
+    master_manager_->textureManager()->setTextureSlot(depth_map_texture_slot_);
+    state_machine_->bindTexture(frame_buffers.refraction->
+        getDepthTextureBuffer());
+}
 
-    master_manager_->textureManager()->setTextureSlot(dudv_texture_slot);
+void WaterRenderer::bindWaterTileTextures(WaterTilePtr water_tile)
+{
+    master_manager_->textureManager()->setTextureSlot(dudv_texture_slot_);
     state_machine_->bindTexture(water_tile->dudv_texture_);
 
-    master_manager_->textureManager()->setTextureSlot(normal_map_texture_slot);
+    master_manager_->textureManager()->setTextureSlot(
+        normal_map_texture_slot_);
     state_machine_->bindTexture(water_tile->normal_map_texture_);
-
-    master_manager_->textureManager()->setTextureSlot(depth_map_texture_slot);
-    state_machine_->bindTexture(refraction_frame_buffer_->
-        getDepthTextureBuffer());
 }
 
 void WaterRenderer::setWaterTileUniforms(ShaderProgramPtr shader_program,
     WaterTilePtr water_tile)
 {
-    master_manager_->shaderManager()->setUniform(shader_program_,
+    master_manager_->shaderManager()->setUniform(shader_program,
         "texture_tiling", water_tile->getTextureTiling());
-    master_manager_->shaderManager()->setUniform(shader_program_,
+    master_manager_->shaderManager()->setUniform(shader_program,
         "shininess", water_tile->getShininess());
-    master_manager_->shaderManager()->setUniform(shader_program_,
+    master_manager_->shaderManager()->setUniform(shader_program,
         "water_color", water_tile->getWaterColor());
-    master_manager_->shaderManager()->setUniform(shader_program_,
+    master_manager_->shaderManager()->setUniform(shader_program,
         "wave_strenght", water_tile->getWaveStrength());
 }
 
+void WaterRenderer::setInstancesUniforms(ShaderProgramPtr shader_program,
+    const std::vector<WaterTilePtr> &water_tiles)
+{
+    for (GLuint i = 0; i < water_tiles.size(); i++)
+    {
+        std::string index = "[" + std::to_string(i) + "]";
+
+        master_manager_->shaderManager()->setUniform(shader_program,
+            "model_matrices" + index, water_tiles[i]->getModelMatrix());
+        master_manager_->shaderManager()->setUniform(shader_program,
+            "move_factors" + index, water_tiles[i]->move_factor_);
+    }
+}
+
+GLboolean WaterRenderer::canBatchTiles(WaterTilePtr first,
+    WaterTilePtr second) const
+{
+    return first->dudv_texture_ == second->dudv_texture_ &&
+        first->normal_map_texture_ == second->normal_map_texture_ &&
+        first->getWaterColor() == second->getWaterColor() &&
+        first->getWaveStrength() == second->getWaveStrength() &&
+        first->getShininess() == second->getShininess() &&
+        first->getTextureTiling() == second->getTextureTiling();
+}
+
+void WaterRenderer::update(ScenePtr scene, GLdouble delta)
+{
+    updateMoveFactors(scene->getWaterTileContainer(), delta);
+}
+
+void WaterRenderer::updateMoveFactors(
+    const std::vector<WaterTilePtr> &water_tiles, GLdouble delta)
+{
+    // Tiles outside of view are animated too, so waves do not jump when
+    // tile becomes visible again
+    for (const auto &tile : water_tiles)
+    {
+        tile->move_factor_ += tile->getWaveSpeed() *
+            static_cast<GLfloat>(delta);
+
+        if (tile->move_factor_ >= 1.0f)
+            tile->move_factor_ = 0.0f;
+    }
+}
+
 void WaterRenderer::render(ScenePtr scene)
 {
     if (!scene)
@@ -285,6 +464,9 @@ void WaterRenderer::render(ScenePtr scene)
     if (water_tiles.empty())
         return;
 
+    if (water_groups_.empty())
+        return;
+
     state_machine_->depthTest()->enableDepthMask(true);
     state_machine_->depthTest()->enable(true);
     state_machine_->alphaBlend()->enable(false);
@@ -292,26 +474,49 @@ void WaterRenderer::render(ScenePtr scene)
 
     state_machine_->activateShaderProgram(shader_program_);
 
-    // TODO: Render all water tiles - common framebuffer for each tile
-    auto water_tile = water_tiles[0];
+    // Uniforms shared by all tiles are set once per frame
+    setTextureUniforms(shader_program_);
+    setCameraMatricesUniforms(shader_program_);
+    setFogUniforms(shader_program_);
+    setLightingUniforms(shader_program_);
 
-    master_manager_->shaderManager()->setUniform(shader_program_, "move_factor",
-        water_tile->move_factor_);
-    water_tile->move_factor_ += (water_tile->getWaveSpeed() *
-        fps_counter_->getDelta());
+    for (GLuint i = 0; i < water_groups_.size(); i++)
+        renderWaterGroup(water_groups_[i], frame_buffers_[i]);
+}
 
-    if (water_tile->move_factor_ >= 1.0f)
-        water_tile->move_factor_ = 0.0f;
+void WaterRenderer::renderWaterGroup(const WaterGroup &group,
+    const WaterFrameBuffers &frame_buffers)
+{
+    setFrameBufferUniforms(shader_program_, frame_buffers);
 
-    setTextureUniforms(shader_program_, water_tile);
-    setCameraMatricesUniforms(shader_program_, water_tile);
-    setWaterTileUniforms(shader_program_, water_tile);
-    setFogUniforms(shader_program_);
+    // Tiles with the same look are drawn with single instanced call
+    std::vector<std::vector<WaterTilePtr>> batches;
+    for (const auto &tile : group.visible_tiles)
+    {
+        auto batch = std::find_if(batches.begin(), batches.end(),
+            [this, &tile](const std::vector<WaterTilePtr> &batch_tiles)
+        {
+            return batch_tiles.size() < max_instances_count_ &&
+                canBatchTiles(batch_tiles.front(), tile);
+        });
+
+        if (batch != batches.end())
+            batch->push_back(tile);
+        else
+            batches.push_back(std::vector<WaterTilePtr>{tile});
+    }
 
-    setLightingUniforms(shader_program_);
+    for (const auto &batch_tiles : batches)
+    {
+        auto first_tile = batch_tiles.front();
 
-    state_machine_->bindMesh(water_tile);
-    water_tile->draw();
+        bindWaterTileTextures(first_tile);
+        setWaterTileUniforms(shader_program_, first_tile);
+        setInstancesUniforms(shader_program_, batch_tiles);
+
+        state_machine_->bindMesh(first_tile);
+        first_tile->drawInstanced(static_cast<GLint>(batch_tiles.size()));
+    }
 }
 
 void WaterRenderer::setFogUniforms(ShaderProgramPtr shader_program)
@@ -331,45 +536,57 @@ void WaterRenderer::setFogUniforms(ShaderProgramPtr shader_program)
 void WaterRenderer::setLightingUniforms(ShaderProgramPtr shader_program)
 {
     auto light_manager = master_manager_->lightManager();
+    auto dir_light = light_manager->renderDirectionalLight();
     master_manager_->shaderManager()->setUniform(shader_program_,
-        "directional_light.enabled", light_manager->isLightingEnabled() &&
-        light_manager->directionalLight()->isEnabled());
+        "directional_light.enabled", light_manager->
+        isRenderLightingEnabled() && dir_light->isEnabled());
 
-    if (light_manager->directionalLight()->isEnabled())
+    if (dir_light->isEnabled())
     {
         master_manager_->shaderManager()->setUniform(shader_program_,
-            "directional_light.direction", light_manager->directionalLight()->
-            getDirection());
+            "directional_light.direction", dir_light->getDirection());
         master_manager_->shaderManager()->setUniform(shader_program_,
-            "directional_light.color", light_manager->
-            directionalLight()->getColor());
+            "directional_light.color", dir_light->getColor());
     }
 
-    // Point lights
-    if (light_manager->getPointLightsCount())
+    // Water uses only lights nearest to camera
+    std::vector<PointLightPtr> point_lights;
+    for (const auto &p_light : light_manager->getRenderPointLightContainer())
     {
-        master_manager_->shaderManager()->setUniform(shader_program,
-            "used_point_lights_count", static_cast<GLint>(light_manager->
-                getPointLightsCount()));
+        if (p_light->isEnabled())
+            point_lights.push_back(p_light);
+    }
 
-        for (GLuint i = 0; i < light_manager->getPointLightsCount(); i++)
-        {
-            std::string uniform_name = "point_lights[" + std::to_string(i)
-                + "]";
-            auto p_light = light_manager->getPointLight(i);
-
-            master_manager_->shaderManager()->setUniform(shader_program,
-                uniform_name + ".enabled", p_light->isEnabled());
-            master_manager_->shaderManager()->setUniform(shader_program,
-                uniform_name + ".linear_factor", p_light->
-                getLinearAttenuationFactor());
-            master_manager_->shaderManager()->setUniform(shader_program,
-                uniform_name + ".quadratic_factor", p_light->
-                getQuadraticAttenuationFactor());
-            master_manager_->shaderManager()->setUniform(shader_program,
-                uniform_name + ".position", p_light->getPosition());
-            master_manager_->shaderManager()->setUniform(shader_program,
-                uniform_name + ".color", p_light->getColor());
-        }
+    auto camera_position = active_camera_->getRenderPosition();
+    GLuint used_count = std::min(static_cast<GLuint>(point_lights.size()),
+        max_point_lights_count_);
+    std::partial_sort(point_lights.begin(), point_lights.begin() + used_count,
+        point_lights.end(), [&camera_position](const PointLightPtr &a,
+        const PointLightPtr &b)
+    {
+        return glm::length(a->getPosition() - camera_position) <
+            glm::length(b->getPosition() - camera_position);
+    });
+
+    master_manager_->shaderManager()->setUniform(shader_program,
+        "used_point_lights_count", static_cast<GLint>(used_count));
+
+    for (GLuint i = 0; i < used_count; i++)
+    {
+        std::string uniform_name = "point_lights[" + std::to_string(i) + "]";
+        auto p_light = point_lights[i];
+
+        master_manager_->shaderManager()->setUniform(shader_program,
+            uniform_name + ".enabled", p_light->isEnabled());
+        master_manager_->shaderManager()->setUniform(shader_program,
+            uniform_name + ".linear_factor", p_light->
+            getLinearAttenuationFactor());
+        master_manager_->shaderManager()->setUniform(shader_program,
+            uniform_name + ".quadratic_factor", p_light->
+            getQuadraticAttenuationFactor());
+        master_manager_->shaderManager()->setUniform(shader_program,
+            uniform_name + ".position", p_light->getPosition());
+        master_manager_->shaderManager()->setUniform(shader_program,
+            uniform_name + ".color", p_light->getColor());
     }
 }
\ No newline at end of file
@@ -88,5 +88,24 @@ void ShaderProgram::fetchUniforms()
 
         GLint location = glGetUniformLocation(handle_, uniform_name.c_str());
         uniforms_[uniform_name] = location;
+
+        // Arrays of basic types are reported only by their first element,
+        // so locations of the remaining elements have to be fetched here
+        const std::string first_element = "[0]";
+        if (values[2] > 1 && uniform_name.size() > first_element.size() &&
+            uniform_name.compare(uniform_name.size() - first_element.size(),
+            first_element.size(), first_element) == 0)
+        {
+            std::string base_name = uniform_name.substr(0,
+                uniform_name.size() - first_element.size());
+
+            for (GLint j = 1; j < values[2]; j++)
+            {
+                std::string element_name = base_name + "[" +
+                    std::to_string(j) + "]";
+                uniforms_[element_name] = glGetUniformLocation(handle_,
+                    element_name.c_str());
+            }
+        }
     }
 }
\ No newline at end of file
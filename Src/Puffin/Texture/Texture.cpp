@@ -40,5 +40,8 @@ Texture::~Texture()
     if (handle_)
         glDeleteTextures(1, &handle_);
 
+    if (buffer_handle_)
+        glDeleteBuffers(1, &buffer_handle_);
+
     logDebug(name_, "Texture::~Texture()", "Texture destroyed.");
 }
\ No newline at end of file
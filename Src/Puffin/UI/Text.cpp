@@ -30,6 +30,7 @@ void Text::setFontSize(GLint font_size)
             "Font size value out of range: {0 < VALUE}.");
 
     font_size_ = font_size;
+    changeLayout();
 }
 
 void Text::setFont(std::string font)
@@ -42,11 +43,13 @@ void Text::setFont(std::string font)
     }
 
     font_ = font;
+    changeLayout();
 }
 
 void Text::setHorizontalSpacing(GLint spacing)
 {
     horizontal_spacing_ = spacing;
+    changeLayout();
 }
 
 GLint Text::getHorizontalSpacing() const
@@ -57,6 +60,7 @@ GLint Text::getHorizontalSpacing() const
 void Text::setVerticalSpacing(GLint spacing)
 {
     vertical_spacing_ = spacing;
+    changeLayout();
 }
 
 GLint Text::getVerticalSpacing() const